@@ -2,6 +2,7 @@
 #include "TriangleUtils.hpp"
 #include "IncludeGLM.hpp"
 #include "BasicShapes.hpp"
+#include "MeshCompaction.hpp"
 
 #pragma warning (push)
 #pragma warning (disable : 4456)
@@ -63,11 +64,13 @@ static void ConvertMeshToCGALMesh (const Modeler::Mesh& mesh, CGAL_Mesh& cgalMes
 		
 	const Modeler::MeshGeometry& geometry = mesh.GetGeometry ();
 	const glm::dmat4& transformation = mesh.GetTransformation ();
+	const std::vector<Modeler::MeshTriangle>& triangles = geometry.GetTriangles ();
+	cgalMesh.reserve (geometry.VertexCount (), 3 * geometry.TriangleCount () / 2, geometry.TriangleCount ());
 	geometry.EnumerateVertices (transformation, [&] (const glm::dvec3& vertex) {
 		cgalMesh.add_vertex (CGAL_Point (vertex.x, vertex.y, vertex.z));
 	});
 	for (unsigned int triangleIndex = 0; triangleIndex < geometry.TriangleCount (); ++triangleIndex) {
-		const Modeler::MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+		const Modeler::MeshTriangle& triangle = triangles[triangleIndex];
 		CGAL_Mesh::Face_index faceIndex = cgalMesh.add_face (
 			CGAL_Mesh::Vertex_index (triangle.v1),
 			CGAL_Mesh::Vertex_index (triangle.v2),
@@ -130,11 +133,7 @@ static void ConvertCGALMeshToMesh (const CGAL_Mesh& cgalMesh, const CGAL_Mesh::P
 		const glm::dvec3& GetTransformedVertex (const Modeler::Mesh* mesh, unsigned int vertexId)
 		{
 			if (transformedVertexMap.find (mesh) == transformedVertexMap.end ()) {
-				transformedVertexMap.insert ({ mesh, std::vector<glm::dvec3> () });
-				std::vector<glm::dvec3>& vertices = transformedVertexMap.at (mesh);
-				mesh->GetGeometry ().EnumerateVertices (mesh->GetTransformation (), [&] (const glm::dvec3& vertex) {
-					vertices.push_back (vertex);
-				});
+				transformedVertexMap.insert ({ mesh, mesh->GetGeometry ().GetTransformedVertices (mesh->GetTransformation ()) });
 			}
 			return transformedVertexMap.at (mesh)[vertexId];
 		}
@@ -142,11 +141,7 @@ static void ConvertCGALMeshToMesh (const CGAL_Mesh& cgalMesh, const CGAL_Mesh::P
 		const glm::dvec3& GetTransformedNormal (const Modeler::Mesh* mesh, unsigned int normalId)
 		{
 			if (transformedNormalMap.find (mesh) == transformedNormalMap.end ()) {
-				transformedNormalMap.insert ({ mesh, std::vector<glm::dvec3> () });
-				std::vector<glm::dvec3>& normals = transformedNormalMap.at (mesh);
-				mesh->GetGeometry ().EnumerateNormals (mesh->GetTransformation (), [&] (const glm::dvec3& normal) {
-					normals.push_back (normal);
-				});
+				transformedNormalMap.insert ({ mesh, mesh->GetGeometry ().GetTransformedNormals (mesh->GetTransformation ()) });
 			}
 			return transformedNormalMap.at (mesh)[normalId];
 		}
@@ -312,7 +307,7 @@ static Modeler::ShapePtr ShapeBooleanOperation (const Modeler::ShapeConstPtr& aS
 	if (!MeshBooleanOperation (aMesh, bMesh, operation, resultMesh)) {
 		return nullptr;
 	}
-	return std::shared_ptr<Modeler::MeshShape> (new Modeler::MeshShape (glm::dmat4 (1.0), resultMesh));
+	return std::shared_ptr<Modeler::MeshShape> (new Modeler::MeshShape (glm::dmat4 (1.0), std::move (resultMesh)));
 }
 
 bool MeshDifference (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, Modeler::Mesh& resultMesh)
@@ -337,7 +332,7 @@ bool MeshUnion (const std::vector<Modeler::Mesh>& meshes, Modeler::Mesh& resultM
 	}
 	resultMesh = meshes[0];
 	for (size_t i = 1; i < meshes.size (); i++) {
-		Modeler::Mesh aMesh = resultMesh;
+		Modeler::Mesh aMesh = std::move (resultMesh);
 		const Modeler::Mesh& bMesh = meshes[i];
 		resultMesh.Clear ();
 		if (!MeshUnion (aMesh, bMesh, resultMesh)) {
@@ -348,6 +343,36 @@ bool MeshUnion (const std::vector<Modeler::Mesh>& meshes, Modeler::Mesh& resultM
 	return true;
 }
 
+// the converted meshes have normals for every triangle corner, most of them are equal
+static bool CompactResultMesh (bool success, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	if (!success) {
+		return false;
+	}
+	resultMesh = Modeler::CompactMesh (resultMesh, weldTolerance);
+	return true;
+}
+
+bool MeshDifference (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	return CompactResultMesh (MeshDifference (aMesh, bMesh, resultMesh), weldTolerance, resultMesh);
+}
+
+bool MeshIntersection (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	return CompactResultMesh (MeshIntersection (aMesh, bMesh, resultMesh), weldTolerance, resultMesh);
+}
+
+bool MeshUnion (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	return CompactResultMesh (MeshUnion (aMesh, bMesh, resultMesh), weldTolerance, resultMesh);
+}
+
+bool MeshUnion (const std::vector<Modeler::Mesh>& meshes, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	return CompactResultMesh (MeshUnion (meshes, resultMesh), weldTolerance, resultMesh);
+}
+
 Modeler::ShapePtr ShapeDifference (const Modeler::ShapeConstPtr& aShape, const Modeler::ShapeConstPtr& bShape)
 {
 	return ShapeBooleanOperation (aShape, bShape, BooleanOperation::Difference);
@@ -380,7 +405,7 @@ Modeler::ShapePtr ShapeUnion (const std::vector<Modeler::ShapeConstPtr>& shapes)
 	if (!MeshUnion (meshes, resultMesh)) {
 		return nullptr;
 	}
-	return std::shared_ptr<Modeler::MeshShape> (new Modeler::MeshShape (glm::dmat4 (1.0), resultMesh));
+	return std::shared_ptr<Modeler::MeshShape> (new Modeler::MeshShape (glm::dmat4 (1.0), std::move (resultMesh)));
 }
 
 }
@@ -14,6 +14,12 @@ bool					MeshIntersection (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMes
 bool					MeshUnion (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, Modeler::Mesh& resultMesh);
 bool					MeshUnion (const std::vector<Modeler::Mesh>& meshes, Modeler::Mesh& resultMesh);
 
+// these versions weld and compact the result mesh
+bool					MeshDifference (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh);
+bool					MeshIntersection (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh);
+bool					MeshUnion (const Modeler::Mesh& aMesh, const Modeler::Mesh& bMesh, double weldTolerance, Modeler::Mesh& resultMesh);
+bool					MeshUnion (const std::vector<Modeler::Mesh>& meshes, double weldTolerance, Modeler::Mesh& resultMesh);
+
 Modeler::ShapePtr		ShapeDifference (const Modeler::ShapeConstPtr& aShape, const Modeler::ShapeConstPtr& bShape);
 Modeler::ShapePtr		ShapeIntersection (const Modeler::ShapeConstPtr& aShape, const Modeler::ShapeConstPtr& bShape);
 Modeler::ShapePtr		ShapeUnion (const Modeler::ShapeConstPtr& aShape, const Modeler::ShapeConstPtr& bShape);
@@ -2,6 +2,7 @@
 #include "TriangleUtils.hpp"
 #include "IncludeGLM.hpp"
 #include "BasicShapes.hpp"
+#include "MeshCompaction.hpp"
 
 #pragma warning (push)
 #pragma warning (disable : 4456)
@@ -24,11 +25,13 @@ static void ConvertMeshToCGALMesh (const Modeler::Mesh& mesh, CGAL_Mesh& cgalMes
 {
 	const Modeler::MeshGeometry& geometry = mesh.GetGeometry ();
 	const glm::dmat4& transformation = mesh.GetTransformation ();
+	const std::vector<Modeler::MeshTriangle>& triangles = geometry.GetTriangles ();
+	cgalMesh.reserve (geometry.VertexCount (), 3 * geometry.TriangleCount () / 2, geometry.TriangleCount ());
 	geometry.EnumerateVertices (transformation, [&] (const glm::dvec3& vertex) {
 		cgalMesh.add_vertex (CGAL_Point (vertex.x, vertex.y, vertex.z));
 	});
 	for (unsigned int triangleIndex = 0; triangleIndex < geometry.TriangleCount (); ++triangleIndex) {
-		const Modeler::MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+		const Modeler::MeshTriangle& triangle = triangles[triangleIndex];
 		CGAL_Mesh::Face_index faceIndex = cgalMesh.add_face (
 			CGAL_Mesh::Vertex_index (triangle.v1),
 			CGAL_Mesh::Vertex_index (triangle.v2),
@@ -73,6 +76,16 @@ bool MeshSubdivision (const Modeler::Mesh& mesh, const Modeler::Material& materi
 	return success;
 }
 
+bool MeshSubdivision (const Modeler::Mesh& mesh, const Modeler::Material& material, int steps, double weldTolerance, Modeler::Mesh& resultMesh)
+{
+	Modeler::Mesh subdividedMesh;
+	if (!MeshSubdivision (mesh, material, steps, subdividedMesh)) {
+		return false;
+	}
+	resultMesh = Modeler::CompactMesh (subdividedMesh, weldTolerance);
+	return true;
+}
+
 Modeler::ShapePtr MeshSubdivision (const Modeler::ShapeConstPtr& shape, const Modeler::Material& material, int steps)
 {
 	Modeler::Mesh mesh = shape->GenerateMesh ();
@@ -81,7 +94,7 @@ Modeler::ShapePtr MeshSubdivision (const Modeler::ShapeConstPtr& shape, const Mo
 	if (!opResult) {
 		return nullptr;
 	}
-	return Modeler::ShapePtr (new Modeler::MeshShape (glm::dmat4 (1.0), resultMesh));
+	return Modeler::ShapePtr (new Modeler::MeshShape (glm::dmat4 (1.0), std::move (resultMesh)));
 }
 
 }
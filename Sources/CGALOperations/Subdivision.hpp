@@ -8,6 +8,7 @@ namespace CGALOperations
 {
 
 bool					MeshSubdivision (const Modeler::Mesh& mesh, const Modeler::Material& material, int steps, Modeler::Mesh& resultMesh);
+bool					MeshSubdivision (const Modeler::Mesh& mesh, const Modeler::Material& material, int steps, double weldTolerance, Modeler::Mesh& resultMesh);
 Modeler::ShapePtr		MeshSubdivision (const Modeler::ShapeConstPtr& shape, const Modeler::Material& material, int steps);
 
 }
@@ -2,6 +2,7 @@
 #include "Model.hpp"
 #include "MeshGenerators.hpp"
 #include "Export.hpp"
+#include "MeshCompaction.hpp"
 #include "TestUtils.hpp"
 
 using namespace Modeler;
@@ -367,4 +368,35 @@ TEST (Stl_TwoMeshExportTest)
 	ASSERT (CheckString (expected, writer.result));
 }
 
+
+TEST (Off_WeldedExportTest)
+{
+	Mesh mesh;
+	MaterialId material = mesh.AddMaterial (DefaultMaterial);
+	mesh.AddVertex (0.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 1.0, 0.0);
+	mesh.AddVertex (0.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 1.0, 0.0);
+	mesh.AddVertex (0.0, 1.0, 0.0);
+	mesh.AddVertex (9.0, 9.0, 9.0);
+	mesh.AddTriangle (0, 1, 2, material);
+	mesh.AddTriangle (3, 4, 5, material);
+
+	ModelWriterForTest writer;
+	ASSERT (ExportMesh (mesh, FormatId::Off, L"model", writer, DefaultWeldTolerance));
+	std::wstring expected;
+	expected += L"# open file model.off\n";
+	expected += L"OFF\n";
+	expected += L"4 2 0\n";
+	expected += L"0 0 0\n";
+	expected += L"1 0 0\n";
+	expected += L"1 1 0\n";
+	expected += L"0 1 0\n";
+	expected += L"3 0 1 2\n";
+	expected += L"3 0 2 3\n";
+	expected += L"# close file\n";
+	ASSERT (CheckString (expected, writer.result));
+}
+
 }
@@ -0,0 +1,157 @@
+#include "SimpleTest.hpp"
+#include "HalfEdgeMesh.hpp"
+#include "MeshGenerators.hpp"
+#include "Model.hpp"
+
+#include <algorithm>
+
+using namespace Modeler;
+
+namespace HalfEdgeMeshTest
+{
+
+static MeshGeometry CreateGrid (int size)
+{
+	MeshGeometry geometry;
+	for (int i = 0; i <= size; i++) {
+		for (int j = 0; j <= size; j++) {
+			geometry.AddVertex (i, j, 0.0);
+		}
+	}
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < size; j++) {
+			unsigned int v1 = i * (size + 1) + j;
+			unsigned int v2 = v1 + size + 1;
+			geometry.AddTriangle (v1, v2, v2 + 1);
+			geometry.AddTriangle (v1, v2 + 1, v1 + 1);
+		}
+	}
+	return geometry;
+}
+
+static std::vector<unsigned int> GetNeighbours (const HalfEdgeMesh& halfEdgeMesh, unsigned int vertex)
+{
+	std::vector<unsigned int> neighbours;
+	halfEdgeMesh.EnumerateVertexNeighbours (vertex, [&] (unsigned int neighbour) {
+		neighbours.push_back (neighbour);
+	});
+	return neighbours;
+}
+
+TEST (ClosedMeshTest)
+{
+	Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 4, true);
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	HalfEdgeMesh halfEdgeMesh (geometry);
+	ASSERT (halfEdgeMesh.TriangleCount () == geometry.TriangleCount ());
+	ASSERT (halfEdgeMesh.HalfEdgeCount () == geometry.TriangleCount () * 3);
+	ASSERT (halfEdgeMesh.IsEdgeManifold ());
+	ASSERT (halfEdgeMesh.IsManifold ());
+	ASSERT (halfEdgeMesh.IsClosed ());
+
+	for (unsigned int halfEdge = 0; halfEdge < halfEdgeMesh.HalfEdgeCount (); halfEdge++) {
+		unsigned int opposite = halfEdgeMesh.GetOpposite (halfEdge);
+		ASSERT (halfEdgeMesh.GetOpposite (opposite) == halfEdge);
+		ASSERT (halfEdgeMesh.GetOrigin (opposite) == halfEdgeMesh.GetTarget (halfEdge));
+		ASSERT (halfEdgeMesh.GetNext (halfEdgeMesh.GetPrevious (halfEdge)) == halfEdge);
+	}
+
+	unsigned int valenceSum = 0;
+	for (unsigned int vertex = 0; vertex < geometry.VertexCount (); vertex++) {
+		std::vector<unsigned int> neighbours = GetNeighbours (halfEdgeMesh, vertex);
+		ASSERT (neighbours.size () == 5 || neighbours.size () == 6);
+		for (unsigned int neighbour : neighbours) {
+			ASSERT (glm::distance (geometry.GetVertex (vertex), geometry.GetVertex (neighbour)) < 0.4);
+		}
+		valenceSum += (unsigned int) neighbours.size ();
+	}
+	ASSERT (valenceSum == halfEdgeMesh.HalfEdgeCount ());
+
+	unsigned int loopCount = 0;
+	halfEdgeMesh.EnumerateBoundaryLoops ([&] (const std::vector<unsigned int>&) {
+		loopCount++;
+	});
+	ASSERT (loopCount == 0);
+}
+
+TEST (OpenMeshTest)
+{
+	MeshGeometry geometry = CreateGrid (3);
+	HalfEdgeMesh halfEdgeMesh (geometry);
+	ASSERT (halfEdgeMesh.IsManifold ());
+	ASSERT (!halfEdgeMesh.IsClosed ());
+
+	ASSERT (GetNeighbours (halfEdgeMesh, 0) == std::vector<unsigned int> ({ 1, 5, 4 }));
+	ASSERT (GetNeighbours (halfEdgeMesh, 3) == std::vector<unsigned int> ({ 7, 2 }));
+	ASSERT (GetNeighbours (halfEdgeMesh, 5).size () == 6);
+	ASSERT (GetNeighbours (halfEdgeMesh, 4).size () == 4);
+
+	std::vector<std::vector<unsigned int>> loops;
+	halfEdgeMesh.EnumerateBoundaryLoops ([&] (const std::vector<unsigned int>& loop) {
+		loops.push_back (loop);
+	});
+	ASSERT (loops.size () == 1);
+	ASSERT (loops[0].size () == 12);
+	for (size_t i = 0; i < loops[0].size (); i++) {
+		unsigned int halfEdge = loops[0][i];
+		unsigned int next = loops[0][(i + 1) % loops[0].size ()];
+		ASSERT (halfEdgeMesh.IsBoundary (halfEdge));
+		ASSERT (halfEdgeMesh.GetTarget (halfEdge) == halfEdgeMesh.GetOrigin (next));
+	}
+}
+
+TEST (NonManifoldMeshTest)
+{
+	MeshGeometry fin;
+	for (int i = 0; i < 5; i++) {
+		fin.AddVertex (i, i * i, 0.0);
+	}
+	fin.AddTriangle (0, 1, 2);
+	fin.AddTriangle (1, 0, 3);
+	fin.AddTriangle (1, 0, 4);
+	HalfEdgeMesh finHalfEdges (fin);
+	ASSERT (!finHalfEdges.IsEdgeManifold ());
+	ASSERT (!finHalfEdges.IsManifold ());
+	ASSERT (finHalfEdges.IsBoundary (0));
+	ASSERT (finHalfEdges.IsBoundary (3));
+	ASSERT (finHalfEdges.IsBoundary (6));
+
+	MeshGeometry bowTie;
+	for (int i = 0; i < 5; i++) {
+		bowTie.AddVertex (i, i * i, 0.0);
+	}
+	bowTie.AddTriangle (0, 1, 2);
+	bowTie.AddTriangle (0, 3, 4);
+	HalfEdgeMesh bowTieHalfEdges (bowTie);
+	ASSERT (bowTieHalfEdges.IsEdgeManifold ());
+	ASSERT (!bowTieHalfEdges.IsManifold ());
+	ASSERT (!bowTieHalfEdges.IsVertexManifold (0));
+	ASSERT (bowTieHalfEdges.IsVertexManifold (1));
+	unsigned int loopCount = 0;
+	bowTieHalfEdges.EnumerateBoundaryLoops ([&] (const std::vector<unsigned int>& loop) {
+		ASSERT (loop.size () == 3);
+		loopCount++;
+	});
+	ASSERT (loopCount == 2);
+}
+
+TEST (ModelHalfEdgeCacheTest)
+{
+	Model model;
+	Mesh mesh = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	MeshId meshId1 = model.AddMesh (mesh);
+	mesh.SetTransformation (glm::translate (glm::dmat4 (1.0), glm::dvec3 (2.0, 0.0, 0.0)));
+	MeshId meshId2 = model.AddMesh (mesh);
+
+	const HalfEdgeMesh& halfEdges1 = model.GetMeshHalfEdges (model.GetMesh (meshId1));
+	const HalfEdgeMesh& halfEdges2 = model.GetMeshHalfEdges (model.GetMesh (meshId2));
+	ASSERT (&halfEdges1 == &halfEdges2);
+	ASSERT (halfEdges1.IsClosed ());
+	ASSERT (halfEdges1.TriangleCount () == 12);
+
+	model.RemoveMesh (meshId1);
+	ASSERT (&model.GetMeshHalfEdges (model.GetMesh (meshId2)) == &halfEdges1);
+	model.Clear ();
+}
+
+}
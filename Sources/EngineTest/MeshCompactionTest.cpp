@@ -0,0 +1,143 @@
+#include "SimpleTest.hpp"
+#include "MeshCompaction.hpp"
+#include "MeshGenerators.hpp"
+#include "MeshTopology.hpp"
+#include "Geometry.hpp"
+#include "TestUtils.hpp"
+
+using namespace Modeler;
+
+namespace MeshCompactionTest
+{
+
+static MeshTopology GetMeshTopology (const Mesh& mesh)
+{
+	MeshTopology topology;
+	MeshTopologyBuilder builder (topology);
+	mesh.GetGeometry ().EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		builder.AddTriangle (triangle.v1, triangle.v2, triangle.v3);
+	});
+	return topology;
+}
+
+// every triangle gets its own vertices and normals like in stl files
+static Mesh GenerateTriangleSoup (const Mesh& mesh, double noise)
+{
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	const MeshMaterials& materials = mesh.GetMaterials ();
+	Mesh result;
+	materials.EnumerateMaterials ([&] (MaterialId, const Material& material) {
+		result.AddMaterial (material);
+	});
+	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		glm::dvec3 offset (noise * (i + 1), 0.0, 0.0);
+		unsigned int v1 = result.AddVertex (geometry.GetVertex (triangle.v1) + offset);
+		unsigned int v2 = result.AddVertex (geometry.GetVertex (triangle.v2) - offset);
+		unsigned int v3 = result.AddVertex (geometry.GetVertex (triangle.v3) + offset);
+		unsigned int n1 = result.AddNormal (geometry.GetNormal (triangle.n1));
+		unsigned int n2 = result.AddNormal (geometry.GetNormal (triangle.n2));
+		unsigned int n3 = result.AddNormal (geometry.GetNormal (triangle.n3));
+		result.AddTriangle (v1, v2, v3, n1, n2, n3, materials.GetTriangleMaterial (i));
+	}
+	return result;
+}
+
+TEST (WeldTriangleSoupTest)
+{
+	Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 4, true);
+	Mesh soup = GenerateTriangleSoup (mesh, 1.0e-12);
+	ASSERT (!GetMeshTopology (soup).IsClosed ());
+
+	Mesh compacted = CompactMesh (soup, DefaultWeldTolerance);
+	const MeshGeometry& geometry = compacted.GetGeometry ();
+	ASSERT (geometry.VertexCount () == mesh.GetGeometry ().VertexCount ());
+	ASSERT (geometry.NormalCount () == mesh.GetGeometry ().NormalCount ());
+	ASSERT (geometry.TriangleCount () == mesh.GetGeometry ().TriangleCount ());
+	ASSERT (compacted.GetMaterials ().TriangleCount () == geometry.TriangleCount ());
+
+	MeshTopology topology = GetMeshTopology (compacted);
+	ASSERT (topology.IsValid ());
+	ASSERT (topology.IsClosed ());
+
+	Mesh notWelded = CompactMesh (soup, 0.0);
+	ASSERT (notWelded.GetGeometry ().VertexCount () == soup.GetGeometry ().VertexCount ());
+	ASSERT (notWelded.GetGeometry ().NormalCount () == mesh.GetGeometry ().NormalCount ());
+}
+
+TEST (WeldToleranceTest)
+{
+	Mesh mesh;
+	MaterialId material1 = mesh.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0)));
+	MaterialId material2 = mesh.AddMaterial (Material (glm::dvec3 (0.0, 1.0, 0.0)));
+	mesh.AddVertex (0.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 1.0, 0.0);
+	mesh.AddVertex (1.0, 0.005, 0.0);
+	mesh.AddVertex (1.0, 1.02, 0.0);
+	mesh.AddVertex (5.0, 5.0, 5.0);
+	mesh.AddNormal (1.0, 0.0, 0.0);
+	mesh.AddTriangle (0, 1, 2, material1);
+	mesh.AddTriangle (0, 3, 1, material2);
+	mesh.AddTriangle (0, 3, 4, material2);
+	mesh.AddTriangle (0, 2, 4, material1);
+
+	std::vector<unsigned int> keptTriangles;
+	MeshGeometry geometry = CompactMeshGeometry (mesh.GetGeometry (), 0.01, keptTriangles);
+	ASSERT (keptTriangles == std::vector<unsigned int> ({ 0, 2, 3 }));
+	ASSERT (geometry.VertexCount () == 4);
+	ASSERT (geometry.NormalCount () == 1);
+	ASSERT (geometry.TriangleCount () == 3);
+	ASSERT (IsEqualVec (geometry.GetVertex (geometry.GetTriangle (1).v2), glm::dvec3 (1.0, 0.0, 0.0)));
+	ASSERT (IsEqualVec (geometry.GetVertex (geometry.GetTriangle (1).v3), glm::dvec3 (1.0, 1.02, 0.0)));
+
+	Mesh compacted = CompactMesh (mesh, 0.01);
+	const MeshMaterials& materials = compacted.GetMaterials ();
+	ASSERT (materials.MaterialCount () == 2);
+	ASSERT (materials.TriangleCount () == 3);
+	ASSERT (materials.GetTriangleMaterial (0) == material1);
+	ASSERT (materials.GetTriangleMaterial (1) == material2);
+	ASSERT (materials.GetTriangleMaterial (2) == material1);
+	ASSERT (compacted.GetGeometry ().GetTriangles () == geometry.GetTriangles ());
+}
+
+TEST (WeldChainTest)
+{
+	// the first and second vertices are too far, but both of them are close to the third one
+	Mesh mesh;
+	MaterialId material = mesh.AddMaterial (DefaultMaterial);
+	mesh.AddVertex (0.0, 0.0, 0.0);
+	mesh.AddVertex (0.02, 0.0, 0.0);
+	mesh.AddVertex (0.01, 0.0, 0.0);
+	mesh.AddVertex (1.0, 0.0, 0.0);
+	mesh.AddVertex (1.0, 1.0, 0.0);
+	mesh.AddNormal (0.0, 0.0, 1.0);
+	mesh.AddTriangle (0, 3, 4, material);
+	mesh.AddTriangle (1, 3, 4, material);
+	mesh.AddTriangle (2, 3, 4, material);
+
+	std::vector<unsigned int> keptTriangles;
+	MeshGeometry geometry = CompactMeshGeometry (mesh.GetGeometry (), 0.015, keptTriangles);
+	ASSERT (geometry.VertexCount () == 3);
+	ASSERT (keptTriangles.size () == 3);
+	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+		ASSERT (geometry.GetTriangle (i) == geometry.GetTriangle (0));
+	}
+	ASSERT (IsEqualVec (geometry.GetVertex (geometry.GetTriangle (0).v1), glm::dvec3 (0.0, 0.0, 0.0)));
+}
+
+TEST (CompactStorageWeldTest)
+{
+	Mesh soup = GenerateTriangleSoup (GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 2.0, 3, false), 0.0);
+	MeshGeometry compactSoup = soup.GetGeometry ();
+	compactSoup.SetStorage (MeshGeometryStorage::Compact);
+
+	std::vector<unsigned int> keptTriangles;
+	MeshGeometry geometry = CompactMeshGeometry (compactSoup, 0.0, keptTriangles);
+	ASSERT (geometry.GetStorage () == MeshGeometryStorage::Compact);
+	ASSERT (geometry.VertexCount () == 92);
+	ASSERT (geometry.NormalCount () == 180);
+	ASSERT (keptTriangles.size () == 180);
+}
+
+}
@@ -2,6 +2,7 @@
 #include "MeshGenerators.hpp"
 #include "MeshTopology.hpp"
 #include "Triangulation.hpp"
+#include "Geometry.hpp"
 #include "TestUtils.hpp"
 
 using namespace Modeler;
@@ -54,6 +55,153 @@ TEST (MeshGeneratorsTest)
 	}
 }
 
+TEST (GeneratorReserveTest)
+{
+	std::vector<Mesh> meshes {
+		GenerateSphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 50, false),
+		GenerateSphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 50, true),
+		GenerateTorus (DefaultMaterial, glm::dmat4 (1.0), 3.0, 0.5, 40, 30, false),
+		GenerateTorus (DefaultMaterial, glm::dmat4 (1.0), 3.0, 0.5, 40, 30, true),
+		GenerateCone (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2.0, 1.0, 50, true),
+		GenerateCone (DefaultMaterial, glm::dmat4 (1.0), 0.0, 2.0, 1.0, 50, false)
+	};
+
+	for (const Mesh& mesh : meshes) {
+		const MeshGeometry& geometry = mesh.GetGeometry ();
+		std::vector<glm::dvec3> vertices;
+		std::vector<glm::dvec3> normals;
+		for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+			vertices.push_back (geometry.GetVertex (i));
+		}
+		for (unsigned int i = 0; i < geometry.NormalCount (); i++) {
+			normals.push_back (geometry.GetNormal (i));
+		}
+
+		Mesh appended;
+		MaterialId materialId = appended.AddMaterial (DefaultMaterial);
+		appended.Reserve (geometry.VertexCount (), geometry.NormalCount (), geometry.TriangleCount ());
+		ASSERT (appended.AppendVertices (vertices.data (), vertices.size ()) == 0);
+		ASSERT (appended.AppendNormals (normals.data (), normals.size ()) == 0);
+		ASSERT (appended.AppendTriangles (geometry.GetTriangles ().data (), geometry.TriangleCount (), materialId) == 0);
+
+		ASSERT (appended.GetGeometry () == geometry);
+		ASSERT (appended.GetGeometry ().CalcCheckSum () == geometry.CalcCheckSum ());
+		ASSERT (appended.GetGeometry ().CalcMemorySize () == geometry.CalcMemorySize ());
+		ASSERT (appended.GetMaterials () == mesh.GetMaterials ());
+		ASSERT (appended.GetMaterials ().MaterialRangeCount () == 1);
+	}
+}
+
+TEST (SmoothNormalSharingTest)
+{
+	{
+		Mesh mesh = GenerateSphere (DefaultMaterial, glm::dmat4 (1.0), 2.0, 20, true);
+		const MeshGeometry& geometry = mesh.GetGeometry ();
+		ASSERT (geometry.NormalCount () == geometry.VertexCount ());
+		geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+			ASSERT (triangle.n1 == triangle.v1);
+			ASSERT (triangle.n2 == triangle.v2);
+			ASSERT (triangle.n3 == triangle.v3);
+		});
+		for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+			ASSERT (geometry.GetNormal (i) == glm::normalize (geometry.GetVertex (i)));
+		}
+	}
+
+	{
+		Mesh mesh = GenerateTorus (DefaultMaterial, glm::dmat4 (1.0), 3.0, 0.5, 20, 10, true);
+		const MeshGeometry& geometry = mesh.GetGeometry ();
+		ASSERT (geometry.NormalCount () == geometry.VertexCount ());
+		geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+			ASSERT (triangle.n1 == triangle.v1);
+			ASSERT (triangle.n2 == triangle.v2);
+			ASSERT (triangle.n3 == triangle.v3);
+		});
+	}
+
+	{
+		Mesh mesh = GenerateCone (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2.0, 1.0, 20, true);
+		ASSERT (mesh.GetGeometry ().NormalCount () == 2 + 2 * 20);
+		Mesh apexMesh = GenerateCone (DefaultMaterial, glm::dmat4 (1.0), 0.0, 2.0, 1.0, 20, true);
+		ASSERT (apexMesh.GetGeometry ().NormalCount () == 1 + 2 * 20);
+	}
+}
+
+TEST (TessellationToleranceTest)
+{
+	TessellationTolerance tolerance (0.01, PI / 6.0);
+	ASSERT (tolerance.Check ());
+	ASSERT (!TessellationTolerance (0.0, PI / 6.0).Check ());
+	ASSERT (!TessellationTolerance (0.01, 0.0).Check ());
+
+	ASSERT (CalculateCircleSegmentation (0.001, tolerance) == 12);
+	ASSERT (CalculateCircleSegmentation (0.01, tolerance) == 12);
+	ASSERT (CalculateSphereSegmentation (0.01, tolerance) == 6);
+
+	int lastSegmentation = 0;
+	for (double radius : { 0.1, 1.0, 10.0, 100.0 }) {
+		int segmentation = CalculateCircleSegmentation (radius, tolerance);
+		ASSERT (segmentation > lastSegmentation);
+		double halfAngle = PI / (double) segmentation;
+		ASSERT (radius * (1.0 - cos (halfAngle)) <= tolerance.GetChordalDeviation ());
+		ASSERT (2.0 * halfAngle <= tolerance.GetMaxSegmentAngle ());
+		lastSegmentation = segmentation;
+	}
+
+	ASSERT (CalculateCircleSegmentation (1.0e6, tolerance) == 1024);
+}
+
+TEST (IcosphereTest)
+{
+	for (int frequency : { 1, 2, 3, 8 }) {
+		for (bool isSmooth : { false, true }) {
+			Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 2.0, frequency, isSmooth);
+			const MeshGeometry& geometry = mesh.GetGeometry ();
+			ASSERT (geometry.VertexCount () == (unsigned int) (10 * frequency * frequency + 2));
+			ASSERT (geometry.TriangleCount () == (unsigned int) (20 * frequency * frequency));
+			ASSERT (geometry.NormalCount () == (isSmooth ? geometry.VertexCount () : geometry.TriangleCount ()));
+			for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+				ASSERT (Geometry::IsEqual (glm::length (geometry.GetVertex (i)), 2.0));
+			}
+
+			MeshTopology topology = GetTopology (mesh);
+			ASSERT (topology.IsValid ());
+			ASSERT (topology.IsClosed ());
+		}
+	}
+
+	Mesh icosahedron = GeneratePlatonicSolid (DefaultMaterial, glm::dmat4 (1.0), PlatonicSolidType::Icosahedron, 2.0);
+	Mesh icosphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 2.0, 1, false);
+	ASSERT (icosphere.GetGeometry ().GetTriangles () == icosahedron.GetGeometry ().GetTriangles ());
+}
+
+static double GetMaxSphereDeviation (const Mesh& mesh, double radius)
+{
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	double maxDeviation = 0.0;
+	geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		glm::dvec3 v1 = geometry.GetVertex (triangle.v1);
+		glm::dvec3 normal = glm::normalize (glm::cross (geometry.GetVertex (triangle.v2) - v1, geometry.GetVertex (triangle.v3) - v1));
+		maxDeviation = std::max (maxDeviation, radius - glm::dot (normal, v1));
+	});
+	return maxDeviation;
+}
+
+TEST (IcosphereToleranceTest)
+{
+	TessellationTolerance tolerance (0.001, PI / 6.0);
+	for (double radius : { 0.5, 2.0, 10.0 }) {
+		Mesh icosphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), radius, CalculateIcosphereFrequency (radius, tolerance), false);
+		double icosphereDeviation = GetMaxSphereDeviation (icosphere, radius);
+		ASSERT (icosphereDeviation <= tolerance.GetChordalDeviation ());
+
+		// the deviation of both spheres is inversely proportional to the triangle count
+		Mesh sphere = GenerateSphere (DefaultMaterial, glm::dmat4 (1.0), radius, CalculateSphereSegmentation (radius, tolerance), false);
+		double sphereDeviation = GetMaxSphereDeviation (sphere, radius);
+		ASSERT (icosphereDeviation * icosphere.GetGeometry ().TriangleCount () < 0.75 * sphereDeviation * sphere.GetGeometry ().TriangleCount ());
+	}
+}
+
 TEST (PrismGeneratorTest)
 {
 	class CGALTriangulator : public Triangulator
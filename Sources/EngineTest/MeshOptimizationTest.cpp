@@ -0,0 +1,151 @@
+#include "SimpleTest.hpp"
+#include "MeshOptimization.hpp"
+#include "MeshGenerators.hpp"
+#include "MeshTopology.hpp"
+
+#include <algorithm>
+
+using namespace Modeler;
+
+namespace MeshOptimizationTest
+{
+
+// vertex positions and normals of the triangles in a range, independently of the indices
+static std::vector<std::vector<double>> GetTriangleKeys (const MeshGeometry& geometry, unsigned int firstTriangle, unsigned int triangleCount)
+{
+	std::vector<std::vector<double>> keys;
+	for (unsigned int i = firstTriangle; i < firstTriangle + triangleCount; i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		std::vector<double> key;
+		for (const glm::dvec3& vector : {
+			geometry.GetVertex (triangle.v1), geometry.GetVertex (triangle.v2), geometry.GetVertex (triangle.v3),
+			geometry.GetNormal (triangle.n1), geometry.GetNormal (triangle.n2), geometry.GetNormal (triangle.n3) })
+		{
+			key.insert (key.end (), { vector.x, vector.y, vector.z });
+		}
+		keys.push_back (key);
+	}
+	std::sort (keys.begin (), keys.end ());
+	return keys;
+}
+
+static bool IsOrderedByFirstUse (const MeshGeometry& geometry)
+{
+	unsigned int nextVertex = 0;
+	for (const MeshTriangle& triangle : geometry.GetTriangles ()) {
+		for (unsigned int vertex : { triangle.v1, triangle.v2, triangle.v3 }) {
+			if (vertex > nextVertex) {
+				return false;
+			}
+			if (vertex == nextVertex) {
+				nextVertex++;
+			}
+		}
+	}
+	return true;
+}
+
+static Mesh ShuffleTriangles (const Mesh& mesh)
+{
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	std::vector<MeshTriangle> triangles = geometry.GetTriangles ();
+	unsigned int random = 1;
+	for (size_t i = triangles.size () - 1; i > 0; i--) {
+		random = random * 1103515245u + 12345u;
+		std::swap (triangles[i], triangles[(random >> 8) % (i + 1)]);
+	}
+
+	Mesh result;
+	std::vector<glm::dvec3> vertices = geometry.GetTransformedVertices (glm::dmat4 (1.0));
+	std::vector<glm::dvec3> normals = geometry.GetTransformedNormals (glm::dmat4 (1.0));
+	result.AppendVertices (vertices.data (), vertices.size ());
+	result.AppendNormals (normals.data (), normals.size ());
+	result.AppendTriangles (triangles.data (), triangles.size (), result.AddMaterial (DefaultMaterial));
+	return result;
+}
+
+TEST (AverageCacheMissRatioTest)
+{
+	Mesh mesh;
+	MaterialId material = mesh.AddMaterial (DefaultMaterial);
+	for (int i = 0; i < 5; i++) {
+		mesh.AddVertex (i, i % 2, 0.0);
+	}
+	mesh.AddTriangle (0, 1, 2, material);
+	ASSERT (CalculateAverageCacheMissRatio (mesh.GetGeometry (), 16) == 3.0);
+	mesh.AddTriangle (2, 1, 3, material);
+	mesh.AddTriangle (2, 3, 4, material);
+	ASSERT (CalculateAverageCacheMissRatio (mesh.GetGeometry (), 16) == 5.0 / 3.0);
+	mesh.AddTriangle (0, 1, 2, material);
+	ASSERT (CalculateAverageCacheMissRatio (mesh.GetGeometry (), 16) == 5.0 / 4.0);
+	ASSERT (CalculateAverageCacheMissRatio (mesh.GetGeometry (), 3) == 8.0 / 4.0);
+	ASSERT (CalculateAverageCacheMissRatio (MeshGeometry (), 16) == 0.0);
+}
+
+TEST (OptimizeShuffledSphereTest)
+{
+	Mesh mesh = ShuffleTriangles (GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 20, true));
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	double shuffledRatio = CalculateAverageCacheMissRatio (geometry, 16);
+	ASSERT (shuffledRatio > 2.0);
+
+	Mesh optimized = OptimizeTriangleOrder (mesh);
+	const MeshGeometry& optimizedGeometry = optimized.GetGeometry ();
+	ASSERT (optimizedGeometry.VertexCount () == geometry.VertexCount ());
+	ASSERT (optimizedGeometry.NormalCount () == geometry.NormalCount ());
+	ASSERT (optimizedGeometry.TriangleCount () == geometry.TriangleCount ());
+	ASSERT (optimized.GetMaterials () == mesh.GetMaterials ());
+	ASSERT (GetTriangleKeys (optimizedGeometry, 0, geometry.TriangleCount ()) == GetTriangleKeys (geometry, 0, geometry.TriangleCount ()));
+	ASSERT (IsOrderedByFirstUse (optimizedGeometry));
+	ASSERT (CalculateAverageCacheMissRatio (optimizedGeometry, 16) < 0.8);
+	ASSERT (CalculateAverageCacheMissRatio (optimizedGeometry, 32) < 0.7);
+
+	MeshTopology topology;
+	MeshTopologyBuilder builder (topology);
+	optimizedGeometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		builder.AddTriangle (triangle.v1, triangle.v2, triangle.v3);
+	});
+	ASSERT (topology.IsValid ());
+	ASSERT (topology.IsClosed ());
+}
+
+TEST (OptimizeMaterialRangesTest)
+{
+	Mesh mesh;
+	MaterialId material1 = mesh.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0)));
+	MaterialId material2 = mesh.AddMaterial (Material (glm::dvec3 (0.0, 1.0, 0.0)));
+	int size = 20;
+	for (int i = 0; i <= size; i++) {
+		for (int j = 0; j <= size; j++) {
+			mesh.AddVertex (i, j, 0.0);
+		}
+	}
+	unsigned int normal = mesh.AddNormal (0.0, 0.0, 1.0);
+	for (int i = 0; i < size; i++) {
+		MaterialId material = (i % 3 == 0) ? material1 : material2;
+		for (int j = size - 1; j >= 0; j--) {
+			unsigned int v1 = i * (size + 1) + j;
+			unsigned int v2 = v1 + size + 1;
+			mesh.AddTriangle (v1, v2 + 1, v1 + 1, normal, material);
+			mesh.AddTriangle (v1, v2, v2 + 1, normal, material);
+		}
+	}
+
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	const MeshMaterials& materials = mesh.GetMaterials ();
+	MeshGeometry optimized = OptimizeTriangleOrder (geometry, materials);
+	ASSERT (IsOrderedByFirstUse (optimized));
+	ASSERT (CalculateAverageCacheMissRatio (optimized, 16) < CalculateAverageCacheMissRatio (geometry, 16));
+
+	Mesh optimizedMesh = OptimizeTriangleOrder (mesh);
+	ASSERT (optimizedMesh.GetGeometry () == optimized);
+	ASSERT (optimizedMesh.GetMaterials () == materials);
+	unsigned int rangeCount = 0;
+	materials.EnumerateTrianglesByMaterial ([&] (MaterialId, unsigned int firstTriangle, unsigned int triangleCount) {
+		ASSERT (GetTriangleKeys (optimized, firstTriangle, triangleCount) == GetTriangleKeys (geometry, firstTriangle, triangleCount));
+		rangeCount++;
+	});
+	ASSERT (rangeCount == materials.MaterialRangeCount ());
+}
+
+}
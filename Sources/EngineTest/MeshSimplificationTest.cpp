@@ -0,0 +1,233 @@
+#include "SimpleTest.hpp"
+#include "MeshSimplification.hpp"
+#include "MeshGenerators.hpp"
+#include "MeshTopology.hpp"
+#include "Geometry.hpp"
+
+using namespace Modeler;
+
+namespace MeshSimplificationTest
+{
+
+static bool IsClosedManifold (const Mesh& mesh)
+{
+	MeshTopology topology;
+	MeshTopologyBuilder builder (topology);
+	mesh.GetGeometry ().EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		builder.AddTriangle (triangle.v1, triangle.v2, triangle.v3);
+	});
+	return topology.IsValid () && topology.IsClosed ();
+}
+
+static double GetTriangleArea (const MeshGeometry& geometry, const MeshTriangle& triangle)
+{
+	glm::dvec3 v1 = geometry.GetVertex (triangle.v1);
+	return glm::length (glm::cross (geometry.GetVertex (triangle.v2) - v1, geometry.GetVertex (triangle.v3) - v1)) / 2.0;
+}
+
+static Mesh GenerateTwoMaterialGrid (int size)
+{
+	Mesh mesh;
+	MaterialId leftMaterial = mesh.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0)));
+	MaterialId rightMaterial = mesh.AddMaterial (Material (glm::dvec3 (0.0, 0.0, 1.0)));
+	for (int i = 0; i <= size; i++) {
+		for (int j = 0; j <= size; j++) {
+			mesh.AddVertex (-1.0 + 2.0 * i / size, -1.0 + 2.0 * j / size, 0.0);
+		}
+	}
+	unsigned int normal = mesh.AddNormal (0.0, 0.0, 1.0);
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < size; j++) {
+			unsigned int v1 = i * (size + 1) + j;
+			unsigned int v2 = v1 + size + 1;
+			MaterialId material = (i < size / 2) ? leftMaterial : rightMaterial;
+			mesh.AddTriangle (v1, v2, v2 + 1, normal, material);
+			mesh.AddTriangle (v1, v2 + 1, v1 + 1, normal, material);
+		}
+	}
+	return mesh;
+}
+
+// two smooth slopes meeting in a hard edge, every vertex has its own normal on both sides
+static Mesh GenerateCreasedGrid (int size)
+{
+	Mesh mesh;
+	MaterialId material = mesh.AddMaterial (DefaultMaterial);
+	glm::dvec3 leftNormal = glm::normalize (glm::dvec3 (1.0, 0.0, 1.0));
+	glm::dvec3 rightNormal = glm::normalize (glm::dvec3 (-1.0, 0.0, 1.0));
+	std::vector<unsigned int> leftNormals;
+	std::vector<unsigned int> rightNormals;
+	for (int i = 0; i <= size; i++) {
+		for (int j = 0; j <= size; j++) {
+			double x = -1.0 + 2.0 * i / size;
+			mesh.AddVertex (x, -1.0 + 2.0 * j / size, -std::fabs (x));
+			leftNormals.push_back (mesh.AddNormal (leftNormal));
+			rightNormals.push_back (mesh.AddNormal (rightNormal));
+		}
+	}
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < size; j++) {
+			unsigned int v1 = i * (size + 1) + j;
+			unsigned int v2 = v1 + size + 1;
+			const std::vector<unsigned int>& normals = (i < size / 2) ? leftNormals : rightNormals;
+			mesh.AddTriangle (v1, v2, v2 + 1, normals[v1], normals[v2], normals[v2 + 1], material);
+			mesh.AddTriangle (v1, v2 + 1, v1 + 1, normals[v1], normals[v2 + 1], normals[v1 + 1], material);
+		}
+	}
+	return mesh;
+}
+
+TEST (SimplifyIcosphereTest)
+{
+	double radius = 2.0;
+	Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (1.0, 2.0, 3.0)), radius, 30, true);
+	ASSERT (mesh.GetGeometry ().TriangleCount () == 18000);
+
+	Mesh simplified = SimplifyMesh (mesh, 0.1);
+	const MeshGeometry& geometry = simplified.GetGeometry ();
+	ASSERT (geometry.TriangleCount () <= 1800);
+	ASSERT (geometry.TriangleCount () >= 1700);
+	ASSERT (geometry.NormalCount () == geometry.VertexCount ());
+	ASSERT (simplified.GetTransformation () == mesh.GetTransformation ());
+	ASSERT (simplified.GetMaterials ().TriangleCount () == geometry.TriangleCount ());
+	ASSERT (IsClosedManifold (simplified));
+	for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+		ASSERT (std::fabs (glm::length (geometry.GetVertex (i)) - radius) < 0.01 * radius);
+		ASSERT (glm::dot (geometry.GetNormal (i), glm::normalize (geometry.GetVertex (i))) > 0.99);
+	}
+}
+
+TEST (SimplifyMaterialBoundaryTest)
+{
+	Mesh mesh = GenerateTwoMaterialGrid (40);
+	Mesh simplified = SimplifyMesh (mesh, 0.1);
+	const MeshGeometry& geometry = simplified.GetGeometry ();
+	const MeshMaterials& materials = simplified.GetMaterials ();
+	ASSERT (geometry.TriangleCount () <= 320);
+	ASSERT (materials.MaterialCount () == 2);
+	ASSERT (materials.GetMaterial (0) == mesh.GetMaterials ().GetMaterial (0));
+	ASSERT (materials.GetMaterial (1) == mesh.GetMaterials ().GetMaterial (1));
+
+	double areas[2] = { 0.0, 0.0 };
+	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		MaterialId material = materials.GetTriangleMaterial (i);
+		for (unsigned int vertex : { triangle.v1, triangle.v2, triangle.v3 }) {
+			glm::dvec3 position = geometry.GetVertex (vertex);
+			ASSERT (Geometry::IsLowerOrEqual (std::fabs (position.x), 1.0));
+			ASSERT (Geometry::IsLowerOrEqual (std::fabs (position.y), 1.0));
+			ASSERT (Geometry::IsEqual (position.z, 0.0));
+			ASSERT (material == 0 ? Geometry::IsLowerOrEqual (position.x, 0.0) : Geometry::IsGreaterOrEqual (position.x, 0.0));
+		}
+		ASSERT (Geometry::IsEqual (glm::dot (geometry.GetNormal (triangle.n1), glm::dvec3 (0.0, 0.0, 1.0)), 1.0));
+		areas[material] += GetTriangleArea (geometry, triangle);
+	}
+	ASSERT (Geometry::IsEqual (areas[0], 2.0));
+	ASSERT (Geometry::IsEqual (areas[1], 2.0));
+}
+
+TEST (SimplifyHardEdgeTest)
+{
+	Mesh mesh = GenerateCreasedGrid (40);
+	Mesh simplified = SimplifyMesh (mesh, 0.1);
+	const MeshGeometry& geometry = simplified.GetGeometry ();
+	ASSERT (geometry.TriangleCount () <= 320);
+
+	glm::dvec3 leftNormal = glm::normalize (glm::dvec3 (1.0, 0.0, 1.0));
+	glm::dvec3 rightNormal = glm::normalize (glm::dvec3 (-1.0, 0.0, 1.0));
+	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		glm::dvec3 center = (geometry.GetVertex (triangle.v1) + geometry.GetVertex (triangle.v2) + geometry.GetVertex (triangle.v3)) / 3.0;
+		glm::dvec3 expected = center.x < 0.0 ? leftNormal : rightNormal;
+		for (unsigned int normal : { triangle.n1, triangle.n2, triangle.n3 }) {
+			ASSERT (Geometry::IsEqual (glm::dot (geometry.GetNormal (normal), expected), 1.0));
+		}
+	}
+}
+
+TEST (SimplifyInvalidRatioTest)
+{
+	Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2, false);
+	for (double ratio : { 0.0, -0.5, 1.5 }) {
+		bool thrown = false;
+		try {
+			SimplifyMesh (mesh, ratio);
+		} catch (const std::logic_error&) {
+			thrown = true;
+		}
+		ASSERT (thrown);
+	}
+}
+
+TEST (MeshLodChainTest)
+{
+	Model model;
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 10, true);
+	Mesh box = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2.0, 3.0);
+	MeshId sphereId = model.AddMesh (sphere);
+	model.AddMesh (sphere);
+	sphere.SetTransformation (glm::translate (glm::dmat4 (1.0), glm::dvec3 (5.0, 0.0, 0.0)));
+	model.AddMesh (sphere);
+	MeshId boxId = model.AddMesh (box);
+
+	// the same geometry with one and with two materials
+	Mesh twoMaterialGrid = GenerateTwoMaterialGrid (20);
+	Mesh oneMaterialGrid;
+	MaterialId gridMaterial = oneMaterialGrid.AddMaterial (DefaultMaterial);
+	const MeshGeometry& gridGeometry = twoMaterialGrid.GetGeometry ();
+	for (unsigned int i = 0; i < gridGeometry.VertexCount (); i++) {
+		oneMaterialGrid.AddVertex (gridGeometry.GetVertex (i));
+	}
+	for (unsigned int i = 0; i < gridGeometry.NormalCount (); i++) {
+		oneMaterialGrid.AddNormal (gridGeometry.GetNormal (i));
+	}
+	oneMaterialGrid.AppendTriangles (gridGeometry.GetTriangles ().data (), gridGeometry.TriangleCount (), gridMaterial);
+	MeshId twoMaterialGridId = model.AddMesh (twoMaterialGrid);
+	MeshId oneMaterialGridId = model.AddMesh (oneMaterialGrid);
+	ASSERT (model.GetMesh (twoMaterialGridId).GetGeometryId () == model.GetMesh (oneMaterialGridId).GetGeometryId ());
+
+	std::vector<double> ratios = { 0.5, 0.25, 0.125 };
+	std::unordered_map<MeshLodKey, MeshLodChain, MeshLodKeyHash> lodChains = BuildMeshLodChains (model, ratios);
+	ASSERT (lodChains.size () == 4);
+
+	auto getLodChain = [&] (MeshId meshId) -> const MeshLodChain& {
+		const MeshRef& meshRef = model.GetMesh (meshId);
+		return lodChains.at (MeshLodKey (meshRef.GetGeometryId (), meshRef.GetMaterialsId ()));
+	};
+
+	const MeshLodChain& sphereLods = getLodChain (sphereId);
+	ASSERT (sphereLods.size () == ratios.size ());
+	for (size_t i = 0; i < sphereLods.size (); i++) {
+		unsigned int triangleCount = sphereLods[i].GetGeometry ().TriangleCount ();
+		ASSERT (triangleCount <= (unsigned int) (ratios[i] * 2000));
+		ASSERT (triangleCount >= (unsigned int) (ratios[i] * 2000) - 2);
+		ASSERT (IsClosedManifold (sphereLods[i]));
+	}
+
+	const MeshLodChain& boxLods = getLodChain (boxId);
+	ASSERT (boxLods.size () == ratios.size ());
+	ASSERT (boxLods[0].GetGeometry ().TriangleCount () == 6);
+	for (const Mesh& lod : boxLods) {
+		ASSERT (lod.GetGeometry ().TriangleCount () >= 4);
+		ASSERT (IsClosedManifold (lod));
+	}
+
+	for (const Mesh& lod : getLodChain (oneMaterialGridId)) {
+		ASSERT (lod.GetMaterials ().MaterialCount () == 1);
+	}
+	for (const Mesh& lod : getLodChain (twoMaterialGridId)) {
+		const MeshGeometry& geometry = lod.GetGeometry ();
+		const MeshMaterials& materials = lod.GetMaterials ();
+		ASSERT (materials.MaterialCount () == 2);
+		for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+			const MeshTriangle& triangle = geometry.GetTriangle (i);
+			MaterialId material = materials.GetTriangleMaterial (i);
+			for (unsigned int vertex : { triangle.v1, triangle.v2, triangle.v3 }) {
+				double x = geometry.GetVertex (vertex).x;
+				ASSERT (material == 0 ? Geometry::IsLowerOrEqual (x, 0.0) : Geometry::IsGreaterOrEqual (x, 0.0));
+			}
+		}
+	}
+}
+
+}
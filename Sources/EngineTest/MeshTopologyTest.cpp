@@ -1,11 +1,62 @@
 #include "SimpleTest.hpp"
 #include "MeshTopology.hpp"
+#include "MeshGenerators.hpp"
 
 using namespace Modeler;
 
 namespace MeshTopologyTest
 {
 
+static MeshGeometry CreateGeometry (const std::vector<std::vector<unsigned int>>& triangles)
+{
+	MeshGeometry geometry;
+	for (unsigned int i = 0; i < 5; i++) {
+		geometry.AddVertex (i, i * i, 0.0);
+	}
+	for (const std::vector<unsigned int>& triangle : triangles) {
+		geometry.AddTriangle (triangle[0], triangle[1], triangle[2]);
+	}
+	return geometry;
+}
+
+static bool IsEqualTopology (const MeshTopology& a, const MeshTopology& b)
+{
+	if (a.IsValid () != b.IsValid () || a.GetTriangles ().size () != b.GetTriangles ().size () || a.GetEdges ().size () != b.GetEdges ().size ()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.GetTriangles ().size (); i++) {
+		const MeshTopology::Triangle& ta = a.GetTriangles ()[i];
+		const MeshTopology::Triangle& tb = b.GetTriangles ()[i];
+		if (ta.edge1.edge != tb.edge1.edge || ta.edge2.edge != tb.edge2.edge || ta.edge3.edge != tb.edge3.edge) {
+			return false;
+		}
+		if (ta.edge1.reversed != tb.edge1.reversed || ta.edge2.reversed != tb.edge2.reversed || ta.edge3.reversed != tb.edge3.reversed) {
+			return false;
+		}
+	}
+	for (size_t i = 0; i < a.GetEdges ().size (); i++) {
+		const MeshTopology::Edge& ea = a.GetEdges ()[i];
+		const MeshTopology::Edge& eb = b.GetEdges ()[i];
+		if (ea.beg != eb.beg || ea.end != eb.end || ea.triangle1 != eb.triangle1 || ea.triangle2 != eb.triangle2) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static MeshTopologyBuilder::Result BuildIncrementally (const MeshGeometry& geometry, MeshTopology& topology)
+{
+	MeshTopologyBuilder builder (topology);
+	builder.Reserve (geometry.TriangleCount ());
+	MeshTopologyBuilder::Result result = MeshTopologyBuilder::Result::NoError;
+	geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		if (result == MeshTopologyBuilder::Result::NoError) {
+			result = builder.AddTriangle (triangle.v1, triangle.v2, triangle.v3);
+		}
+	});
+	return result;
+}
+
 TEST (MeshTopologyTest_OneTriangle)
 {
 	MeshTopology topology;
@@ -100,4 +151,48 @@ TEST (MeshTopologyTest_TetrahedronTest)
 	ASSERT (topology.IsValid ());
 }
 
+TEST (MeshTopologyTest_BuildTwoTriangles)
+{
+	MeshGeometry geometry = CreateGeometry ({ { 0, 1, 2 }, { 1, 3, 2 } });
+	MeshTopology topology;
+	MeshTopology incremental;
+	ASSERT (MeshTopologyBuilder::Build (geometry, topology) == MeshTopologyBuilder::Result::NoError);
+	ASSERT (BuildIncrementally (geometry, incremental) == MeshTopologyBuilder::Result::NoError);
+	ASSERT (topology.GetEdges ().size () == 5);
+	ASSERT (IsEqualTopology (topology, incremental));
+
+	ASSERT (MeshTopologyBuilder::Build (MeshGeometry (), topology) == MeshTopologyBuilder::Result::NoError);
+	ASSERT (topology.IsEmpty ());
+	ASSERT (topology.IsValid ());
+}
+
+TEST (MeshTopologyTest_BuildNonManifold)
+{
+	std::vector<MeshGeometry> geometries = {
+		CreateGeometry ({ { 0, 1, 2 }, { 1, 2, 3 } }),
+		CreateGeometry ({ { 0, 1, 2 }, { 1, 3, 2 }, { 4, 1, 2 } }),
+		CreateGeometry ({ { 0, 1, 2 }, { 1, 3, 2 }, { 4, 2, 1 } })
+	};
+	for (const MeshGeometry& geometry : geometries) {
+		MeshTopology topology;
+		ASSERT (MeshTopologyBuilder::Build (geometry, topology) == MeshTopologyBuilder::Result::NonManifoldEdgeFound);
+		ASSERT (topology.IsEmpty ());
+		ASSERT (!topology.IsValid ());
+	}
+}
+
+TEST (MeshTopologyTest_BuildLargeMesh)
+{
+	Mesh mesh = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 60, true);
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	MeshTopology topology;
+	MeshTopology incremental;
+	ASSERT (MeshTopologyBuilder::Build (geometry, topology) == MeshTopologyBuilder::Result::NoError);
+	ASSERT (BuildIncrementally (geometry, incremental) == MeshTopologyBuilder::Result::NoError);
+	ASSERT (topology.GetTriangles ().size () == 72000);
+	ASSERT (topology.GetEdges ().size () == 108000);
+	ASSERT (topology.IsClosed ());
+	ASSERT (IsEqualTopology (topology, incremental));
+}
+
 }
@@ -78,6 +78,320 @@ TEST (MaterialTest)
 	}
 }
 
+TEST (DifferentGeometryTest)
+{
+	Model model;
+
+	Mesh mesh1 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	Mesh mesh2 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0 + 1.0e-12);
+	model.AddMesh (mesh1);
+	model.AddMesh (mesh2);
+
+	ModelInfo modelInfo = model.GetInfo ();
+	ASSERT (modelInfo.meshGeometryCount == 2);
+	ASSERT (modelInfo.meshMaterialsCount == 1);
+	ASSERT (modelInfo.meshCount == 2);
+}
+
+TEST (IncrementalChecksumTest)
+{
+	Mesh mesh1 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	Mesh mesh2 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 2.0, 1.0, 1.0);
+	ASSERT (mesh1.GetGeometry ().CalcCheckSum () != mesh2.GetGeometry ().CalcCheckSum ());
+	ASSERT (mesh1.GetMaterials ().CalcCheckSum () == mesh2.GetMaterials ().CalcCheckSum ());
+
+	mesh2.Clear ();
+	ASSERT (mesh2.GetGeometry ().CalcCheckSum () == EmptyMesh.GetGeometry ().CalcCheckSum ());
+	ASSERT (mesh2.GetMaterials ().CalcCheckSum () == EmptyMesh.GetMaterials ().CalcCheckSum ());
+
+	mesh2 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	ASSERT (mesh1.GetGeometry ().CalcCheckSum () == mesh2.GetGeometry ().CalcCheckSum ());
+	ASSERT (mesh1.GetMaterials ().CalcCheckSum () == mesh2.GetMaterials ().CalcCheckSum ());
+}
+
+TEST (CopyOnWriteTest)
+{
+	Mesh mesh1 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	Mesh mesh2 = mesh1;
+	ASSERT (&mesh1.GetGeometry ().GetTriangle (0) == &mesh2.GetGeometry ().GetTriangle (0));
+	ASSERT (mesh1.GetGeometry () == mesh2.GetGeometry ());
+
+	mesh2.AddVertex (glm::dvec3 (2.0, 2.0, 2.0));
+	mesh2.AddTriangle (0, 1, 8, mesh2.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0))));
+	ASSERT (&mesh1.GetGeometry ().GetTriangle (0) != &mesh2.GetGeometry ().GetTriangle (0));
+	ASSERT (mesh1.GetGeometry () != mesh2.GetGeometry ());
+	ASSERT (mesh1.GetMaterials () != mesh2.GetMaterials ());
+	ASSERT (mesh1.GetGeometry ().VertexCount () == 8);
+	ASSERT (mesh1.GetGeometry ().TriangleCount () == 12);
+	ASSERT (mesh1.GetMaterials ().MaterialCount () == 1);
+	ASSERT (mesh2.GetGeometry ().VertexCount () == 9);
+	ASSERT (mesh2.GetGeometry ().TriangleCount () == 13);
+	ASSERT (mesh2.GetMaterials ().MaterialCount () == 2);
+	ASSERT (mesh1.GetGeometry ().CalcCheckSum () != mesh2.GetGeometry ().CalcCheckSum ());
+
+	Mesh mesh3 = std::move (mesh2);
+	ASSERT (mesh3.GetGeometry ().VertexCount () == 9);
+	ASSERT (mesh2.GetGeometry ().VertexCount () == 0);
+	mesh2.AddVertex (glm::dvec3 (0.0, 0.0, 0.0));
+	ASSERT (mesh2.GetGeometry ().VertexCount () == 1);
+	ASSERT (EmptyMesh.GetGeometry ().VertexCount () == 0);
+}
+
+TEST (MoveMeshTest)
+{
+	Model model;
+
+	Mesh mesh1 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	const MeshTriangle* triangleData = &mesh1.GetGeometry ().GetTriangle (0);
+	MeshId meshId1 = model.AddMesh (std::move (mesh1));
+	ASSERT (mesh1.GetGeometry ().VertexCount () == 0);
+	ASSERT (mesh1.GetMaterials ().MaterialCount () == 0);
+
+	const MeshGeometry& geometry = model.GetMeshGeometry (model.GetMesh (meshId1));
+	ASSERT (&geometry.GetTriangle (0) == triangleData);
+	ASSERT (geometry.VertexCount () == 8);
+
+	model.AddMesh (GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0));
+	ModelInfo modelInfo = model.GetInfo ();
+	ASSERT (modelInfo.meshGeometryCount == 1);
+	ASSERT (modelInfo.meshMaterialsCount == 1);
+	ASSERT (modelInfo.meshCount == 2);
+}
+
+TEST (EnumerateMeshDataTest)
+{
+	Mesh mesh = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	ASSERT (geometry.GetTriangles ().size () == geometry.TriangleCount ());
+
+	glm::dmat4 transformation = glm::translate (glm::dmat4 (1.0), glm::dvec3 (1.0, 2.0, 3.0));
+	unsigned int vertexIndex = 0;
+	geometry.EnumerateVertices (transformation, [&] (const glm::dvec3& vertex) {
+		ASSERT (IsEqualVec (vertex, geometry.GetVertex (vertexIndex) + glm::dvec3 (1.0, 2.0, 3.0)));
+		vertexIndex++;
+	});
+	ASSERT (vertexIndex == geometry.VertexCount ());
+
+	unsigned int triangleCount = 0;
+	mesh.GetMaterials ().EnumerateTrianglesByMaterial ([&] (MaterialId materialId, unsigned int firstTriangle, unsigned int count) {
+		ASSERT (materialId == 0);
+		ASSERT (firstTriangle == triangleCount);
+		triangleCount += count;
+	});
+	ASSERT (triangleCount == geometry.TriangleCount ());
+}
+
+TEST (MaterialRangesTest)
+{
+	MeshMaterials materials;
+	MaterialId red = materials.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0)));
+	MaterialId green = materials.AddMaterial (Material (glm::dvec3 (0.0, 1.0, 0.0)));
+	MaterialId blue = materials.AddMaterial (Material (glm::dvec3 (0.0, 0.0, 1.0)));
+
+	std::vector<MaterialId> triangleMaterials = { blue, blue, red, red, red, blue, green, green, red };
+	for (MaterialId materialId : triangleMaterials) {
+		materials.AddTriangleMaterial (materialId);
+	}
+	ASSERT (materials.TriangleCount () == triangleMaterials.size ());
+	ASSERT (materials.MaterialRangeCount () == 5);
+	for (unsigned int i = 0; i < triangleMaterials.size (); i++) {
+		ASSERT (materials.GetTriangleMaterial (i) == triangleMaterials[i]);
+	}
+
+	std::vector<MeshMaterialRange> ranges;
+	materials.EnumerateTrianglesByMaterial ([&] (MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount) {
+		ranges.push_back (MeshMaterialRange (materialId, firstTriangle, triangleCount));
+	});
+	ASSERT (ranges.size () == 5);
+	ASSERT (ranges[0] == MeshMaterialRange (red, 2, 3));
+	ASSERT (ranges[1] == MeshMaterialRange (red, 8, 1));
+	ASSERT (ranges[2] == MeshMaterialRange (green, 6, 2));
+	ASSERT (ranges[3] == MeshMaterialRange (blue, 0, 2));
+	ASSERT (ranges[4] == MeshMaterialRange (blue, 5, 1));
+
+	MeshMaterials other;
+	other.AddMaterial (Material (glm::dvec3 (1.0, 0.0, 0.0)));
+	other.AddMaterial (Material (glm::dvec3 (0.0, 1.0, 0.0)));
+	other.AddMaterial (Material (glm::dvec3 (0.0, 0.0, 1.0)));
+	for (MaterialId materialId : triangleMaterials) {
+		other.AddTriangleMaterial (materialId);
+	}
+	ASSERT (other == materials);
+	ASSERT (other.CalcCheckSum () == materials.CalcCheckSum ());
+	other.AddTriangleMaterial (red);
+	ASSERT (other != materials);
+	ASSERT (other.CalcCheckSum () != materials.CalcCheckSum ());
+
+	MeshMaterials extended = materials;
+	extended.AddTriangleMaterials (red, 3);
+	extended.AddTriangleMaterial (blue);
+	other.AddTriangleMaterials (red, 2);
+	other.AddTriangleMaterial (blue);
+	ASSERT (other == extended);
+	ASSERT (other.CalcCheckSum () == extended.CalcCheckSum ());
+	ASSERT (materials.MaterialRangeCount () == 5);
+	ASSERT (extended.MaterialRangeCount () == 6);
+
+	ranges.clear ();
+	extended.EnumerateTrianglesByMaterial ([&] (MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount) {
+		ranges.push_back (MeshMaterialRange (materialId, firstTriangle, triangleCount));
+	});
+	ASSERT (ranges.size () == 6);
+	ASSERT (ranges[1] == MeshMaterialRange (red, 8, 4));
+	ASSERT (ranges[5] == MeshMaterialRange (blue, 12, 1));
+}
+
+TEST (CompactStorageTest)
+{
+	Mesh sphere = GenerateSphere (DefaultMaterial, glm::dmat4 (1.0), 3.0, 20, true);
+	const MeshGeometry& sphereGeometry = sphere.GetGeometry ();
+
+	MeshGeometry geometry;
+	for (unsigned int i = 0; i < sphereGeometry.VertexCount (); i++) {
+		geometry.AddVertex (sphereGeometry.GetVertex (i) + glm::dvec3 (1000.0, -500.0, 20.0));
+	}
+	sphereGeometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		unsigned int n1 = geometry.AddNormal (sphereGeometry.GetNormal (triangle.n1));
+		unsigned int n2 = geometry.AddNormal (sphereGeometry.GetNormal (triangle.n2));
+		unsigned int n3 = geometry.AddNormal (sphereGeometry.GetNormal (triangle.n3));
+		geometry.AddTriangle (triangle.v1, triangle.v2, triangle.v3, n1, n2, n3);
+	});
+
+	MeshGeometry compact = geometry;
+	compact.SetStorage (MeshGeometryStorage::Compact);
+	ASSERT (compact.GetStorage () == MeshGeometryStorage::Compact);
+	ASSERT (compact.VertexCount () == geometry.VertexCount ());
+	ASSERT (compact.NormalCount () == geometry.NormalCount ());
+	ASSERT (compact.GetTriangles () == geometry.GetTriangles ());
+	ASSERT (compact != geometry);
+	ASSERT (compact.CalcMemorySize () * 2 < geometry.CalcMemorySize ());
+	for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+		ASSERT (glm::distance (compact.GetVertex (i), geometry.GetVertex (i)) < 1.0e-5);
+	}
+	for (unsigned int i = 0; i < geometry.NormalCount (); i++) {
+		ASSERT (IsEqual (glm::length (compact.GetNormal (i)), 1.0));
+		ASSERT (glm::distance (compact.GetNormal (i), geometry.GetNormal (i)) < 1.0e-4);
+	}
+	ASSERT (compact.GetTransformedVertices (glm::dmat4 (1.0))[5] == compact.GetVertex (5));
+
+	MeshGeometry decoded = compact;
+	decoded.SetStorage (MeshGeometryStorage::Double);
+	ASSERT (decoded.GetStorage () == MeshGeometryStorage::Double);
+	for (unsigned int i = 0; i < compact.VertexCount (); i++) {
+		ASSERT (decoded.GetVertex (i) == compact.GetVertex (i));
+	}
+	for (unsigned int i = 0; i < compact.NormalCount (); i++) {
+		ASSERT (decoded.GetNormal (i) == compact.GetNormal (i));
+	}
+
+	decoded.SetStorage (MeshGeometryStorage::Compact);
+	ASSERT (decoded == compact);
+	ASSERT (decoded.CalcCheckSum () == compact.CalcCheckSum ());
+}
+
+TEST (CompactStorageModelTest)
+{
+	Model model;
+	ASSERT (model.GetGeometryStorage () == MeshGeometryStorage::Double);
+	model.SetGeometryStorage (MeshGeometryStorage::Compact);
+
+	Mesh mesh1 = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2.0, 3.0);
+	Mesh mesh2 = GenerateBox (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (5.0, 0.0, 0.0)), 1.0, 2.0, 3.0);
+	MeshId meshId1 = model.AddMesh (mesh1);
+	MeshId meshId2 = model.AddMesh (std::move (mesh2));
+	ASSERT (mesh1.GetGeometry ().GetStorage () == MeshGeometryStorage::Double);
+	ASSERT (model.GetInfo ().meshGeometryCount == 1);
+
+	const MeshGeometry& geometry = model.GetMeshGeometry (model.GetMesh (meshId1));
+	ASSERT (&geometry == &model.GetMeshGeometry (model.GetMesh (meshId2)));
+	ASSERT (geometry.GetStorage () == MeshGeometryStorage::Compact);
+	for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+		ASSERT (geometry.GetVertex (i) == mesh1.GetGeometry ().GetVertex (i));
+	}
+	for (unsigned int i = 0; i < geometry.NormalCount (); i++) {
+		ASSERT (geometry.GetNormal (i) == mesh1.GetGeometry ().GetNormal (i));
+	}
+	ASSERT (IsEqualVec (model.GetBoundingBox ().GetMax (), glm::dvec3 (6.0, 2.0, 3.0)));
+}
+
+TEST (SharedDataCollisionTest)
+{
+	SharedData<int, Material> sharedData;
+
+	Checksum checksum;
+	checksum.Add (42);
+
+	int id1 = sharedData.AddReference (Material (glm::dvec3 (1.0, 0.0, 0.0)), checksum);
+	int id2 = sharedData.AddReference (Material (glm::dvec3 (0.0, 1.0, 0.0)), checksum);
+	int id3 = sharedData.AddReference (Material (glm::dvec3 (1.0, 0.0, 0.0)), checksum);
+	ASSERT (id1 != id2);
+	ASSERT (id1 == id3);
+	ASSERT (sharedData.DataCount () == 2);
+	ASSERT (sharedData.GetData (id2).GetColor () == glm::dvec3 (0.0, 1.0, 0.0));
+
+	sharedData.RemoveReference (id1);
+	sharedData.RemoveReference (id3);
+	ASSERT (sharedData.DataCount () == 1);
+
+	int id4 = sharedData.AddReference (Material (glm::dvec3 (0.0, 1.0, 0.0)), checksum);
+	ASSERT (id4 == id2);
+	ASSERT (sharedData.DataCount () == 1);
+}
+
+TEST (ReleasedDataTest)
+{
+	Model model;
+
+	Mesh mesh = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	MeshId meshId1 = model.AddMesh (mesh);
+	MeshGeometryId geometryId1 = model.GetMesh (meshId1).GetGeometryId ();
+	MeshMaterialsId materialsId1 = model.GetMesh (meshId1).GetMaterialsId ();
+	model.RemoveMesh (meshId1);
+	ASSERT (model.GetInfo ().meshGeometryCount == 0);
+	ASSERT (model.GetInfo ().meshMaterialsCount == 0);
+
+	MeshId meshId2 = model.AddMesh (mesh);
+	ASSERT (meshId1 != meshId2);
+	ASSERT (model.GetMesh (meshId2).GetGeometryId () == geometryId1);
+	ASSERT (model.GetMesh (meshId2).GetMaterialsId () == materialsId1);
+	ASSERT (model.GetInfo ().meshGeometryCount == 1);
+	ASSERT (model.GetInfo ().meshMaterialsCount == 1);
+}
+
+TEST (ReleasedDataLimitTest)
+{
+	SharedData<int, Material> sharedData (2, 1024);
+	Material material1 (glm::dvec3 (1.0, 0.0, 0.0));
+	Material material2 (glm::dvec3 (0.0, 1.0, 0.0));
+	Material material3 (glm::dvec3 (0.0, 0.0, 1.0));
+
+	int id1 = sharedData.AddReference (material1, material1.CalcCheckSum ());
+	int id2 = sharedData.AddReference (material2, material2.CalcCheckSum ());
+	int id3 = sharedData.AddReference (material3, material3.CalcCheckSum ());
+	sharedData.RemoveReference (id1);
+	sharedData.RemoveReference (id2);
+	ASSERT (sharedData.DataCount () == 1);
+	ASSERT (sharedData.ReleasedDataCount () == 2);
+
+	ASSERT (sharedData.AddReference (material1, material1.CalcCheckSum ()) == id1);
+	ASSERT (sharedData.ReleasedDataCount () == 1);
+	sharedData.RemoveReference (id1);
+	sharedData.RemoveReference (id3);
+	ASSERT (sharedData.DataCount () == 0);
+	ASSERT (sharedData.ReleasedDataCount () == 2);
+
+	ASSERT (sharedData.AddReference (material2, material2.CalcCheckSum ()) != id2);
+	ASSERT (sharedData.AddReference (material1, material1.CalcCheckSum ()) == id1);
+	ASSERT (sharedData.AddReference (material3, material3.CalcCheckSum ()) == id3);
+	ASSERT (sharedData.ReleasedDataCount () == 0);
+
+	SharedData<int, Material> emptyPool (0, 0);
+	int id4 = emptyPool.AddReference (material1, material1.CalcCheckSum ());
+	emptyPool.RemoveReference (id4);
+	ASSERT (emptyPool.ReleasedDataCount () == 0);
+	ASSERT (emptyPool.AddReference (material1, material1.CalcCheckSum ()) != id4);
+}
+
 TEST (EmptyBoundingShapeTest)
 {
 	Model model;
@@ -104,4 +418,54 @@ TEST (BoundingShapeTest)
 	ASSERT (IsEqual (boundingSphere.GetRadius (), sqrt (1.0 * 1.0 + 1.0 * 1.0 + 3.0 * 3.0) / 2.0));
 }
 
+TEST (IncrementalBoundingShapeTest)
+{
+	Model model;
+	MeshId meshId1 = model.AddMesh (GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0));
+	MeshId meshId2 = model.AddMesh (GenerateBox (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (4.0, 0.0, 0.0)), 1.0, 1.0, 1.0));
+	MeshId meshId3 = model.AddMesh (GenerateBox (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (2.0, 0.0, 0.0)), 1.0, 0.5, 0.5));
+
+	{
+		BoundingBox boundingBox = model.GetBoundingBox ();
+		ASSERT (IsEqualVec (boundingBox.GetMin (), glm::dvec3 (0.0, 0.0, 0.0)));
+		ASSERT (IsEqualVec (boundingBox.GetMax (), glm::dvec3 (5.0, 1.0, 1.0)));
+		ModelInfo modelInfo = model.GetInfo ();
+		ASSERT (modelInfo.vertexCount == 3 * 8);
+		ASSERT (modelInfo.triangleCount == 3 * 12);
+	}
+
+	model.RemoveMesh (meshId3);
+	{
+		BoundingBox boundingBox = model.GetBoundingBox ();
+		ASSERT (IsEqualVec (boundingBox.GetMin (), glm::dvec3 (0.0, 0.0, 0.0)));
+		ASSERT (IsEqualVec (boundingBox.GetMax (), glm::dvec3 (5.0, 1.0, 1.0)));
+		ModelInfo modelInfo = model.GetInfo ();
+		ASSERT (modelInfo.vertexCount == 2 * 8);
+		ASSERT (modelInfo.triangleCount == 2 * 12);
+	}
+
+	model.RemoveMesh (meshId2);
+	{
+		BoundingBox boundingBox = model.GetBoundingBox ();
+		ASSERT (IsEqualVec (boundingBox.GetMin (), glm::dvec3 (0.0, 0.0, 0.0)));
+		ASSERT (IsEqualVec (boundingBox.GetMax (), glm::dvec3 (1.0, 1.0, 1.0)));
+	}
+
+	model.AddMesh (GenerateBox (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (-2.0, 0.0, 0.0)), 1.0, 1.0, 1.0));
+	{
+		BoundingBox boundingBox = model.GetBoundingBox ();
+		ASSERT (IsEqualVec (boundingBox.GetMin (), glm::dvec3 (-2.0, 0.0, 0.0)));
+		ASSERT (IsEqualVec (boundingBox.GetMax (), glm::dvec3 (1.0, 1.0, 1.0)));
+	}
+
+	model.RemoveMesh (meshId1);
+	model.Clear ();
+	{
+		ASSERT (!model.GetBoundingBox ().IsValid ());
+		ModelInfo modelInfo = model.GetInfo ();
+		ASSERT (modelInfo.vertexCount == 0);
+		ASSERT (modelInfo.triangleCount == 0);
+	}
+}
+
 }
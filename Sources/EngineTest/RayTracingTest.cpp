@@ -5,6 +5,12 @@
 #include "RayTracing.hpp"
 #include "Model.hpp"
 #include "MeshGenerators.hpp"
+#include "MeshBVH.hpp"
+#include "InstanceBVH.hpp"
+#include "Frustum.hpp"
+
+#include <algorithm>
+#include <limits>
 
 using namespace Geometry;
 using namespace Modeler;
@@ -12,6 +18,59 @@ using namespace Modeler;
 namespace RayTracingTest
 {
 
+static std::vector<RayModelIntersection> GetRayModelIntersectionsBruteForce (const Model& model, const Ray& ray)
+{
+	std::vector<RayModelIntersection> intersections;
+	model.EnumerateMeshes ([&] (MeshId meshId, const MeshRef& meshRef) {
+		const MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
+		std::vector<glm::dvec3> vertices = geometry.GetTransformedVertices (meshRef.GetTransformation ());
+		for (unsigned int triangleIndex = 0; triangleIndex < geometry.TriangleCount (); triangleIndex++) {
+			const MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+			RayIntersectionResult result = GetRayTriangleIntersection (ray, vertices[triangle.v1], vertices[triangle.v2], vertices[triangle.v3]);
+			if (result.found) {
+				intersections.push_back (RayModelIntersection (meshId, triangleIndex, result.intersection));
+			}
+		}
+	});
+	return intersections;
+}
+
+static bool IsEqualIntersectionSet (std::vector<RayModelIntersection> a, std::vector<RayModelIntersection> b)
+{
+	auto Compare = [] (const RayModelIntersection& x, const RayModelIntersection& y) {
+		return x.meshId < y.meshId || (x.meshId == y.meshId && x.triangleIndex < y.triangleIndex);
+	};
+	std::sort (a.begin (), a.end (), Compare);
+	std::sort (b.begin (), b.end (), Compare);
+	if (a.size () != b.size ()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size (); i++) {
+		if (a[i].meshId != b[i].meshId || a[i].triangleIndex != b[i].triangleIndex || a[i].intersection.distance != b[i].intersection.distance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static std::vector<MeshId> GetFrustumModelMeshesBruteForce (const Model& model, const Frustum& frustum)
+{
+	std::vector<MeshId> meshIds;
+	model.EnumerateMeshes ([&] (MeshId meshId, const MeshRef& meshRef) {
+		const MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
+		std::vector<glm::dvec3> vertices = geometry.GetTransformedVertices (meshRef.GetTransformation ());
+		for (unsigned int triangleIndex = 0; triangleIndex < geometry.TriangleCount (); triangleIndex++) {
+			const MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+			if (frustum.HasTriangleIntersection (vertices[triangle.v1], vertices[triangle.v2], vertices[triangle.v3])) {
+				meshIds.push_back (meshId);
+				break;
+			}
+		}
+	});
+	std::sort (meshIds.begin (), meshIds.end ());
+	return meshIds;
+}
+
 TEST (RayTriangleIntersectionTest)
 {
 	glm::dvec3 v1 (0.0, 0.0, 0.0);
@@ -221,4 +280,334 @@ TEST (RayModelIntersectionTest)
 	}
 }
 
+TEST (MeshBVHTest)
+{
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 30, true);
+	MeshBVH bvh (sphere.GetGeometry ());
+	ASSERT (!bvh.IsEmpty ());
+	ASSERT (bvh.MaxDepth () <= 64);
+	ASSERT (bvh.NodeCount () < 2 * sphere.GetGeometry ().TriangleCount ());
+
+	unsigned int candidateCount = 0;
+	bvh.EnumerateRayTriangles (Ray (glm::dvec3 (-5.0, 0.01, 0.02), glm::dvec3 (2.0, 0.0, 0.0)), [&] (unsigned int) {
+		candidateCount++;
+	});
+	ASSERT (candidateCount > 0 && candidateCount < 100);
+
+	MeshGeometry emptyGeometry;
+	MeshBVH emptyBVH (emptyGeometry);
+	ASSERT (emptyBVH.IsEmpty ());
+	emptyBVH.EnumerateRayTriangles (Ray (glm::dvec3 (0.0), glm::dvec3 (1.0, 0.0, 0.0)), [&] (unsigned int) {
+		ASSERT (false);
+	});
+}
+
+TEST (RayModelIntersectionBVHTest)
+{
+	Model model;
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 12, true);
+	Mesh box = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 2.0, 3.0);
+	for (int i = 0; i < 4; i++) {
+		glm::dmat4 transformation = glm::translate (glm::dmat4 (1.0), glm::dvec3 (i * 1.5, 0.0, 0.0));
+		transformation = glm::rotate (transformation, i * 0.7, glm::dvec3 (1.0, 1.0, 0.0));
+		transformation = glm::scale (transformation, glm::dvec3 (1.0 + i * 0.5, 1.0, (i == 3) ? -1.0 : 1.0));
+		sphere.SetTransformation (transformation);
+		box.SetTransformation (glm::translate (transformation, glm::dvec3 (0.0, 3.0, 0.0)));
+		model.AddMesh (sphere);
+		model.AddMesh (box);
+	}
+	ASSERT (model.GetInfo ().meshGeometryCount == 2);
+
+	unsigned int random = 1;
+	auto GetRandom = [&] () {
+		random = random * 1103515245u + 12345u;
+		return ((random >> 8) & 0xffff) / 65535.0;
+	};
+	unsigned int hitCount = 0;
+	for (int i = 0; i < 300; i++) {
+		glm::dvec3 origin (-5.0 + 15.0 * GetRandom (), -5.0 + 15.0 * GetRandom (), -8.0 + 16.0 * GetRandom ());
+		glm::dvec3 target (6.0 * GetRandom (), 4.0 * GetRandom (), -1.0 + 2.0 * GetRandom ());
+		Ray ray (origin, (target - origin) * 3.0);
+		std::vector<RayModelIntersection> intersections = GetRayModelRayIntersections (model, ray);
+		ASSERT (IsEqualIntersectionSet (intersections, GetRayModelIntersectionsBruteForce (model, ray)));
+		for (size_t j = 1; j < intersections.size (); j++) {
+			ASSERT (intersections[j - 1].intersection.distance <= intersections[j].intersection.distance);
+		}
+		hitCount += intersections.empty () ? 0 : 1;
+	}
+	ASSERT (hitCount > 100);
+}
+
+TEST (InstanceBVHTest)
+{
+	InstanceBVH instanceBVH;
+	std::vector<Geometry::BoundingBox> boxes;
+	for (int i = 0; i < 500; i++) {
+		Geometry::BoundingBox box;
+		box.AddPoint (glm::dvec3 (i * 2.0, (i % 7) * 0.5, 0.0));
+		box.AddPoint (glm::dvec3 (i * 2.0 + 1.0, (i % 7) * 0.5 + 1.0, 1.0));
+		boxes.push_back (box);
+		instanceBVH.AddInstance (i, box);
+		ASSERT (!instanceBVH.IsUpToDate ());
+		instanceBVH.Update ();
+		ASSERT (instanceBVH.IsUpToDate ());
+	}
+	ASSERT (instanceBVH.InstanceCount () == 500);
+	ASSERT (instanceBVH.Height () <= 64);
+
+	for (int i = 0; i < 500; i += 2) {
+		instanceBVH.RemoveInstance (i);
+	}
+	ASSERT (instanceBVH.IsUpToDate ());
+	ASSERT (instanceBVH.InstanceCount () == 250);
+
+	for (int i = 0; i < 100; i++) {
+		Ray ray (glm::dvec3 (i * 10.0 + 0.3, -5.0, 0.5), glm::dvec3 (0.1 * (i % 3), 1.0, 0.0));
+		std::vector<int> instances;
+		instanceBVH.EnumerateRayInstances (ray, [&] (int instanceId) {
+			instances.push_back (instanceId);
+		});
+		for (int j = 1; j < 500; j += 2) {
+			if (HasRayBoundingBoxIntersection (ray, boxes[j])) {
+				ASSERT (std::find (instances.begin (), instances.end (), j) != instances.end ());
+			}
+		}
+		for (int instanceId : instances) {
+			ASSERT (instanceId % 2 == 1);
+		}
+	}
+
+	instanceBVH.AddInstance (0, boxes[0]);
+	ASSERT (!instanceBVH.IsUpToDate ());
+	instanceBVH.RemoveInstance (0);
+	ASSERT (instanceBVH.IsUpToDate ());
+	instanceBVH.Clear ();
+	ASSERT (instanceBVH.InstanceCount () == 0);
+}
+
+TEST (RayModelInstancesTest)
+{
+	Model model;
+	Mesh box = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0);
+	std::vector<MeshId> meshIds;
+	for (int i = 0; i < 40; i++) {
+		for (int j = 0; j < 40; j++) {
+			box.SetTransformation (glm::rotate (glm::translate (glm::dmat4 (1.0), glm::dvec3 (i * 2.0, j * 2.0, 0.0)), (i + j) * 0.1, glm::dvec3 (0.0, 0.0, 1.0)));
+			meshIds.push_back (model.AddMesh (box));
+		}
+	}
+	model.AddMesh (Mesh ());
+	ASSERT (model.GetInfo ().meshGeometryCount == 2);
+
+	auto CheckRays = [&] () {
+		for (int i = 0; i < 50; i++) {
+			Ray ray (glm::dvec3 (-3.0, i * 1.7 - 5.0, 0.5), glm::dvec3 (1.0, 0.05 * (i % 5) + 0.01, 0.02 * (i % 3) - 0.02));
+			ASSERT (IsEqualIntersectionSet (GetRayModelRayIntersections (model, ray), GetRayModelIntersectionsBruteForce (model, ray)));
+		}
+		Ray downRay (glm::dvec3 (0.3, 0.6, 5.0), glm::dvec3 (0.0, 0.0, -1.0));
+		return GetRayModelRayIntersections (model, downRay);
+	};
+
+	std::vector<RayModelIntersection> intersections = CheckRays ();
+	ASSERT (intersections.size () == 1);
+	ASSERT (intersections[0].meshId == meshIds[0]);
+
+	for (size_t i = 0; i < meshIds.size (); i += 3) {
+		model.RemoveMesh (meshIds[i]);
+	}
+	box.SetTransformation (glm::translate (glm::dmat4 (1.0), glm::dvec3 (0.0, 0.0, 2.0)));
+	MeshId topMeshId = model.AddMesh (box);
+	intersections = CheckRays ();
+	ASSERT (intersections.size () == 1);
+	ASSERT (intersections[0].meshId == topMeshId);
+}
+
+TEST (RayModelFirstIntersectionTest)
+{
+	Model model;
+	ASSERT (!GetRayModelFirstIntersection (model, Ray (glm::dvec3 (-2.0, 0.5, 0.5), glm::dvec3 (1.0, 0.0, 0.0))).found);
+
+	model.AddMesh (GenerateBox (DefaultMaterial, glm::translate (glm::dmat4 (1.0), glm::dvec3 (2.0, 0.0, 0.0)), 1.0, 1.0, 1.0));
+	model.AddMesh (GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.0, 1.0));
+	Ray diagonalRay (glm::dvec3 (-2.0, 0.5, 0.5), glm::dvec3 (1.0, 0.0, 0.0));
+	RayModelIntersectionResult result = GetRayModelFirstIntersection (model, diagonalRay);
+	ASSERT (result.found);
+	ASSERT (result.intersection.meshId == 1);
+	ASSERT (result.intersection.triangleIndex == 10);
+	ASSERT (IsEqual (result.intersection.intersection.distance, 2.0));
+	ASSERT (HasRayModelIntersection (model, diagonalRay, 2.5));
+	ASSERT (!HasRayModelIntersection (model, diagonalRay, 1.5));
+
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 6, true);
+	for (int i = 0; i < 30; i++) {
+		sphere.SetTransformation (glm::scale (glm::translate (glm::dmat4 (1.0), glm::dvec3 ((i % 6) * 1.2, (i / 6) * 1.3, (i % 4) * 0.4)), glm::dvec3 (0.5 + (i % 3) * 0.2)));
+		model.AddMesh (sphere);
+	}
+	unsigned int hitCount = 0;
+	for (int i = 0; i < 200; i++) {
+		glm::dvec3 origin (-4.0 + (i % 13), -4.0 + (i % 7) * 2.0, -6.0 + (i % 5) * 3.0);
+		glm::dvec3 target ((i % 11) * 0.6, (i % 9) * 0.7, (i % 3) * 0.5);
+		Ray ray (origin, target - origin);
+		std::vector<RayModelIntersection> intersections = GetRayModelRayIntersections (model, ray);
+		RayModelIntersectionResult first = GetRayModelFirstIntersection (model, ray);
+		ASSERT (first.found == !intersections.empty ());
+		ASSERT (HasRayModelIntersection (model, ray, std::numeric_limits<double>::max ()) == !intersections.empty ());
+		if (intersections.empty ()) {
+			continue;
+		}
+		hitCount++;
+		ASSERT (first.intersection.meshId == intersections[0].meshId);
+		ASSERT (first.intersection.triangleIndex == intersections[0].triangleIndex);
+		ASSERT (first.intersection.intersection.distance == intersections[0].intersection.distance);
+		double firstDistance = intersections[0].intersection.distance;
+		ASSERT (HasRayModelIntersection (model, ray, firstDistance));
+		ASSERT (!HasRayModelIntersection (model, ray, firstDistance * 0.99));
+	}
+	ASSERT (hitCount > 50);
+}
+
+TEST (ScreenRayGridTest)
+{
+	Camera camera (glm::dvec3 (5.0, -4.0, 3.0), glm::dvec3 (0.0, 0.0, 0.0), glm::dvec3 (0.0, 0.0, 1.0), 45.0, 0.1, 10000.0);
+	glm::dvec2 screenSize (200.0, 100.0);
+	std::vector<Ray> rays = GetScreenRayGrid (camera, screenSize, glm::dvec2 (20.0, 10.0), glm::dvec2 (60.0, 40.0), 4, 3);
+	ASSERT (rays.size () == 12);
+	for (unsigned int row = 0; row < 3; row++) {
+		for (unsigned int column = 0; column < 4; column++) {
+			Ray expected = GetScreenRay (camera, screenSize, glm::dvec2 (25.0 + column * 10.0, 15.0 + row * 10.0));
+			const Ray& ray = rays[row * 4 + column];
+			ASSERT (IsEqualVec (ray.GetOrigin (), expected.GetOrigin ()));
+			ASSERT (IsEqualVec (ray.GetDirection (), expected.GetDirection ()));
+		}
+	}
+}
+
+TEST (RayPacketFirstIntersectionsTest)
+{
+	Model model;
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 5, true);
+	Mesh box = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.5, 0.8);
+	for (int i = 0; i < 12; i++) {
+		glm::dmat4 transformation = glm::translate (glm::dmat4 (1.0), glm::dvec3 ((i % 4) * 1.7 - 3.0, (i / 4) * 1.9 - 2.0, (i % 3) * 0.6));
+		if (i % 5 == 2) {
+			transformation = glm::scale (transformation, glm::dvec3 (-1.0, 1.0, 1.0));
+		}
+		sphere.SetTransformation (transformation);
+		box.SetTransformation (glm::translate (transformation, glm::dvec3 (0.4, 0.4, -1.5)));
+		model.AddMesh (sphere);
+		model.AddMesh (box);
+	}
+
+	Camera camera (glm::dvec3 (8.0, -9.0, 7.0), glm::dvec3 (0.0, 0.0, 0.0), glm::dvec3 (0.0, 0.0, 1.0), 45.0, 0.1, 10000.0);
+	glm::dvec2 screenSize (400.0, 300.0);
+	std::vector<Ray> rays = GetScreenRayGrid (camera, screenSize, glm::dvec2 (0.0, 0.0), screenSize, 37, 23);
+	std::vector<RayModelIntersectionResult> results = GetRayModelFirstIntersections (model, rays);
+	ASSERT (results.size () == rays.size ());
+
+	unsigned int hitCount = 0;
+	for (size_t i = 0; i < rays.size (); i++) {
+		RayModelIntersectionResult expected = GetRayModelFirstIntersection (model, rays[i]);
+		ASSERT (results[i].found == expected.found);
+		if (!expected.found) {
+			continue;
+		}
+		hitCount++;
+		ASSERT (results[i].intersection.meshId == expected.intersection.meshId);
+		ASSERT (results[i].intersection.triangleIndex == expected.intersection.triangleIndex);
+		ASSERT (IsEqual (results[i].intersection.intersection.distance, expected.intersection.intersection.distance));
+		ASSERT (IsEqualVec (results[i].intersection.intersection.position, expected.intersection.intersection.position));
+	}
+	ASSERT (hitCount > 100);
+}
+
+TEST (FrustumTest)
+{
+	Frustum frustum ({
+		glm::dvec3 (0.0, 0.0, 0.0), glm::dvec3 (1.0, 0.0, 0.0), glm::dvec3 (1.0, 1.0, 0.0), glm::dvec3 (0.0, 1.0, 0.0),
+		glm::dvec3 (-1.0, -1.0, 2.0), glm::dvec3 (2.0, -1.0, 2.0), glm::dvec3 (2.0, 2.0, 2.0), glm::dvec3 (-1.0, 2.0, 2.0)
+	});
+	ASSERT (frustum.IsPointInside (glm::dvec3 (0.5, 0.5, 1.0)));
+	ASSERT (frustum.IsPointInside (glm::dvec3 (1.4, 1.4, 1.9)));
+	ASSERT (!frustum.IsPointInside (glm::dvec3 (1.4, 1.4, 0.1)));
+	ASSERT (!frustum.IsPointInside (glm::dvec3 (0.5, 0.5, 2.1)));
+
+	ASSERT (frustum.GetBoxRelation (glm::dvec3 (0.2, 0.2, 0.5), glm::dvec3 (0.8, 0.8, 1.5)) == FrustumBoxRelation::Inside);
+	ASSERT (frustum.GetBoxRelation (glm::dvec3 (0.5, 0.5, 1.5), glm::dvec3 (3.0, 3.0, 3.0)) == FrustumBoxRelation::Intersecting);
+	ASSERT (frustum.GetBoxRelation (glm::dvec3 (3.0, 0.0, 0.0), glm::dvec3 (4.0, 1.0, 1.0)) == FrustumBoxRelation::Outside);
+	ASSERT (frustum.GetBoxRelation (glm::dvec3 (0.0, 0.0, -2.0), glm::dvec3 (1.0, 1.0, -1.0)) == FrustumBoxRelation::Outside);
+
+	ASSERT (frustum.HasTriangleIntersection (glm::dvec3 (0.5, 0.5, 1.0), glm::dvec3 (5.0, 0.0, 1.0), glm::dvec3 (5.0, 1.0, 1.0)));
+	ASSERT (frustum.HasTriangleIntersection (glm::dvec3 (-5.0, 0.5, 1.0), glm::dvec3 (5.0, 0.5, 1.0), glm::dvec3 (0.5, 0.5, 10.0)));
+	ASSERT (frustum.HasTriangleIntersection (glm::dvec3 (-5.0, -5.0, 1.0), glm::dvec3 (5.0, -5.0, 1.0), glm::dvec3 (0.0, 5.0, 1.0)));
+	ASSERT (!frustum.HasTriangleIntersection (glm::dvec3 (3.0, 0.0, 1.0), glm::dvec3 (4.0, 0.0, 1.0), glm::dvec3 (3.0, 1.0, 1.0)));
+	ASSERT (!frustum.HasTriangleIntersection (glm::dvec3 (-5.0, -5.0, 3.0), glm::dvec3 (5.0, -5.0, 3.0), glm::dvec3 (0.0, 5.0, 3.0)));
+
+	// no plane of the frustum separates this triangle, only the cross product of edges
+	glm::dvec3 v1 (1.6, 0.9, 0.25);
+	glm::dvec3 v2 (0.9, 1.6, 0.25);
+	glm::dvec3 v3 (1.5, 1.5, 0.3);
+	ASSERT (frustum.GetBoxRelation (glm::min (glm::min (v1, v2), v3), glm::max (glm::max (v1, v2), v3)) != FrustumBoxRelation::Outside);
+	ASSERT (!frustum.HasTriangleIntersection (v1, v2, v3));
+
+	glm::dmat4 transformation = glm::rotate (glm::translate (glm::dmat4 (1.0), glm::dvec3 (10.0, 0.0, 0.0)), glm::radians (90.0), glm::dvec3 (0.0, 0.0, 1.0));
+	Frustum transformed = frustum.Transform (transformation);
+	ASSERT (transformed.IsPointInside (glm::dvec3 (transformation * glm::dvec4 (0.5, 0.5, 1.0, 1.0))));
+	ASSERT (!transformed.IsPointInside (glm::dvec3 (0.5, 0.5, 1.0)));
+}
+
+TEST (FrustumModelMeshesTest)
+{
+	Model model;
+	Mesh sphere = GenerateIcosphere (DefaultMaterial, glm::dmat4 (1.0), 1.0, 3, true);
+	Mesh box = GenerateBox (DefaultMaterial, glm::dmat4 (1.0), 1.0, 1.5, 0.8);
+	for (int i = 0; i < 40; i++) {
+		glm::dmat4 transformation = glm::translate (glm::dmat4 (1.0), glm::dvec3 ((i % 8) * 2.1 - 8.0, (i / 8) * 2.3 - 5.0, (i % 3) * 0.7));
+		transformation = glm::rotate (transformation, i * 0.4, glm::dvec3 (0.3, 0.5, 1.0));
+		if (i % 5 == 2) {
+			transformation = glm::scale (transformation, glm::dvec3 (-1.0, 0.6, 1.3));
+		}
+		if (i % 2 == 0) {
+			sphere.SetTransformation (transformation);
+			model.AddMesh (sphere);
+		} else {
+			box.SetTransformation (transformation);
+			model.AddMesh (box);
+		}
+	}
+
+	Camera camera (glm::dvec3 (6.0, -14.0, 9.0), glm::dvec3 (0.0, 0.0, 0.0), glm::dvec3 (0.0, 0.0, 1.0), 45.0, 0.1, 10000.0);
+	glm::dvec2 screenSize (400.0, 300.0);
+	const glm::dvec2 rects[][2] = {
+		{ glm::dvec2 (0.0, 0.0), screenSize },
+		{ glm::dvec2 (120.0, 80.0), glm::dvec2 (260.0, 190.0) },
+		{ glm::dvec2 (300.0, 250.0), glm::dvec2 (180.0, 140.0) },
+		{ glm::dvec2 (10.0, 130.0), glm::dvec2 (390.0, 136.0) },
+		{ glm::dvec2 (197.0, 12.0), glm::dvec2 (201.0, 290.0) },
+		{ glm::dvec2 (-50.0, -50.0), glm::dvec2 (-10.0, -10.0) }
+	};
+	for (const auto& rect : rects) {
+		Frustum frustum = GetScreenFrustum (camera, screenSize, rect[0], rect[1]);
+		std::vector<MeshId> meshIds = GetFrustumModelMeshes (model, frustum);
+		ASSERT (meshIds == GetFrustumModelMeshesBruteForce (model, frustum));
+	}
+	ASSERT (GetFrustumModelMeshes (model, GetScreenFrustum (camera, screenSize, glm::dvec2 (0.0, 0.0), screenSize)).size () == 40);
+	ASSERT (GetFrustumModelMeshes (model, GetScreenFrustum (camera, screenSize, glm::dvec2 (-50.0, -50.0), glm::dvec2 (-10.0, -10.0))).empty ());
+
+	// a click selects at least the mesh hit by the ray of the pixel
+	unsigned int hitCount = 0;
+	for (double x = 5.0; x < screenSize.x; x += 30.0) {
+		for (double y = 5.0; y < screenSize.y; y += 30.0) {
+			glm::dvec2 screenPos (x, y);
+			RayModelIntersectionResult result = GetRayModelFirstIntersection (model, GetScreenRay (camera, screenSize, screenPos));
+			if (!result.found) {
+				continue;
+			}
+			hitCount++;
+			std::vector<MeshId> meshIds = GetFrustumModelMeshes (model, GetScreenFrustum (camera, screenSize, screenPos, screenPos));
+			ASSERT (std::find (meshIds.begin (), meshIds.end (), result.intersection.meshId) != meshIds.end ());
+		}
+	}
+	ASSERT (hitCount > 10);
+}
+
 }
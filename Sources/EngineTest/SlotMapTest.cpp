@@ -0,0 +1,95 @@
+#include "SimpleTest.hpp"
+#include "SlotMap.hpp"
+
+#include <vector>
+#include <algorithm>
+
+using namespace Modeler;
+
+namespace SlotMapTest
+{
+
+static std::vector<int> GetValues (const SlotMap<int, int>& slotMap)
+{
+	std::vector<int> result;
+	slotMap.Enumerate ([&] (int id, int value) {
+		result.push_back (slotMap.Get (id) == value ? value : -1);
+	});
+	return result;
+}
+
+TEST (SlotMapInsertTest)
+{
+	SlotMap<int, int> slotMap;
+	int id1 = slotMap.Insert (10);
+	int id2 = slotMap.Insert (20);
+	int id3 = slotMap.Insert (30);
+	ASSERT (slotMap.Count () == 3);
+	ASSERT (slotMap.Get (id1) == 10);
+	ASSERT (slotMap.Get (id2) == 20);
+	ASSERT (slotMap.Get (id3) == 30);
+	ASSERT (GetValues (slotMap) == std::vector<int> ({ 10, 20, 30 }));
+
+	slotMap.Get (id2) = 25;
+	ASSERT (slotMap.Get (id2) == 25);
+}
+
+TEST (SlotMapEraseTest)
+{
+	SlotMap<int, int> slotMap;
+	int id1 = slotMap.Insert (10);
+	int id2 = slotMap.Insert (20);
+	int id3 = slotMap.Insert (30);
+
+	slotMap.Erase (id1);
+	ASSERT (slotMap.Count () == 2);
+	ASSERT (!slotMap.Contains (id1));
+	ASSERT (slotMap.Contains (id2));
+	ASSERT (slotMap.Contains (id3));
+	ASSERT (slotMap.Get (id2) == 20);
+	ASSERT (slotMap.Get (id3) == 30);
+	ASSERT (GetValues (slotMap) == std::vector<int> ({ 30, 20 }));
+
+	bool thrown = false;
+	try {
+		slotMap.Get (id1);
+	} catch (const std::out_of_range&) {
+		thrown = true;
+	}
+	ASSERT (thrown);
+}
+
+TEST (SlotMapReuseTest)
+{
+	SlotMap<int, int> slotMap;
+	int id1 = slotMap.Insert (10);
+	slotMap.Erase (id1);
+	int id2 = slotMap.Insert (20);
+	ASSERT (id1 != id2);
+	ASSERT (!slotMap.Contains (id1));
+	ASSERT (slotMap.Get (id2) == 20);
+	ASSERT (slotMap.Count () == 1);
+
+	std::vector<int> ids;
+	for (int i = 0; i < 1000; i++) {
+		int id = slotMap.Insert (i);
+		slotMap.Erase (id);
+		ASSERT (std::find (ids.begin (), ids.end (), id) == ids.end ());
+		ids.push_back (id);
+	}
+	ASSERT (slotMap.Count () == 1);
+	ASSERT (slotMap.Get (id2) == 20);
+}
+
+TEST (SlotMapClearTest)
+{
+	SlotMap<int, int> slotMap;
+	int id1 = slotMap.Insert (10);
+	slotMap.Insert (20);
+	slotMap.Clear ();
+	ASSERT (slotMap.Count () == 0);
+	ASSERT (!slotMap.Contains (id1));
+	ASSERT (!slotMap.Contains (-1));
+}
+
+}
@@ -0,0 +1,84 @@
+#include "SimpleTest.hpp"
+#include "Geometry.hpp"
+#include "Transformation.hpp"
+#include "TestUtils.hpp"
+
+using namespace Geometry;
+
+namespace TransformationTest
+{
+
+static glm::dmat4 GetTestTransformation ()
+{
+	glm::dmat4 transformation (1.0);
+	transformation = glm::translate (transformation, glm::dvec3 (1.0, -2.0, 3.5));
+	transformation = glm::rotate (transformation, 0.7, glm::normalize (glm::dvec3 (1.0, 2.0, 3.0)));
+	transformation = glm::scale (transformation, glm::dvec3 (2.0, 0.5, 3.0));
+	return transformation;
+}
+
+static std::vector<glm::dvec3> GetTestPoints (size_t count)
+{
+	std::vector<glm::dvec3> points;
+	for (size_t i = 0; i < count; i++) {
+		double t = (double) i;
+		points.push_back (glm::dvec3 (std::sin (t) * 10.0, std::cos (t * 0.3) * 5.0, t * 0.25 - 3.0));
+	}
+	return points;
+}
+
+TEST (TransformPointsTest)
+{
+	glm::dmat4 transformation = GetTestTransformation ();
+	std::vector<glm::dvec3> points = GetTestPoints (1000);
+	std::vector<glm::dvec3> result;
+	TransformPoints (transformation, points, result);
+	ASSERT (result.size () == points.size ());
+	for (size_t i = 0; i < points.size (); i++) {
+		glm::dvec3 expected (transformation * glm::dvec4 (points[i], 1.0));
+		ASSERT (result[i] == expected);
+	}
+}
+
+TEST (TransformNormalsTest)
+{
+	glm::dmat4 transformation = glm::scale (glm::dmat4 (1.0), glm::dvec3 (1.0, 4.0, 1.0));
+	glm::dvec3 normal = glm::normalize (glm::dvec3 (1.0, 1.0, 0.0));
+	glm::dvec3 tangent = glm::normalize (glm::dvec3 (1.0, -1.0, 0.0));
+
+	glm::dvec3 transformedNormal;
+	TransformNormals (transformation, &normal, 1, &transformedNormal);
+	glm::dvec3 transformedTangent = glm::dvec3 (transformation * glm::dvec4 (tangent, 0.0));
+	ASSERT (IsEqual (glm::length (transformedNormal), 1.0));
+	ASSERT (IsZero (glm::dot (transformedNormal, transformedTangent)));
+}
+
+TEST (TransformNormalsRigidTest)
+{
+	glm::dmat4 transformation = glm::rotate (glm::dmat4 (1.0), 0.3, glm::dvec3 (0.0, 0.0, 1.0));
+	transformation = glm::translate (transformation, glm::dvec3 (5.0, 6.0, 7.0));
+	std::vector<glm::dvec3> normals = {
+		glm::dvec3 (1.0, 0.0, 0.0),
+		glm::dvec3 (0.0, 1.0, 0.0),
+		glm::dvec3 (0.0, 0.0, -1.0)
+	};
+	std::vector<glm::dvec3> result;
+	TransformNormals (transformation, normals, result);
+	ASSERT (result.size () == normals.size ());
+	for (size_t i = 0; i < normals.size (); i++) {
+		ASSERT (IsEqualVec (result[i], glm::dmat3 (transformation) * normals[i]));
+	}
+}
+
+TEST (MaxAxisScaleTest)
+{
+	ASSERT (IsEqual (GetMaxAxisScale (glm::dmat4 (1.0)), 1.0));
+	ASSERT (IsEqual (GetMaxAxisScale (glm::translate (glm::dmat4 (1.0), glm::dvec3 (5.0, 6.0, 7.0))), 1.0));
+
+	glm::dmat4 transformation = glm::rotate (glm::dmat4 (1.0), 0.3, glm::dvec3 (1.0, 1.0, 0.0));
+	transformation = glm::scale (transformation, glm::dvec3 (2.0, 100.0, 0.5));
+	ASSERT (IsEqual (GetMaxAxisScale (transformation), 100.0));
+	ASSERT (IsEqual (GetMaxAxisScale (glm::scale (glm::dmat4 (1.0), glm::dvec3 (0.01, 0.02, 0.01))), 0.02));
+}
+
+}
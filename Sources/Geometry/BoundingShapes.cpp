@@ -35,6 +35,16 @@ void BoundingBox::AddPoint (const glm::dvec3& point)
 	max = glm::max (point, max);
 }
 
+void BoundingBox::AddBox (const BoundingBox& box)
+{
+	if (!box.isValid) {
+		return;
+	}
+	isValid = true;
+	min = glm::min (box.min, min);
+	max = glm::max (box.max, max);
+}
+
 const glm::dvec3& BoundingBox::GetMin () const
 {
 	return min;
@@ -15,6 +15,7 @@ public:
 
 	bool				IsValid () const;
 	void				AddPoint (const glm::dvec3& point);
+	void				AddBox (const BoundingBox& box);
 
 	const glm::dvec3&	GetMin () const;
 	const glm::dvec3&	GetMax () const;
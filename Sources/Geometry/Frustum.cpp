@@ -0,0 +1,144 @@
+#include "Frustum.hpp"
+
+#include <algorithm>
+
+namespace Geometry
+{
+
+// cross products shorter than this are the same as parallel directions
+static const double MinAxisLength = 1.0e-12;
+
+Frustum::Frustum (const std::array<glm::dvec3, 8>& corners) :
+	corners (corners),
+	planeNormals (),
+	planeOffsets (),
+	edgeDirections ()
+{
+	glm::dvec3 center (0.0);
+	for (const glm::dvec3& corner : corners) {
+		center += corner;
+	}
+	center /= 8.0;
+
+	// the faces are given by three of their corners, the normals point outwards
+	static const int faceCorners[6][3] = {
+		{ 0, 1, 3 },
+		{ 4, 5, 7 },
+		{ 0, 1, 4 },
+		{ 1, 2, 5 },
+		{ 2, 3, 6 },
+		{ 3, 0, 7 }
+	};
+	for (int i = 0; i < 6; i++) {
+		const glm::dvec3& origin = corners[faceCorners[i][0]];
+		glm::dvec3 normal = glm::normalize (glm::cross (corners[faceCorners[i][1]] - origin, corners[faceCorners[i][2]] - origin));
+		if (glm::dot (normal, center - origin) > 0.0) {
+			normal = -normal;
+		}
+		planeNormals[i] = normal;
+		planeOffsets[i] = glm::dot (normal, origin);
+	}
+
+	edgeDirections[0] = glm::normalize (corners[1] - corners[0]);
+	edgeDirections[1] = glm::normalize (corners[3] - corners[0]);
+	for (int i = 0; i < 4; i++) {
+		edgeDirections[i + 2] = glm::normalize (corners[i + 4] - corners[i]);
+	}
+}
+
+const glm::dvec3& Frustum::GetCorner (size_t index) const
+{
+	return corners[index];
+}
+
+Frustum Frustum::Transform (const glm::dmat4& transformation) const
+{
+	std::array<glm::dvec3, 8> transformedCorners;
+	for (size_t i = 0; i < corners.size (); i++) {
+		transformedCorners[i] = glm::dvec3 (transformation * glm::dvec4 (corners[i], 1.0));
+	}
+	return Frustum (transformedCorners);
+}
+
+bool Frustum::IsPointInside (const glm::dvec3& point) const
+{
+	for (size_t i = 0; i < planeNormals.size (); i++) {
+		if (glm::dot (planeNormals[i], point) > planeOffsets[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+FrustumBoxRelation Frustum::GetBoxRelation (const glm::dvec3& min, const glm::dvec3& max) const
+{
+	bool isInside = true;
+	for (size_t i = 0; i < planeNormals.size (); i++) {
+		const glm::dvec3& normal = planeNormals[i];
+		glm::dvec3 nearestPoint (normal.x > 0.0 ? min.x : max.x, normal.y > 0.0 ? min.y : max.y, normal.z > 0.0 ? min.z : max.z);
+		if (glm::dot (normal, nearestPoint) > planeOffsets[i]) {
+			return FrustumBoxRelation::Outside;
+		}
+		glm::dvec3 farthestPoint (normal.x > 0.0 ? max.x : min.x, normal.y > 0.0 ? max.y : min.y, normal.z > 0.0 ? max.z : min.z);
+		if (glm::dot (normal, farthestPoint) > planeOffsets[i]) {
+			isInside = false;
+		}
+	}
+	return isInside ? FrustumBoxRelation::Inside : FrustumBoxRelation::Intersecting;
+}
+
+bool Frustum::HasTriangleIntersection (const glm::dvec3& v1, const glm::dvec3& v2, const glm::dvec3& v3) const
+{
+	if (IsPointInside (v1) || IsPointInside (v2) || IsPointInside (v3)) {
+		return true;
+	}
+
+	for (size_t i = 0; i < planeNormals.size (); i++) {
+		const glm::dvec3& normal = planeNormals[i];
+		if (glm::dot (normal, v1) > planeOffsets[i] && glm::dot (normal, v2) > planeOffsets[i] && glm::dot (normal, v3) > planeOffsets[i]) {
+			return false;
+		}
+	}
+
+	glm::dvec3 triangleEdges[3] = { v2 - v1, v3 - v2, v1 - v3 };
+	glm::dvec3 triangleNormal = glm::cross (triangleEdges[0], triangleEdges[1]);
+	if (glm::length (triangleNormal) > MinAxisLength && IsSeparatingAxis (triangleNormal, v1, v2, v3)) {
+		return false;
+	}
+
+	for (const glm::dvec3& triangleEdge : triangleEdges) {
+		double edgeLength = glm::length (triangleEdge);
+		if (edgeLength <= 0.0) {
+			continue;
+		}
+		glm::dvec3 triangleEdgeDirection = triangleEdge / edgeLength;
+		for (const glm::dvec3& edgeDirection : edgeDirections) {
+			glm::dvec3 axis = glm::cross (triangleEdgeDirection, edgeDirection);
+			if (glm::length (axis) > MinAxisLength && IsSeparatingAxis (axis, v1, v2, v3)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool Frustum::IsSeparatingAxis (const glm::dvec3& axis, const glm::dvec3& v1, const glm::dvec3& v2, const glm::dvec3& v3) const
+{
+	double frustumMin = glm::dot (axis, corners[0]);
+	double frustumMax = frustumMin;
+	for (size_t i = 1; i < corners.size (); i++) {
+		double projection = glm::dot (axis, corners[i]);
+		frustumMin = std::min (frustumMin, projection);
+		frustumMax = std::max (frustumMax, projection);
+	}
+
+	double projection1 = glm::dot (axis, v1);
+	double projection2 = glm::dot (axis, v2);
+	double projection3 = glm::dot (axis, v3);
+	double triangleMin = std::min (std::min (projection1, projection2), projection3);
+	double triangleMax = std::max (std::max (projection1, projection2), projection3);
+	return triangleMax < frustumMin || triangleMin > frustumMax;
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef GEOMETRY_FRUSTUM_HPP
+#define GEOMETRY_FRUSTUM_HPP
+
+#include "IncludeGLM.hpp"
+
+#include <array>
+
+namespace Geometry
+{
+
+enum class FrustumBoxRelation
+{
+	Outside,
+	Intersecting,
+	Inside
+};
+
+// Convex volume given by the corners of its near and far rectangles, the first four corners
+// are the near rectangle, and the next four are the matching far corners. The box test uses
+// only the planes, so boxes near the edges may be reported as intersecting, the triangle test
+// is exact by the separating axis theorem.
+
+class Frustum
+{
+public:
+	Frustum (const std::array<glm::dvec3, 8>& corners);
+
+	const glm::dvec3&	GetCorner (size_t index) const;
+	Frustum				Transform (const glm::dmat4& transformation) const;
+
+	bool				IsPointInside (const glm::dvec3& point) const;
+	FrustumBoxRelation	GetBoxRelation (const glm::dvec3& min, const glm::dvec3& max) const;
+	bool				HasTriangleIntersection (const glm::dvec3& v1, const glm::dvec3& v2, const glm::dvec3& v3) const;
+
+private:
+	bool				IsSeparatingAxis (const glm::dvec3& axis, const glm::dvec3& v1, const glm::dvec3& v2, const glm::dvec3& v3) const;
+
+	std::array<glm::dvec3, 8>	corners;
+	std::array<glm::dvec3, 6>	planeNormals;
+	std::array<double, 6>		planeOffsets;
+	std::array<glm::dvec3, 6>	edgeDirections;
+};
+
+}
+
+#endif
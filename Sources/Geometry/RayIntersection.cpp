@@ -129,7 +129,7 @@ RayIntersectionResult GetRayBoundingBoxIntersection (const Geometry::Ray& ray, c
 	}
 
 	glm::dvec3 coord (0.0);
-	for (int i = 1; i < 3; i++) {
+	for (int i = 0; i < 3; i++) {
 		if (whichPlane != i) {
 			coord[i] = origin[i] + maxT[whichPlane] * dir[i];
 			if (coord[i] < minB[i] || coord[i] > maxB[i]) {
@@ -0,0 +1,143 @@
+#include "Transformation.hpp"
+
+#include <algorithm>
+
+#if defined (__AVX__)
+	#include <immintrin.h>
+	#define GEOMETRY_TRANSFORM_AVX
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GEOMETRY_TRANSFORM_SSE2
+#endif
+
+static_assert (sizeof (glm::dvec3) == 3 * sizeof (double), "");
+static_assert (sizeof (glm::dmat4) == 16 * sizeof (double), "");
+
+namespace Geometry
+{
+
+// The kernels evaluate (c0 * x + c1 * y) + (c2 * z + c3) for points and
+// (c0 * x + c1 * y) + c2 * z for directions in the same order as glm does, so
+// every implementation gives the same result as the scalar code. Directions
+// skip the translation column entirely to keep the sign of zero components.
+
+#if defined (GEOMETRY_TRANSFORM_AVX)
+
+template <bool IsPoint>
+static void TransformArray (const glm::dmat4& transformation, const glm::dvec3* points, size_t count, glm::dvec3* result)
+{
+	const double* matrix = glm::value_ptr (transformation);
+	__m256d col0 = _mm256_loadu_pd (matrix + 0);
+	__m256d col1 = _mm256_loadu_pd (matrix + 4);
+	__m256d col2 = _mm256_loadu_pd (matrix + 8);
+	__m256d col3 = _mm256_loadu_pd (matrix + 12);
+	for (size_t i = 0; i < count; i++) {
+		const double* point = &points[i].x;
+		__m256d x = _mm256_broadcast_sd (point + 0);
+		__m256d y = _mm256_broadcast_sd (point + 1);
+		__m256d z = _mm256_broadcast_sd (point + 2);
+		__m256d xy = _mm256_add_pd (_mm256_mul_pd (col0, x), _mm256_mul_pd (col1, y));
+		__m256d zw = IsPoint ? _mm256_add_pd (_mm256_mul_pd (col2, z), col3) : _mm256_mul_pd (col2, z);
+		__m256d transformed = _mm256_add_pd (xy, zw);
+		double* target = &result[i].x;
+		_mm_storeu_pd (target, _mm256_castpd256_pd128 (transformed));
+		_mm_store_sd (target + 2, _mm256_extractf128_pd (transformed, 1));
+	}
+}
+
+#elif defined (GEOMETRY_TRANSFORM_SSE2)
+
+template <bool IsPoint>
+static void TransformArray (const glm::dmat4& transformation, const glm::dvec3* points, size_t count, glm::dvec3* result)
+{
+	const double* matrix = glm::value_ptr (transformation);
+	__m128d col0xy = _mm_loadu_pd (matrix + 0);
+	__m128d col1xy = _mm_loadu_pd (matrix + 4);
+	__m128d col2xy = _mm_loadu_pd (matrix + 8);
+	__m128d col3xy = _mm_loadu_pd (matrix + 12);
+	__m128d col0z = _mm_load_sd (matrix + 2);
+	__m128d col1z = _mm_load_sd (matrix + 6);
+	__m128d col2z = _mm_load_sd (matrix + 10);
+	__m128d col3z = _mm_load_sd (matrix + 14);
+	for (size_t i = 0; i < count; i++) {
+		const double* point = &points[i].x;
+		__m128d x = _mm_load1_pd (point + 0);
+		__m128d y = _mm_load1_pd (point + 1);
+		__m128d z = _mm_load1_pd (point + 2);
+		__m128d xy = _mm_add_pd (
+			_mm_add_pd (_mm_mul_pd (col0xy, x), _mm_mul_pd (col1xy, y)),
+			IsPoint ? _mm_add_pd (_mm_mul_pd (col2xy, z), col3xy) : _mm_mul_pd (col2xy, z)
+		);
+		__m128d zz = _mm_add_sd (
+			_mm_add_sd (_mm_mul_sd (col0z, x), _mm_mul_sd (col1z, y)),
+			IsPoint ? _mm_add_sd (_mm_mul_sd (col2z, z), col3z) : _mm_mul_sd (col2z, z)
+		);
+		double* target = &result[i].x;
+		_mm_storeu_pd (target, xy);
+		_mm_store_sd (target + 2, zz);
+	}
+}
+
+#else
+
+template <bool IsPoint>
+static void TransformArray (const glm::dmat4& transformation, const glm::dvec3* points, size_t count, glm::dvec3* result)
+{
+	glm::dmat3 linearPart (transformation);
+	for (size_t i = 0; i < count; i++) {
+		result[i] = IsPoint ? glm::dvec3 (transformation * glm::dvec4 (points[i], 1.0)) : linearPart * points[i];
+	}
+}
+
+#endif
+
+glm::dmat3 GetNormalTransformation (const glm::dmat4& transformation)
+{
+	// the cofactors of zero elements may come out as negative zeros, adding
+	// zero turns them back so they don't flip the sign of zero components
+	glm::dmat3 normalTransformation = glm::transpose (glm::inverse (glm::dmat3 (transformation)));
+	for (int i = 0; i < 3; i++) {
+		normalTransformation[i] += glm::dvec3 (0.0);
+	}
+	return normalTransformation;
+}
+
+double GetMaxAxisScale (const glm::dmat4& transformation)
+{
+	double maxScale = 0.0;
+	for (int i = 0; i < 3; i++) {
+		maxScale = std::max (maxScale, glm::length (glm::dvec3 (transformation[i])));
+	}
+	return maxScale;
+}
+
+void TransformPoints (const glm::dmat4& transformation, const glm::dvec3* points, size_t count, glm::dvec3* result)
+{
+	TransformArray<true> (transformation, points, count, result);
+}
+
+void TransformNormals (const glm::dmat4& transformation, const glm::dvec3* normals, size_t count, glm::dvec3* result)
+{
+	glm::dmat4 normalTransformation (GetNormalTransformation (transformation));
+	TransformArray<false> (normalTransformation, normals, count, result);
+	for (size_t i = 0; i < count; i++) {
+		double length = glm::length (result[i]);
+		if (length > 0.0) {
+			result[i] /= length;
+		}
+	}
+}
+
+void TransformPoints (const glm::dmat4& transformation, const std::vector<glm::dvec3>& points, std::vector<glm::dvec3>& result)
+{
+	result.resize (points.size ());
+	TransformPoints (transformation, points.data (), points.size (), result.data ());
+}
+
+void TransformNormals (const glm::dmat4& transformation, const std::vector<glm::dvec3>& normals, std::vector<glm::dvec3>& result)
+{
+	result.resize (normals.size ());
+	TransformNormals (transformation, normals.data (), normals.size (), result.data ());
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef GEOMETRY_TRANSFORMATION_HPP
+#define GEOMETRY_TRANSFORMATION_HPP
+
+#include "IncludeGLM.hpp"
+
+#include <vector>
+
+namespace Geometry
+{
+
+// The array functions can transform in place, result may be the same array
+// as the input.
+
+glm::dmat3		GetNormalTransformation (const glm::dmat4& transformation);
+
+// the largest length an axis of the local coordinate system gets by the transformation
+double			GetMaxAxisScale (const glm::dmat4& transformation);
+
+void			TransformPoints (const glm::dmat4& transformation, const glm::dvec3* points, size_t count, glm::dvec3* result);
+void			TransformNormals (const glm::dmat4& transformation, const glm::dvec3* normals, size_t count, glm::dvec3* result);
+
+void			TransformPoints (const glm::dmat4& transformation, const std::vector<glm::dvec3>& points, std::vector<glm::dvec3>& result);
+void			TransformNormals (const glm::dmat4& transformation, const std::vector<glm::dvec3>& normals, std::vector<glm::dvec3>& result);
+
+}
+
+#endif
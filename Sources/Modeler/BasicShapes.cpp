@@ -215,6 +215,39 @@ Mesh SphereShape::GenerateMesh () const
 	return GenerateSphere (material, transformation, radius, segmentation, isSmooth);
 }
 
+IcosphereShape::IcosphereShape (const Material& material, const glm::dmat4& transformation, double radius, int frequency, bool isSmooth) :
+	Shape (transformation),
+	material (material),
+	radius (radius),
+	frequency (frequency),
+	isSmooth (isSmooth)
+{
+}
+
+IcosphereShape::~IcosphereShape ()
+{
+}
+
+bool IcosphereShape::Check () const
+{
+	return Geometry::IsGreater (radius, 0.0) && frequency >= 1;
+}
+
+ShapePtr IcosphereShape::Clone () const
+{
+	return ShapePtr (new IcosphereShape (*this));
+}
+
+std::wstring IcosphereShape::ToString () const
+{
+	return L"Icosphere";
+}
+
+Mesh IcosphereShape::GenerateMesh () const
+{
+	return GenerateIcosphere (material, transformation, radius, frequency, isSmooth);
+}
+
 TorusShape::TorusShape (const Material& material, const glm::dmat4& transformation, double outerRadius, double innerRadius, int outerSegmentation, int innerSegmentation, bool isSmooth) :
 	Shape (transformation),
 	material (material),
@@ -385,6 +418,12 @@ MeshShape::MeshShape (const glm::dmat4& transformation, const Mesh& mesh) :
 {
 }
 
+MeshShape::MeshShape (const glm::dmat4& transformation, Mesh&& mesh) :
+	Shape (transformation),
+	mesh (std::move (mesh))
+{
+}
+
 MeshShape::~MeshShape ()
 {
 }
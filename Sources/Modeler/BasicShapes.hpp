@@ -124,6 +124,24 @@ private:
 	bool		isSmooth;
 };
 
+class IcosphereShape : public Shape
+{
+public:
+	IcosphereShape (const Material& material, const glm::dmat4& transformation, double radius, int frequency, bool isSmooth);
+	virtual ~IcosphereShape ();
+
+	virtual bool			Check () const override;
+	virtual ShapePtr		Clone () const override;
+	virtual std::wstring	ToString () const override;
+	virtual Mesh			GenerateMesh () const override;
+
+private:
+	Material	material;
+	double		radius;
+	int			frequency;
+	bool		isSmooth;
+};
+
 class TorusShape : public Shape
 {
 public:
@@ -201,6 +219,7 @@ class MeshShape : public Shape
 {
 public:
 	MeshShape (const glm::dmat4& transformation, const Mesh& mesh);
+	MeshShape (const glm::dmat4& transformation, Mesh&& mesh);
 	virtual ~MeshShape ();
 
 	virtual bool			Check () const override;
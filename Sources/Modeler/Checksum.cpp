@@ -6,14 +6,56 @@ static_assert (sizeof (int) == 4, "");
 static_assert (sizeof (unsigned int) == 4, "");
 static_assert (sizeof (size_t) == 8, "");
 static_assert (sizeof (int64_t) == 8, "");
+static_assert (sizeof (uint64_t) == 8, "");
 static_assert (sizeof (float) == 4, "");
 static_assert (sizeof (double) == 8, "");
 
+// Two independent 64-bit lanes based on the xxHash64 round function. Words are
+// distributed between the lanes alternately, so hashing a buffer processes 16
+// bytes per iteration without a dependency between the two multiplications.
+
+static const uint64_t Prime1 = 11400714785074694791ULL;
+static const uint64_t Prime2 = 14029467366897019727ULL;
+static const uint64_t Prime3 = 1609587929392839161ULL;
+static const uint64_t Prime4 = 9650029242287828579ULL;
+static const uint64_t Prime5 = 2870177450012600261ULL;
+
+static inline uint64_t RotateLeft (uint64_t val, int bits)
+{
+	return (val << bits) | (val >> (64 - bits));
+}
+
+static inline uint64_t Round (uint64_t acc, uint64_t val)
+{
+	acc += val * Prime2;
+	acc = RotateLeft (acc, 31);
+	acc *= Prime1;
+	return acc;
+}
+
+static inline uint64_t Avalanche (uint64_t val)
+{
+	val ^= val >> 33;
+	val *= Prime2;
+	val ^= val >> 29;
+	val *= Prime3;
+	val ^= val >> 32;
+	return val;
+}
+
+static inline uint64_t ReadWord (const unsigned char* data)
+{
+	uint64_t word = 0;
+	memcpy (&word, data, sizeof (word));
+	return word;
+}
+
 namespace Modeler
 {
 
 Checksum::Checksum () :
-	checksum (0),
+	lane1 (Prime1 + Prime2),
+	lane2 (Prime2),
 	counter (0)
 {
 
@@ -26,47 +68,77 @@ Checksum::~Checksum ()
 
 void Checksum::Add (int val)
 {
-	AddInteger (val);
+	AddWord ((uint64_t) (unsigned int) val);
 }
 
 void Checksum::Add (unsigned int val)
 {
-	AddInteger (int (val));
+	AddWord ((uint64_t) val);
 }
 
 void Checksum::Add (int64_t val)
 {
-	AddInteger ((int) (val & 0xffffffff));
-	AddInteger ((int) ((val >> 32) & 0xffffffff));
+	AddWord ((uint64_t) val);
 }
 
 void Checksum::Add (float val)
 {
-	int intVal = 0;
+	unsigned int intVal = 0;
 	memcpy (&intVal, &val, sizeof (intVal));
-	AddInteger (intVal);
+	AddWord ((uint64_t) intVal);
 }
 
 void Checksum::Add (double val)
 {
-	int64_t intVal = 0;
+	uint64_t intVal = 0;
 	memcpy (&intVal, &val, sizeof (intVal));
-	Add (intVal);
+	AddWord (intVal);
 }
 
 void Checksum::Add (size_t val)
 {
-	Add (int64_t (val));
+	AddWord ((uint64_t) val);
 }
 
 void Checksum::Add (const Checksum& val)
 {
-	Add (val.checksum);
+	AddWord (val.lane1);
+	AddWord (val.lane2);
+	AddWord (val.counter);
+}
+
+void Checksum::AddData (const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*) data;
+	size_t wordCount = size / sizeof (uint64_t);
+	size_t wordIndex = 0;
+	if (wordCount > 0 && counter % 2 != 0) {
+		AddWord (ReadWord (bytes));
+		wordIndex++;
+	}
+	uint64_t acc1 = lane1;
+	uint64_t acc2 = lane2;
+	for (; wordIndex + 1 < wordCount; wordIndex += 2) {
+		acc1 = Round (acc1, ReadWord (bytes + wordIndex * sizeof (uint64_t)));
+		acc2 = Round (acc2, ReadWord (bytes + (wordIndex + 1) * sizeof (uint64_t)));
+		counter += 2;
+	}
+	lane1 = acc1;
+	lane2 = acc2;
+	if (wordIndex < wordCount) {
+		AddWord (ReadWord (bytes + wordIndex * sizeof (uint64_t)));
+	}
+	size_t remaining = size % sizeof (uint64_t);
+	if (remaining > 0) {
+		uint64_t lastWord = 0;
+		memcpy (&lastWord, bytes + wordCount * sizeof (uint64_t), remaining);
+		AddWord (lastWord);
+	}
 }
 
 bool Checksum::operator== (const Checksum& rhs) const
 {
-	return checksum == rhs.checksum && counter == rhs.counter;
+	return lane1 == rhs.lane1 && lane2 == rhs.lane2 && counter == rhs.counter;
 }
 
 bool Checksum::operator!= (const Checksum& rhs) const
@@ -76,14 +148,20 @@ bool Checksum::operator!= (const Checksum& rhs) const
 
 size_t Checksum::GenerateHashValue () const
 {
-	return std::hash<int> {} (checksum) + 49157 * std::hash<int> {} (counter);
+	uint64_t result = RotateLeft (lane1, 1) + RotateLeft (lane2, 7);
+	result ^= Round (0, counter);
+	result = result * Prime1 + Prime4;
+	result += counter * Prime5;
+	return (size_t) Avalanche (result);
 }
 
-void Checksum::AddInteger (int val)
+void Checksum::AddWord (uint64_t val)
 {
-	// BSD checksum algorithm
-	checksum = (checksum >> 1) + ((checksum & 1) << 31);
-	checksum = (checksum + val) & 0xffffffff;
+	if (counter % 2 == 0) {
+		lane1 = Round (lane1, val);
+	} else {
+		lane2 = Round (lane2, val);
+	}
 	counter++;
 }
 
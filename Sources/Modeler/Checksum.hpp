@@ -20,6 +20,7 @@ public:
 	void	Add (float val);
 	void	Add (double val);
 	void	Add (const Checksum& val);
+	void	AddData (const void* data, size_t size);
 
 	bool	operator== (const Checksum& rhs) const;
 	bool	operator!= (const Checksum& rhs) const;
@@ -27,10 +28,11 @@ public:
 	size_t	GenerateHashValue () const;
 
 private:
-	void	AddInteger (int val);
-	
-	int		checksum;
-	int		counter;
+	void		AddWord (uint64_t val);
+
+	uint64_t	lane1;
+	uint64_t	lane2;
+	uint64_t	counter;
 };
 
 }
@@ -1,5 +1,6 @@
 #include "Export.hpp"
 #include "Checksum.hpp"
+#include "MeshCompaction.hpp"
 #include "TriangleUtils.hpp"
 
 #include <fstream>
@@ -43,9 +44,10 @@ public:
 		return materialMap.at ({ origMeshId, origMaterialId });
 	}
 
-	void EnumerateMaterials (const std::function<void (MaterialId, const Material&)>& processor) const
+	template <typename ProcessorType>
+	void EnumerateMaterials (ProcessorType processor) const
 	{
-		for (MaterialId materialId = 0; materialId < materials.size (); materialId++) {
+		for (MaterialId materialId = 0; materialId < (MaterialId) materials.size (); materialId++) {
 			processor (materialId, materials[materialId]);
 		}
 	}
@@ -95,9 +97,13 @@ void ExportModelToObj (const Model& model, const std::wstring& name, ModelWriter
 		geometry.EnumerateNormals (transformation, [&] (const glm::dvec3& normal) {
 			writer.WriteLine (L"vn %g %g %g", normal.x, normal.y, normal.z);
 		});
-		EnumerateTrianglesByMaterial (geometry, materials, [&] (MaterialId materialId, const std::vector<unsigned int>& triangles) {
-			writer.WriteLine (L"usemtl Material" + std::to_wstring (materialMap.GetMaterial (meshId, materialId)));
-			for (unsigned int triangleId : triangles) {
+		MaterialId lastMaterialId = -1;
+		materials.EnumerateTrianglesByMaterial ([&] (MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount) {
+			if (materialId != lastMaterialId) {
+				writer.WriteLine (L"usemtl Material" + std::to_wstring (materialMap.GetMaterial (meshId, materialId)));
+				lastMaterialId = materialId;
+			}
+			for (unsigned int triangleId = firstTriangle; triangleId < firstTriangle + triangleCount; triangleId++) {
 				const MeshTriangle& triangle = geometry.GetTriangle (triangleId);
 				writer.WriteLine (
 					L"f %d//%d %d//%d %d//%d",
@@ -119,11 +125,11 @@ void ExportModelToStl (const Model& model, const std::wstring& name, ModelWriter
 	writer.WriteLine (L"solid " + name);
 	model.EnumerateMeshes ([&] (MeshId, const MeshRef& meshRef) {
 		const MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
-		const glm::dmat4& transformation = meshRef.GetTransformation ();
+		std::vector<glm::dvec3> vertices = geometry.GetTransformedVertices (meshRef.GetTransformation ());
 		geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
-			glm::dvec3 v1 = geometry.GetVertex (triangle.v1, transformation);
-			glm::dvec3 v2 = geometry.GetVertex (triangle.v2, transformation);
-			glm::dvec3 v3 = geometry.GetVertex (triangle.v3, transformation);
+			const glm::dvec3& v1 = vertices[triangle.v1];
+			const glm::dvec3& v2 = vertices[triangle.v2];
+			const glm::dvec3& v3 = vertices[triangle.v3];
 			glm::dvec3 n = Geometry::CalculateTriangleNormal (v1, v2, v3);
 			writer.WriteLine (L"facet normal %g %g %g", n.x, n.y, n.z);
 			writer.WriteLine (L"    outer loop");
@@ -198,4 +204,26 @@ bool ExportMesh (const Mesh& mesh, FormatId formatId, const std::wstring& name,
 	return ExportModel (model, formatId, name, writer);
 }
 
+bool ExportModel (const Model& model, FormatId formatId, const std::wstring& name, ModelWriter& writer, double weldTolerance)
+{
+	std::unordered_map<std::pair<MeshGeometryId, MeshMaterialsId>, Mesh, PairHash> compactMeshes;
+	Model compactModel;
+	model.EnumerateMeshes ([&] (MeshId, const MeshRef& meshRef) {
+		std::pair<MeshGeometryId, MeshMaterialsId> key (meshRef.GetGeometryId (), meshRef.GetMaterialsId ());
+		auto found = compactMeshes.find (key);
+		if (found == compactMeshes.end ()) {
+			found = compactMeshes.insert ({ key, CompactMesh (model.GetMeshGeometry (meshRef), model.GetMeshMaterials (meshRef), weldTolerance) }).first;
+		}
+		Mesh mesh = found->second;
+		mesh.SetTransformation (meshRef.GetTransformation ());
+		compactModel.AddMesh (std::move (mesh));
+	});
+	return ExportModel (compactModel, formatId, name, writer);
+}
+
+bool ExportMesh (const Mesh& mesh, FormatId formatId, const std::wstring& name, ModelWriter& writer, double weldTolerance)
+{
+	return ExportMesh (CompactMesh (mesh, weldTolerance), formatId, name, writer);
+}
+
 }
@@ -37,6 +37,10 @@ void ExportModelToOff (const Model& model, const std::wstring& name, ModelWriter
 bool ExportModel (const Model& model, FormatId formatId, const std::wstring& name, ModelWriter& writer);
 bool ExportMesh (const Mesh& mesh, FormatId formatId, const std::wstring& name, ModelWriter& writer);
 
+// these versions weld and compact the meshes before writing them
+bool ExportModel (const Model& model, FormatId formatId, const std::wstring& name, ModelWriter& writer, double weldTolerance);
+bool ExportMesh (const Mesh& mesh, FormatId formatId, const std::wstring& name, ModelWriter& writer, double weldTolerance);
+
 }
 
 #endif
@@ -0,0 +1,180 @@
+#include "HalfEdgeMesh.hpp"
+#include "MeshTopology.hpp"
+
+namespace Modeler
+{
+
+const unsigned int NoHalfEdge = (unsigned int) -1;
+
+HalfEdgeMesh::HalfEdgeMesh () :
+	origins (),
+	opposites (),
+	vertexHalfEdges (),
+	manifoldVertices (),
+	isEdgeManifold (true),
+	isManifold (true),
+	isClosed (true)
+{
+
+}
+
+HalfEdgeMesh::HalfEdgeMesh (const MeshGeometry& geometry) :
+	HalfEdgeMesh ()
+{
+	const std::vector<MeshTriangle>& triangles = geometry.GetTriangles ();
+	unsigned int halfEdgeCount = (unsigned int) triangles.size () * 3;
+	origins.resize (halfEdgeCount);
+	for (unsigned int i = 0; i < triangles.size (); i++) {
+		const MeshTriangle& triangle = triangles[i];
+		origins[i * 3] = triangle.v1;
+		origins[i * 3 + 1] = triangle.v2;
+		origins[i * 3 + 2] = triangle.v3;
+	}
+
+	// the first half-edge of every edge collects the second one, the edge is non-manifold if
+	// it has more half-edges, or the two half-edges have the same direction
+	std::vector<unsigned int> firstHalfEdges = FindFirstTriangleEdges (geometry);
+	std::vector<bool> nonManifoldEdges (halfEdgeCount, false);
+	opposites.assign (halfEdgeCount, NoHalfEdge);
+	for (unsigned int halfEdge = 0; halfEdge < halfEdgeCount; halfEdge++) {
+		unsigned int first = firstHalfEdges[halfEdge];
+		if (first == halfEdge) {
+			continue;
+		}
+		if (opposites[first] == NoHalfEdge) {
+			opposites[first] = halfEdge;
+		} else {
+			nonManifoldEdges[first] = true;
+		}
+	}
+	for (unsigned int halfEdge = 0; halfEdge < halfEdgeCount; halfEdge++) {
+		unsigned int opposite = opposites[halfEdge];
+		if (firstHalfEdges[halfEdge] != halfEdge || opposite == NoHalfEdge) {
+			continue;
+		}
+		if (nonManifoldEdges[halfEdge] || origins[halfEdge] != GetTarget (opposite)) {
+			opposites[halfEdge] = NoHalfEdge;
+			isEdgeManifold = false;
+		} else {
+			opposites[opposite] = halfEdge;
+		}
+	}
+
+	vertexHalfEdges.assign (geometry.VertexCount (), NoHalfEdge);
+	std::vector<unsigned int> outgoingCounts (geometry.VertexCount (), 0);
+	for (unsigned int halfEdge = 0; halfEdge < halfEdgeCount; halfEdge++) {
+		unsigned int origin = origins[halfEdge];
+		if (vertexHalfEdges[origin] == NoHalfEdge) {
+			vertexHalfEdges[origin] = halfEdge;
+		}
+		outgoingCounts[origin]++;
+	}
+	for (unsigned int halfEdge = 0; halfEdge < halfEdgeCount; halfEdge++) {
+		if (opposites[halfEdge] == NoHalfEdge) {
+			vertexHalfEdges[GetTarget (halfEdge)] = GetNext (halfEdge);
+			isClosed = false;
+		}
+	}
+
+	// a vertex is manifold if one fan around it contains all of its triangles
+	isManifold = isEdgeManifold;
+	manifoldVertices.assign (geometry.VertexCount (), true);
+	for (unsigned int vertex = 0; vertex < geometry.VertexCount (); vertex++) {
+		unsigned int fanCount = 0;
+		EnumerateOutgoingHalfEdges (vertex, [&] (unsigned int) {
+			fanCount++;
+		});
+		if (fanCount != outgoingCounts[vertex]) {
+			manifoldVertices[vertex] = false;
+			isManifold = false;
+		}
+	}
+}
+
+unsigned int HalfEdgeMesh::VertexCount () const
+{
+	return (unsigned int) vertexHalfEdges.size ();
+}
+
+unsigned int HalfEdgeMesh::TriangleCount () const
+{
+	return (unsigned int) origins.size () / 3;
+}
+
+unsigned int HalfEdgeMesh::HalfEdgeCount () const
+{
+	return (unsigned int) origins.size ();
+}
+
+unsigned int HalfEdgeMesh::GetTriangle (unsigned int halfEdge)
+{
+	return halfEdge / 3;
+}
+
+unsigned int HalfEdgeMesh::GetNext (unsigned int halfEdge)
+{
+	return (halfEdge % 3 == 2) ? halfEdge - 2 : halfEdge + 1;
+}
+
+unsigned int HalfEdgeMesh::GetPrevious (unsigned int halfEdge)
+{
+	return (halfEdge % 3 == 0) ? halfEdge + 2 : halfEdge - 1;
+}
+
+unsigned int HalfEdgeMesh::GetOrigin (unsigned int halfEdge) const
+{
+	return origins[halfEdge];
+}
+
+unsigned int HalfEdgeMesh::GetTarget (unsigned int halfEdge) const
+{
+	return origins[GetNext (halfEdge)];
+}
+
+unsigned int HalfEdgeMesh::GetOpposite (unsigned int halfEdge) const
+{
+	return opposites[halfEdge];
+}
+
+bool HalfEdgeMesh::IsBoundary (unsigned int halfEdge) const
+{
+	return opposites[halfEdge] == NoHalfEdge;
+}
+
+unsigned int HalfEdgeMesh::GetNextBoundaryHalfEdge (unsigned int halfEdge) const
+{
+	// rotate around the target vertex until the fan ends, the rotation can't get back to the
+	// start, because the start follows the boundary half-edge
+	unsigned int next = GetNext (halfEdge);
+	while (opposites[next] != NoHalfEdge) {
+		next = GetNext (opposites[next]);
+	}
+	return next;
+}
+
+unsigned int HalfEdgeMesh::GetVertexHalfEdge (unsigned int vertex) const
+{
+	return vertexHalfEdges[vertex];
+}
+
+bool HalfEdgeMesh::IsVertexManifold (unsigned int vertex) const
+{
+	return manifoldVertices[vertex];
+}
+
+bool HalfEdgeMesh::IsEdgeManifold () const
+{
+	return isEdgeManifold;
+}
+
+bool HalfEdgeMesh::IsManifold () const
+{
+	return isManifold;
+}
+
+bool HalfEdgeMesh::IsClosed () const
+{
+	return isClosed;
+}
+
+}
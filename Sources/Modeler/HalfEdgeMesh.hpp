@@ -0,0 +1,127 @@
+#ifndef MODELER_HALFEDGEMESH_HPP
+#define MODELER_HALFEDGEMESH_HPP
+
+#include "Mesh.hpp"
+
+#include <vector>
+
+namespace Modeler
+{
+
+extern const unsigned int NoHalfEdge;
+
+// Half-edge adjacency of a mesh geometry in corner table layout. The half-edges of triangle t
+// are 3t, 3t + 1 and 3t + 2 in the vertex order of the triangle, so the triangle, next and
+// previous links are implicit, and only the origins and the opposites are stored.
+// Half-edges on boundary and non-manifold edges have no opposite, so the mesh is cut along
+// the non-manifold edges, and every query stays well defined on any input.
+
+class HalfEdgeMesh
+{
+public:
+	HalfEdgeMesh ();
+	HalfEdgeMesh (const MeshGeometry& geometry);
+
+	unsigned int			VertexCount () const;
+	unsigned int			TriangleCount () const;
+	unsigned int			HalfEdgeCount () const;
+
+	static unsigned int		GetTriangle (unsigned int halfEdge);
+	static unsigned int		GetNext (unsigned int halfEdge);
+	static unsigned int		GetPrevious (unsigned int halfEdge);
+
+	unsigned int			GetOrigin (unsigned int halfEdge) const;
+	unsigned int			GetTarget (unsigned int halfEdge) const;
+	unsigned int			GetOpposite (unsigned int halfEdge) const;
+	bool					IsBoundary (unsigned int halfEdge) const;
+	// the boundary half-edge which starts at the target of the given boundary half-edge
+	unsigned int			GetNextBoundaryHalfEdge (unsigned int halfEdge) const;
+
+	// an outgoing half-edge, for boundary vertices it is the first one around the vertex
+	unsigned int			GetVertexHalfEdge (unsigned int vertex) const;
+	bool					IsVertexManifold (unsigned int vertex) const;
+
+	bool					IsEdgeManifold () const;
+	bool					IsManifold () const;
+	bool					IsClosed () const;
+
+	// processor (halfEdge) for the outgoing half-edges of the fan around the vertex
+	template <typename ProcessorType>
+	void					EnumerateOutgoingHalfEdges (unsigned int vertex, ProcessorType processor) const;
+
+	// processor (vertex) for the one-ring neighbours of the vertex in fan order
+	template <typename ProcessorType>
+	void					EnumerateVertexNeighbours (unsigned int vertex, ProcessorType processor) const;
+
+	// processor (const std::vector<unsigned int>& halfEdges) for every boundary loop
+	template <typename ProcessorType>
+	void					EnumerateBoundaryLoops (ProcessorType processor) const;
+
+private:
+	std::vector<unsigned int>	origins;
+	std::vector<unsigned int>	opposites;
+	std::vector<unsigned int>	vertexHalfEdges;
+	std::vector<bool>			manifoldVertices;
+	bool						isEdgeManifold;
+	bool						isManifold;
+	bool						isClosed;
+};
+
+template <typename ProcessorType>
+void HalfEdgeMesh::EnumerateOutgoingHalfEdges (unsigned int vertex, ProcessorType processor) const
+{
+	unsigned int start = vertexHalfEdges[vertex];
+	if (start == NoHalfEdge) {
+		return;
+	}
+	unsigned int halfEdge = start;
+	do {
+		processor (halfEdge);
+		unsigned int opposite = opposites[halfEdge];
+		if (opposite == NoHalfEdge) {
+			break;
+		}
+		halfEdge = GetNext (opposite);
+	} while (halfEdge != start);
+}
+
+template <typename ProcessorType>
+void HalfEdgeMesh::EnumerateVertexNeighbours (unsigned int vertex, ProcessorType processor) const
+{
+	unsigned int start = vertexHalfEdges[vertex];
+	if (start == NoHalfEdge) {
+		return;
+	}
+	// on the boundary the first neighbour is reached only by the incoming boundary half-edge
+	unsigned int previous = GetPrevious (start);
+	if (opposites[previous] == NoHalfEdge) {
+		processor (origins[previous]);
+	}
+	EnumerateOutgoingHalfEdges (vertex, [&] (unsigned int halfEdge) {
+		processor (GetTarget (halfEdge));
+	});
+}
+
+template <typename ProcessorType>
+void HalfEdgeMesh::EnumerateBoundaryLoops (ProcessorType processor) const
+{
+	std::vector<bool> visited (opposites.size (), false);
+	std::vector<unsigned int> loop;
+	for (unsigned int start = 0; start < opposites.size (); start++) {
+		if (opposites[start] != NoHalfEdge || visited[start]) {
+			continue;
+		}
+		loop.clear ();
+		unsigned int halfEdge = start;
+		while (!visited[halfEdge]) {
+			visited[halfEdge] = true;
+			loop.push_back (halfEdge);
+			halfEdge = GetNextBoundaryHalfEdge (halfEdge);
+		}
+		processor (loop);
+	}
+}
+
+}
+
+#endif
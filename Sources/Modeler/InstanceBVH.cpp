@@ -0,0 +1,435 @@
+#include "InstanceBVH.hpp"
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Modeler
+{
+
+static const unsigned int BinCount = 16;
+
+// the tree is rebuilt instead of inserting the instances one by one, if the count of the
+// added instances is more than the count of the instances in the tree divided by this
+static const unsigned int RebuildRatio = 4;
+
+// the tree is rebuilt if inserting made it this much higher than after the last rebuild
+static const unsigned int HeightSlack = 8;
+
+// below this depth the splits are chosen by the surface area heuristic, then by the median
+static const unsigned int MaxHeuristicDepth = 32;
+
+// the boxes contain the exact bounding boxes of the instances
+static const double BoxInflation = 4.0 * Geometry::EPS;
+
+class BuildTask
+{
+public:
+	unsigned int	node;
+	unsigned int	first;
+	unsigned int	count;
+	unsigned int	depth;
+};
+
+class Bin
+{
+public:
+	Bin () :
+		bounds (),
+		count (0)
+	{
+	}
+
+	Geometry::BoundingBox	bounds;
+	unsigned int			count;
+};
+
+static double GetSurfaceArea (const glm::dvec3& min, const glm::dvec3& max)
+{
+	glm::dvec3 size = max - min;
+	return 2.0 * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static double GetSurfaceArea (const Geometry::BoundingBox& box)
+{
+	if (!box.IsValid ()) {
+		return 0.0;
+	}
+	return GetSurfaceArea (box.GetMin (), box.GetMax ());
+}
+
+InstanceBVH::InstanceBVH () :
+	nodes (),
+	freeNodes (),
+	root (NoNode),
+	leafNodes (),
+	pendingInstances (),
+	pendingPositions (),
+	heightLimit (0)
+{
+
+}
+
+unsigned int InstanceBVH::InstanceCount () const
+{
+	return (unsigned int) (leafNodes.size () + pendingInstances.size ());
+}
+
+unsigned int InstanceBVH::Height () const
+{
+	if (root == NoNode) {
+		return 0;
+	}
+	return nodes[root].height;
+}
+
+bool InstanceBVH::IsUpToDate () const
+{
+	return pendingInstances.empty ();
+}
+
+void InstanceBVH::AddInstance (int instanceId, const Geometry::BoundingBox& boundingBox)
+{
+	if (leafNodes.find (instanceId) != leafNodes.end () || pendingPositions.find (instanceId) != pendingPositions.end ()) {
+		throw std::logic_error ("instance is already added");
+	}
+	if (!boundingBox.IsValid ()) {
+		throw std::logic_error ("invalid instance bounding box");
+	}
+
+	glm::dvec3 size = boundingBox.GetMax () - boundingBox.GetMin ();
+	glm::dvec3 inflation (BoxInflation * std::max (std::max (size.x, size.y), size.z) + Geometry::EPS);
+	Instance instance;
+	instance.instanceId = instanceId;
+	instance.min = boundingBox.GetMin () - inflation;
+	instance.max = boundingBox.GetMax () + inflation;
+	pendingPositions.insert ({ instanceId, (unsigned int) pendingInstances.size () });
+	pendingInstances.push_back (instance);
+}
+
+void InstanceBVH::RemoveInstance (int instanceId)
+{
+	auto foundPending = pendingPositions.find (instanceId);
+	if (foundPending != pendingPositions.end ()) {
+		unsigned int position = foundPending->second;
+		pendingPositions.erase (foundPending);
+		if (position != pendingInstances.size () - 1) {
+			pendingInstances[position] = pendingInstances.back ();
+			pendingPositions[pendingInstances[position].instanceId] = position;
+		}
+		pendingInstances.pop_back ();
+		return;
+	}
+
+	auto foundLeaf = leafNodes.find (instanceId);
+	if (foundLeaf == leafNodes.end ()) {
+		throw std::logic_error ("instance is not found");
+	}
+	unsigned int leaf = foundLeaf->second;
+	leafNodes.erase (foundLeaf);
+	RemoveLeaf (leaf);
+	FreeNode (leaf);
+}
+
+void InstanceBVH::Clear ()
+{
+	nodes.clear ();
+	freeNodes.clear ();
+	root = NoNode;
+	leafNodes.clear ();
+	pendingInstances.clear ();
+	pendingPositions.clear ();
+	heightLimit = 0;
+}
+
+void InstanceBVH::Update ()
+{
+	if (pendingInstances.empty ()) {
+		return;
+	}
+
+	if (root == NoNode || pendingInstances.size () * RebuildRatio > leafNodes.size ()) {
+		Rebuild ();
+		return;
+	}
+
+	for (const Instance& instance : pendingInstances) {
+		InsertLeaf (instance);
+	}
+	pendingInstances.clear ();
+	pendingPositions.clear ();
+	if (Height () > heightLimit) {
+		Rebuild ();
+	}
+}
+
+bool InstanceBVH::IsLeaf (unsigned int nodeIndex) const
+{
+	return nodes[nodeIndex].child1 == NoNode;
+}
+
+unsigned int InstanceBVH::AllocateNode ()
+{
+	unsigned int nodeIndex = 0;
+	if (!freeNodes.empty ()) {
+		nodeIndex = freeNodes.back ();
+		freeNodes.pop_back ();
+	} else {
+		nodeIndex = (unsigned int) nodes.size ();
+		nodes.push_back (Node ());
+	}
+	Node& node = nodes[nodeIndex];
+	node.parent = NoNode;
+	node.child1 = NoNode;
+	node.child2 = NoNode;
+	node.height = 0;
+	node.instanceId = -1;
+	return nodeIndex;
+}
+
+void InstanceBVH::FreeNode (unsigned int nodeIndex)
+{
+	freeNodes.push_back (nodeIndex);
+}
+
+void InstanceBVH::InsertLeaf (const Instance& instance)
+{
+	unsigned int leaf = AllocateNode ();
+	nodes[leaf].min = instance.min;
+	nodes[leaf].max = instance.max;
+	nodes[leaf].instanceId = instance.instanceId;
+	leafNodes.insert ({ instance.instanceId, leaf });
+
+	// descend to the sibling which increases the surface area of the tree the least
+	unsigned int sibling = root;
+	while (!IsLeaf (sibling)) {
+		const Node& node = nodes[sibling];
+		double area = GetSurfaceArea (node.min, node.max);
+		double combinedArea = GetSurfaceArea (glm::min (node.min, instance.min), glm::max (node.max, instance.max));
+		double cost = 2.0 * combinedArea;
+		double inheritanceCost = 2.0 * (combinedArea - area);
+
+		double childCosts[2];
+		unsigned int children[2] = { node.child1, node.child2 };
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[children[i]];
+			double childArea = GetSurfaceArea (glm::min (child.min, instance.min), glm::max (child.max, instance.max));
+			if (!IsLeaf (children[i])) {
+				childArea -= GetSurfaceArea (child.min, child.max);
+			}
+			childCosts[i] = childArea + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) {
+			break;
+		}
+		sibling = (childCosts[0] <= childCosts[1]) ? children[0] : children[1];
+	}
+
+	unsigned int oldParent = nodes[sibling].parent;
+	unsigned int newParent = AllocateNode ();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+	if (oldParent == NoNode) {
+		root = newParent;
+	} else if (nodes[oldParent].child1 == sibling) {
+		nodes[oldParent].child1 = newParent;
+	} else {
+		nodes[oldParent].child2 = newParent;
+	}
+	Refit (newParent);
+}
+
+void InstanceBVH::RemoveLeaf (unsigned int leaf)
+{
+	if (leaf == root) {
+		root = NoNode;
+		return;
+	}
+
+	unsigned int parent = nodes[leaf].parent;
+	unsigned int grandParent = nodes[parent].parent;
+	unsigned int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+	nodes[sibling].parent = grandParent;
+	FreeNode (parent);
+	if (grandParent == NoNode) {
+		root = sibling;
+		return;
+	}
+	if (nodes[grandParent].child1 == parent) {
+		nodes[grandParent].child1 = sibling;
+	} else {
+		nodes[grandParent].child2 = sibling;
+	}
+	Refit (grandParent);
+}
+
+void InstanceBVH::Refit (unsigned int nodeIndex)
+{
+	while (nodeIndex != NoNode) {
+		Node& node = nodes[nodeIndex];
+		const Node& child1 = nodes[node.child1];
+		const Node& child2 = nodes[node.child2];
+		node.min = glm::min (child1.min, child2.min);
+		node.max = glm::max (child1.max, child2.max);
+		node.height = std::max (child1.height, child2.height) + 1;
+		nodeIndex = node.parent;
+	}
+}
+
+void InstanceBVH::Rebuild ()
+{
+	std::vector<Instance> instances;
+	instances.reserve (InstanceCount ());
+	if (root != NoNode) {
+		std::vector<unsigned int> stack (1, root);
+		while (!stack.empty ()) {
+			const Node& node = nodes[stack.back ()];
+			stack.pop_back ();
+			if (node.child1 == NoNode) {
+				instances.push_back ({ node.instanceId, node.min, node.max });
+			} else {
+				stack.push_back (node.child2);
+				stack.push_back (node.child1);
+			}
+		}
+	}
+	instances.insert (instances.end (), pendingInstances.begin (), pendingInstances.end ());
+	Clear ();
+	if (instances.empty ()) {
+		return;
+	}
+
+	std::vector<glm::dvec3> centers (instances.size ());
+	std::vector<unsigned int> order (instances.size ());
+	for (unsigned int i = 0; i < instances.size (); i++) {
+		centers[i] = (instances[i].min + instances[i].max) * 0.5;
+		order[i] = i;
+	}
+
+	nodes.reserve (2 * instances.size () - 1);
+	root = AllocateNode ();
+	std::vector<BuildTask> tasks;
+	tasks.push_back ({ root, 0, (unsigned int) instances.size (), 0 });
+	while (!tasks.empty ()) {
+		BuildTask task = tasks.back ();
+		tasks.pop_back ();
+
+		if (task.count == 1) {
+			const Instance& instance = instances[order[task.first]];
+			Node& node = nodes[task.node];
+			node.min = instance.min;
+			node.max = instance.max;
+			node.instanceId = instance.instanceId;
+			leafNodes.insert ({ instance.instanceId, task.node });
+			continue;
+		}
+
+		Geometry::BoundingBox centerBounds;
+		for (unsigned int i = task.first; i < task.first + task.count; i++) {
+			centerBounds.AddPoint (centers[order[i]]);
+		}
+		glm::dvec3 centerMin = centerBounds.GetMin ();
+		glm::dvec3 centerSize = centerBounds.GetMax () - centerMin;
+		unsigned int* first = &order[task.first];
+		unsigned int* last = first + task.count;
+		unsigned int* middle = nullptr;
+
+		if (task.depth < MaxHeuristicDepth) {
+			int bestAxis = -1;
+			unsigned int bestSplit = 0;
+			double bestCost = std::numeric_limits<double>::max ();
+			std::array<Bin, BinCount> bins;
+			for (int axis = 0; axis < 3; axis++) {
+				if (centerSize[axis] <= 0.0) {
+					continue;
+				}
+				bins.fill (Bin ());
+				double binScale = BinCount / centerSize[axis];
+				for (unsigned int* it = first; it != last; ++it) {
+					unsigned int binIndex = std::min ((unsigned int) ((centers[*it][axis] - centerMin[axis]) * binScale), BinCount - 1);
+					bins[binIndex].bounds.AddPoint (instances[*it].min);
+					bins[binIndex].bounds.AddPoint (instances[*it].max);
+					bins[binIndex].count++;
+				}
+
+				std::array<double, BinCount> rightAreas;
+				std::array<unsigned int, BinCount> rightCounts;
+				Geometry::BoundingBox rightBounds;
+				unsigned int rightCount = 0;
+				for (unsigned int i = BinCount - 1; i > 0; i--) {
+					rightBounds.AddBox (bins[i].bounds);
+					rightCount += bins[i].count;
+					rightAreas[i] = GetSurfaceArea (rightBounds);
+					rightCounts[i] = rightCount;
+				}
+
+				Geometry::BoundingBox leftBounds;
+				unsigned int leftCount = 0;
+				for (unsigned int i = 1; i < BinCount; i++) {
+					leftBounds.AddBox (bins[i - 1].bounds);
+					leftCount += bins[i - 1].count;
+					if (leftCount == 0 || rightCounts[i] == 0) {
+						continue;
+					}
+					double cost = GetSurfaceArea (leftBounds) * leftCount + rightAreas[i] * rightCounts[i];
+					if (cost < bestCost) {
+						bestAxis = axis;
+						bestSplit = i;
+						bestCost = cost;
+					}
+				}
+			}
+
+			if (bestAxis != -1) {
+				double binScale = BinCount / centerSize[bestAxis];
+				middle = std::partition (first, last, [&] (unsigned int instanceIndex) {
+					unsigned int binIndex = std::min ((unsigned int) ((centers[instanceIndex][bestAxis] - centerMin[bestAxis]) * binScale), BinCount - 1);
+					return binIndex < bestSplit;
+				});
+			}
+		}
+
+		if (middle == nullptr) {
+			int axis = 0;
+			for (int i = 1; i < 3; i++) {
+				if (centerSize[i] > centerSize[axis]) {
+					axis = i;
+				}
+			}
+			middle = first + task.count / 2;
+			std::nth_element (first, middle, last, [&] (unsigned int a, unsigned int b) {
+				return centers[a][axis] < centers[b][axis];
+			});
+		}
+
+		unsigned int leftCount = (unsigned int) (middle - first);
+		unsigned int child1 = AllocateNode ();
+		unsigned int child2 = AllocateNode ();
+		nodes[task.node].child1 = child1;
+		nodes[task.node].child2 = child2;
+		nodes[child1].parent = task.node;
+		nodes[child2].parent = task.node;
+		tasks.push_back ({ child1, task.first, leftCount, task.depth + 1 });
+		tasks.push_back ({ child2, task.first + leftCount, task.count - leftCount, task.depth + 1 });
+	}
+
+	// the children are always after their parent
+	for (unsigned int i = (unsigned int) nodes.size (); i > 0; i--) {
+		Node& node = nodes[i - 1];
+		if (node.child1 == NoNode) {
+			continue;
+		}
+		const Node& child1 = nodes[node.child1];
+		const Node& child2 = nodes[node.child2];
+		node.min = glm::min (child1.min, child2.min);
+		node.max = glm::max (child1.max, child2.max);
+		node.height = std::max (child1.height, child2.height) + 1;
+	}
+	heightLimit = std::min (Height () + HeightSlack, MaxTreeDepth);
+}
+
+}
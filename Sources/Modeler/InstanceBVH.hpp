@@ -0,0 +1,254 @@
+#ifndef MODELER_INSTANCEBVH_HPP
+#define MODELER_INSTANCEBVH_HPP
+
+#include "IncludeGLM.hpp"
+#include "MeshBVH.hpp"
+#include "BoundingShapes.hpp"
+#include "Ray.hpp"
+#include "Frustum.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <limits>
+#include <utility>
+
+namespace Modeler
+{
+
+// Bounding volume hierarchy over the world bounding boxes of instances with one instance in
+// every leaf. Added instances are collected and put into the tree by the next update, either
+// one by one, or by rebuilding the tree with the surface area heuristic when there are many
+// of them or the tree became too deep. Removed instances are unlinked, and the boxes above
+// them are refitted.
+
+class InstanceBVH
+{
+public:
+	InstanceBVH ();
+
+	unsigned int			InstanceCount () const;
+	unsigned int			Height () const;
+	bool					IsUpToDate () const;
+
+	void					AddInstance (int instanceId, const Geometry::BoundingBox& boundingBox);
+	void					RemoveInstance (int instanceId);
+	void					Clear ();
+	void					Update ();
+
+	// processor (instanceId) for the instances whose box may be hit by the ray, the tree must
+	// be up to date
+	template <typename ProcessorType>
+	void					EnumerateRayInstances (const Geometry::Ray& ray, ProcessorType processor) const;
+
+	// the same for the boxes closer than maxDistance, the processor may decrease maxDistance
+	// to skip the farther boxes, or make it negative to stop
+	template <typename ProcessorType>
+	void					EnumerateRayInstances (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const;
+
+	// processor (instanceId) for the instances whose box may be hit by any ray of the packet,
+	// the processor may decrease the max distances of the packet to skip the farther boxes
+	template <typename ProcessorType>
+	void					EnumerateRayPacketInstances (const RayPacket& packet, ProcessorType processor) const;
+
+	// processor (instanceId, isInside) for the instances whose box may intersect the frustum,
+	// isInside is true if the box is surely inside
+	template <typename ProcessorType>
+	void					EnumerateFrustumInstances (const Geometry::Frustum& frustum, ProcessorType processor) const;
+
+private:
+	static const unsigned int MaxTreeDepth = 64;
+	static const unsigned int NoNode = (unsigned int) -1;
+
+	class Node
+	{
+	public:
+		glm::dvec3		min;
+		glm::dvec3		max;
+		unsigned int	parent;
+		unsigned int	child1;
+		unsigned int	child2;
+		unsigned int	height;
+		int				instanceId;
+	};
+
+	class Instance
+	{
+	public:
+		int			instanceId;
+		glm::dvec3	min;
+		glm::dvec3	max;
+	};
+
+	bool					IsLeaf (unsigned int nodeIndex) const;
+	unsigned int			AllocateNode ();
+	void					FreeNode (unsigned int nodeIndex);
+	void					InsertLeaf (const Instance& instance);
+	void					RemoveLeaf (unsigned int leaf);
+	void					Refit (unsigned int nodeIndex);
+	void					Rebuild ();
+
+	std::vector<Node>							nodes;
+	std::vector<unsigned int>					freeNodes;
+	unsigned int								root;
+	std::unordered_map<int, unsigned int>		leafNodes;
+	std::vector<Instance>						pendingInstances;
+	std::unordered_map<int, unsigned int>		pendingPositions;
+	unsigned int								heightLimit;
+};
+
+template <typename ProcessorType>
+void InstanceBVH::EnumerateRayInstances (const Geometry::Ray& ray, ProcessorType processor) const
+{
+	double maxDistance = std::numeric_limits<double>::max ();
+	EnumerateRayInstances (ray, maxDistance, processor);
+}
+
+template <typename ProcessorType>
+void InstanceBVH::EnumerateRayInstances (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const
+{
+	if (!IsUpToDate ()) {
+		throw std::logic_error ("instance tree is not up to date");
+	}
+	BVHRay nodeRay (ray);
+	double rootDistance = 0.0;
+	if (root == NoNode || !nodeRay.HitsBox (nodes[root].min, nodes[root].max, maxDistance, rootDistance)) {
+		return;
+	}
+
+	// the nearer child is visited first, so a decreasing maxDistance skips more nodes
+	unsigned int stack[MaxTreeDepth + 2];
+	double stackDistances[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = root;
+	stackDistances[stackSize++] = rootDistance;
+	while (stackSize > 0 && maxDistance >= 0.0) {
+		stackSize--;
+		if (stackDistances[stackSize] > maxDistance) {
+			continue;
+		}
+		const Node& node = nodes[stack[stackSize]];
+		if (node.child1 == NoNode) {
+			processor (node.instanceId);
+			continue;
+		}
+
+		unsigned int nearChild = node.child1;
+		unsigned int farChild = node.child2;
+		double nearDistance = 0.0;
+		double farDistance = 0.0;
+		bool hitsNear = nodeRay.HitsBox (nodes[nearChild].min, nodes[nearChild].max, maxDistance, nearDistance);
+		bool hitsFar = nodeRay.HitsBox (nodes[farChild].min, nodes[farChild].max, maxDistance, farDistance);
+		if (hitsNear && hitsFar && farDistance < nearDistance) {
+			std::swap (nearChild, farChild);
+			std::swap (nearDistance, farDistance);
+		} else if (!hitsNear) {
+			nearChild = farChild;
+			nearDistance = farDistance;
+			hitsNear = hitsFar;
+			hitsFar = false;
+		}
+		if (hitsFar) {
+			stack[stackSize] = farChild;
+			stackDistances[stackSize++] = farDistance;
+		}
+		if (hitsNear) {
+			stack[stackSize] = nearChild;
+			stackDistances[stackSize++] = nearDistance;
+		}
+	}
+}
+
+template <typename ProcessorType>
+void InstanceBVH::EnumerateRayPacketInstances (const RayPacket& packet, ProcessorType processor) const
+{
+	if (!IsUpToDate ()) {
+		throw std::logic_error ("instance tree is not up to date");
+	}
+	double rootDistance = 0.0;
+	if (root == NoNode || !packet.HitsBox (nodes[root].min, nodes[root].max, rootDistance)) {
+		return;
+	}
+
+	unsigned int stack[MaxTreeDepth + 2];
+	double stackDistances[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = root;
+	stackDistances[stackSize++] = rootDistance;
+	while (stackSize > 0) {
+		stackSize--;
+		if (stackDistances[stackSize] > packet.GetMaxDistance ()) {
+			continue;
+		}
+		const Node& node = nodes[stack[stackSize]];
+		if (node.child1 == NoNode) {
+			processor (node.instanceId);
+			continue;
+		}
+
+		unsigned int nearChild = node.child1;
+		unsigned int farChild = node.child2;
+		double nearDistance = 0.0;
+		double farDistance = 0.0;
+		bool hitsNear = packet.HitsBox (nodes[nearChild].min, nodes[nearChild].max, nearDistance);
+		bool hitsFar = packet.HitsBox (nodes[farChild].min, nodes[farChild].max, farDistance);
+		if (hitsNear && hitsFar && farDistance < nearDistance) {
+			std::swap (nearChild, farChild);
+			std::swap (nearDistance, farDistance);
+		} else if (!hitsNear) {
+			nearChild = farChild;
+			nearDistance = farDistance;
+			hitsNear = hitsFar;
+			hitsFar = false;
+		}
+		if (hitsFar) {
+			stack[stackSize] = farChild;
+			stackDistances[stackSize++] = farDistance;
+		}
+		if (hitsNear) {
+			stack[stackSize] = nearChild;
+			stackDistances[stackSize++] = nearDistance;
+		}
+	}
+}
+
+template <typename ProcessorType>
+void InstanceBVH::EnumerateFrustumInstances (const Geometry::Frustum& frustum, ProcessorType processor) const
+{
+	if (!IsUpToDate ()) {
+		throw std::logic_error ("instance tree is not up to date");
+	}
+	if (root == NoNode) {
+		return;
+	}
+
+	unsigned int stack[MaxTreeDepth + 2];
+	bool stackInside[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = root;
+	stackInside[stackSize++] = false;
+	while (stackSize > 0) {
+		stackSize--;
+		const Node& node = nodes[stack[stackSize]];
+		bool isInside = stackInside[stackSize];
+		if (!isInside) {
+			Geometry::FrustumBoxRelation relation = frustum.GetBoxRelation (node.min, node.max);
+			if (relation == Geometry::FrustumBoxRelation::Outside) {
+				continue;
+			}
+			isInside = (relation == Geometry::FrustumBoxRelation::Inside);
+		}
+		if (node.child1 == NoNode) {
+			processor (node.instanceId, isInside);
+		} else {
+			stack[stackSize] = node.child1;
+			stackInside[stackSize++] = isInside;
+			stack[stackSize] = node.child2;
+			stackInside[stackSize++] = isInside;
+		}
+	}
+}
+
+}
+
+#endif
@@ -4,10 +4,103 @@
 #include "TriangleUtils.hpp"
 
 #include <atomic>
+#include <cmath>
+#include <limits>
+
+static_assert (sizeof (glm::dvec3) == 3 * sizeof (double), "");
+static_assert (sizeof (Modeler::MeshTriangle) == 6 * sizeof (unsigned int), "");
 
 namespace Modeler
 {
 
+static const short CompactNormalMax = 32767;
+static const double CompactNormalScale = 32767.0;
+
+static double GetCompactStep (const Geometry::BoundingBox& bounds)
+{
+	double extent = 0.0;
+	if (bounds.IsValid ()) {
+		glm::dvec3 size = bounds.GetMax () - bounds.GetMin ();
+		extent = std::max (std::max (size.x, size.y), size.z);
+	}
+	int exponent = 0;
+	std::frexp (extent, &exponent);
+	return std::ldexp (1.0, exponent - 23);
+}
+
+static glm::dvec3 GetCompactOrigin (const Geometry::BoundingBox& bounds, double step)
+{
+	if (!bounds.IsValid ()) {
+		return glm::dvec3 (0.0);
+	}
+	return glm::round (bounds.GetMin () / step) * step;
+}
+
+static glm::vec3 EncodeVertex (const glm::dvec3& vertex, const glm::dvec3& origin, double step)
+{
+	return glm::vec3 (glm::round ((vertex - origin) / step) * step);
+}
+
+static glm::dvec3 DecodeVertex (const glm::vec3& vertex, const glm::dvec3& origin)
+{
+	return origin + glm::dvec3 (vertex);
+}
+
+static glm::dvec2 WrapOctahedron (const glm::dvec2& point)
+{
+	glm::dvec2 sign (point.x >= 0.0 ? 1.0 : -1.0, point.y >= 0.0 ? 1.0 : -1.0);
+	return (1.0 - glm::abs (glm::dvec2 (point.y, point.x))) * sign;
+}
+
+static glm::dvec3 DecodeNormal (const glm::i16vec2& normal)
+{
+	glm::dvec2 point = glm::dvec2 (normal) / CompactNormalScale;
+	double z = 1.0 - std::abs (point.x) - std::abs (point.y);
+	if (z < 0.0) {
+		point = WrapOctahedron (point);
+	}
+	return glm::normalize (glm::dvec3 (point, z));
+}
+
+static glm::i16vec2 EncodeNormal (const glm::dvec3& normal)
+{
+	double length = std::abs (normal.x) + std::abs (normal.y) + std::abs (normal.z);
+	if (length == 0.0) {
+		return glm::i16vec2 (0, 0);
+	}
+	glm::dvec2 point = glm::dvec2 (normal) / length;
+	if (normal.z < 0.0) {
+		point = WrapOctahedron (point);
+	}
+	point = glm::clamp (point, -1.0, 1.0) * CompactNormalScale;
+
+	// choose the nearest of the surrounding grid points, so an already decoded
+	// normal always gets back its own code
+	glm::dvec3 unitNormal = glm::normalize (normal);
+	glm::i16vec2 result;
+	double minDistance = std::numeric_limits<double>::max ();
+	for (double x : { std::floor (point.x), std::ceil (point.x) }) {
+		for (double y : { std::floor (point.y), std::ceil (point.y) }) {
+			glm::i16vec2 candidate ((short) x, (short) y);
+			double distance = glm::distance (DecodeNormal (candidate), unitNormal);
+			if (distance < minDistance) {
+				minDistance = distance;
+				result = candidate;
+			}
+		}
+	}
+
+	// the opposite halves of the square's border fold onto the same normals,
+	// keep only one of them so equal normals always get the same code
+	if (result.y == CompactNormalMax || result.y == -CompactNormalMax) {
+		result.x = (short) std::abs (result.x);
+	}
+	if (result.x == CompactNormalMax || result.x == -CompactNormalMax) {
+		result.y = (short) std::abs (result.y);
+	}
+	return result;
+}
+
 const Material DefaultMaterial (glm::dvec3 (0.0f, 0.5f, 0.7f));
 
 Material::Material () :
@@ -32,6 +125,16 @@ void Material::SetColor (const glm::dvec3& newColor)
 	color = newColor;
 }
 
+bool Material::operator== (const Material& rhs) const
+{
+	return color == rhs.color;
+}
+
+bool Material::operator!= (const Material& rhs) const
+{
+	return !operator== (rhs);
+}
+
 Checksum Material::CalcCheckSum () const
 {
 	Checksum result;
@@ -41,6 +144,11 @@ Checksum Material::CalcCheckSum () const
 	return result;
 }
 
+size_t Material::CalcMemorySize () const
+{
+	return sizeof (Material);
+}
+
 MeshTriangle::MeshTriangle (unsigned int v1, unsigned int v2, unsigned int v3,
 							unsigned int n1, unsigned int n2, unsigned int n3) :
 	v1 (v1),
@@ -53,6 +161,16 @@ MeshTriangle::MeshTriangle (unsigned int v1, unsigned int v2, unsigned int v3,
 
 }
 
+bool MeshTriangle::operator== (const MeshTriangle& rhs) const
+{
+	return v1 == rhs.v1 && v2 == rhs.v2 && v3 == rhs.v3 && n1 == rhs.n1 && n2 == rhs.n2 && n3 == rhs.n3;
+}
+
+bool MeshTriangle::operator!= (const MeshTriangle& rhs) const
+{
+	return !operator== (rhs);
+}
+
 Checksum MeshTriangle::CalcCheckSum () const
 {
 	Checksum result;
@@ -65,11 +183,54 @@ Checksum MeshTriangle::CalcCheckSum () const
 	return result;
 }
 
-MeshGeometry::MeshGeometry ()
+MeshMaterialRange::MeshMaterialRange (MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount) :
+	materialId (materialId),
+	firstTriangle (firstTriangle),
+	triangleCount (triangleCount)
 {
 
 }
 
+bool MeshMaterialRange::operator== (const MeshMaterialRange& rhs) const
+{
+	return materialId == rhs.materialId && firstTriangle == rhs.firstTriangle && triangleCount == rhs.triangleCount;
+}
+
+bool MeshMaterialRange::operator!= (const MeshMaterialRange& rhs) const
+{
+	return !operator== (rhs);
+}
+
+Checksum MeshMaterialRange::CalcCheckSum () const
+{
+	Checksum result;
+	result.Add (materialId);
+	result.Add (firstTriangle);
+	result.Add (triangleCount);
+	return result;
+}
+
+MeshGeometry::MeshGeometry () :
+	data (GetEmptyData ())
+{
+
+}
+
+MeshGeometry::MeshGeometry (MeshGeometry&& rhs) :
+	data (std::move (rhs.data))
+{
+	rhs.data = GetEmptyData ();
+}
+
+MeshGeometry& MeshGeometry::operator= (MeshGeometry&& rhs)
+{
+	if (this != &rhs) {
+		data = std::move (rhs.data);
+		rhs.data = GetEmptyData ();
+	}
+	return *this;
+}
+
 unsigned int MeshGeometry::AddVertex (double x, double y, double z)
 {
 	return AddVertex (glm::dvec3 (x, y, z));
@@ -77,9 +238,18 @@ unsigned int MeshGeometry::AddVertex (double x, double y, double z)
 
 unsigned int MeshGeometry::AddVertex (const glm::dvec3& vertex)
 {
-	bounds.AddPoint (vertex);
-	vertices.push_back (vertex);
-	return (unsigned int) vertices.size () - 1;
+	Data& mutableData = GetMutableData ();
+	if (mutableData.storage == MeshGeometryStorage::Double) {
+		mutableData.bounds.AddPoint (vertex);
+		mutableData.vertices.push_back (vertex);
+		mutableData.verticesChecksum.AddData (&vertex, sizeof (glm::dvec3));
+		return (unsigned int) mutableData.vertices.size () - 1;
+	}
+	glm::vec3 compactVertex = EncodeVertex (vertex, mutableData.compactOrigin, mutableData.compactStep);
+	mutableData.bounds.AddPoint (DecodeVertex (compactVertex, mutableData.compactOrigin));
+	mutableData.compactVertices.push_back (compactVertex);
+	mutableData.verticesChecksum.AddData (&compactVertex, sizeof (glm::vec3));
+	return (unsigned int) mutableData.compactVertices.size () - 1;
 }
 
 unsigned int MeshGeometry::AddNormal (double x, double y, double z)
@@ -89,13 +259,21 @@ unsigned int MeshGeometry::AddNormal (double x, double y, double z)
 
 unsigned int MeshGeometry::AddNormal (const glm::dvec3& normal)
 {
-	normals.push_back (normal);
-	return (unsigned int) normals.size () - 1;
+	Data& mutableData = GetMutableData ();
+	if (mutableData.storage == MeshGeometryStorage::Double) {
+		mutableData.normals.push_back (normal);
+		mutableData.normalsChecksum.AddData (&normal, sizeof (glm::dvec3));
+		return (unsigned int) mutableData.normals.size () - 1;
+	}
+	glm::i16vec2 compactNormal = EncodeNormal (normal);
+	mutableData.compactNormals.push_back (compactNormal);
+	mutableData.normalsChecksum.AddData (&compactNormal, sizeof (glm::i16vec2));
+	return (unsigned int) mutableData.compactNormals.size () - 1;
 }
 
 unsigned int MeshGeometry::AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3)
 {
-	glm::dvec3 normal = Geometry::CalculateTriangleNormal (vertices[v1], vertices[v2], vertices[v3]);
+	glm::dvec3 normal = Geometry::CalculateTriangleNormal (GetVertex (v1), GetVertex (v2), GetVertex (v3));
 	unsigned int normalIndex = (unsigned int) AddNormal (normal);
 	return AddTriangle (v1, v2, v3, normalIndex, normalIndex, normalIndex);
 }
@@ -107,157 +285,470 @@ unsigned int MeshGeometry::AddTriangle (unsigned int v1, unsigned int v2, unsign
 
 unsigned int MeshGeometry::AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3, unsigned int n1, unsigned int n2, unsigned int n3)
 {
-	triangles.push_back (MeshTriangle (v1, v2, v3, n1, n2, n3));
-	return (unsigned int) triangles.size () - 1;
+	Data& mutableData = GetMutableData ();
+	mutableData.triangles.push_back (MeshTriangle (v1, v2, v3, n1, n2, n3));
+	mutableData.trianglesChecksum.AddData (&mutableData.triangles.back (), sizeof (MeshTriangle));
+	return (unsigned int) mutableData.triangles.size () - 1;
+}
+
+void MeshGeometry::Reserve (unsigned int vertexCount, unsigned int normalCount, unsigned int triangleCount)
+{
+	Data& mutableData = GetMutableData ();
+	if (mutableData.storage == MeshGeometryStorage::Double) {
+		mutableData.vertices.reserve (vertexCount);
+		mutableData.normals.reserve (normalCount);
+	} else {
+		mutableData.compactVertices.reserve (vertexCount);
+		mutableData.compactNormals.reserve (normalCount);
+	}
+	mutableData.triangles.reserve (triangleCount);
+}
+
+unsigned int MeshGeometry::AppendVertices (const glm::dvec3* vertices, size_t count)
+{
+	unsigned int firstIndex = VertexCount ();
+	Data& mutableData = GetMutableData ();
+	if (mutableData.storage == MeshGeometryStorage::Double) {
+		for (size_t i = 0; i < count; i++) {
+			mutableData.bounds.AddPoint (vertices[i]);
+		}
+		mutableData.vertices.insert (mutableData.vertices.end (), vertices, vertices + count);
+		mutableData.verticesChecksum.AddData (vertices, count * sizeof (glm::dvec3));
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			AddVertex (vertices[i]);
+		}
+	}
+	return firstIndex;
+}
+
+unsigned int MeshGeometry::AppendNormals (const glm::dvec3* normals, size_t count)
+{
+	unsigned int firstIndex = NormalCount ();
+	Data& mutableData = GetMutableData ();
+	if (mutableData.storage == MeshGeometryStorage::Double) {
+		mutableData.normals.insert (mutableData.normals.end (), normals, normals + count);
+		mutableData.normalsChecksum.AddData (normals, count * sizeof (glm::dvec3));
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			AddNormal (normals[i]);
+		}
+	}
+	return firstIndex;
+}
+
+unsigned int MeshGeometry::AppendTriangles (const MeshTriangle* triangles, size_t count)
+{
+	Data& mutableData = GetMutableData ();
+	unsigned int firstIndex = (unsigned int) mutableData.triangles.size ();
+	mutableData.triangles.insert (mutableData.triangles.end (), triangles, triangles + count);
+	mutableData.trianglesChecksum.AddData (triangles, count * sizeof (MeshTriangle));
+	return firstIndex;
+}
+
+MeshGeometryStorage MeshGeometry::GetStorage () const
+{
+	return data->storage;
+}
+
+void MeshGeometry::SetStorage (MeshGeometryStorage newStorage)
+{
+	if (data->storage == newStorage) {
+		return;
+	}
+
+	std::vector<glm::dvec3> vertices;
+	std::vector<glm::dvec3> normals;
+	vertices.reserve (VertexCount ());
+	normals.reserve (NormalCount ());
+	for (unsigned int i = 0; i < VertexCount (); i++) {
+		vertices.push_back (GetVertex (i));
+	}
+	for (unsigned int i = 0; i < NormalCount (); i++) {
+		normals.push_back (GetNormal (i));
+	}
+
+	std::shared_ptr<Data> newData = std::make_shared<Data> ();
+	newData->storage = newStorage;
+	if (newStorage == MeshGeometryStorage::Compact) {
+		newData->compactStep = GetCompactStep (data->bounds);
+		newData->compactOrigin = GetCompactOrigin (data->bounds, newData->compactStep);
+		newData->compactVertices.reserve (vertices.size ());
+		newData->compactNormals.reserve (normals.size ());
+	} else {
+		newData->vertices.reserve (vertices.size ());
+		newData->normals.reserve (normals.size ());
+	}
+	newData->triangles = data->triangles;
+	newData->trianglesChecksum = data->trianglesChecksum;
+
+	data = newData;
+	for (const glm::dvec3& vertex : vertices) {
+		AddVertex (vertex);
+	}
+	for (const glm::dvec3& normal : normals) {
+		AddNormal (normal);
+	}
 }
 
 unsigned int MeshGeometry::VertexCount () const
 {
-	return (unsigned int) vertices.size ();
+	if (data->storage == MeshGeometryStorage::Double) {
+		return (unsigned int) data->vertices.size ();
+	}
+	return (unsigned int) data->compactVertices.size ();
 }
 
 unsigned int MeshGeometry::NormalCount () const
 {
-	return (unsigned int) normals.size ();
+	if (data->storage == MeshGeometryStorage::Double) {
+		return (unsigned int) data->normals.size ();
+	}
+	return (unsigned int) data->compactNormals.size ();
 }
 
 unsigned int MeshGeometry::TriangleCount () const
 {
-	return (unsigned int) triangles.size ();
+	return (unsigned int) data->triangles.size ();
 }
 
-const glm::dvec3& MeshGeometry::GetVertex (unsigned int index) const
+glm::dvec3 MeshGeometry::GetVertex (unsigned int index) const
 {
-	return vertices[index];
+	if (data->storage == MeshGeometryStorage::Double) {
+		return data->vertices[index];
+	}
+	return DecodeVertex (data->compactVertices[index], data->compactOrigin);
 }
 
 glm::dvec3 MeshGeometry::GetVertex (unsigned int index, const glm::dmat4& transformation) const
 {
-	return glm::dvec3 (transformation * glm::dvec4 (vertices[index], 1.0));
+	return glm::dvec3 (transformation * glm::dvec4 (GetVertex (index), 1.0));
 }
 
-const glm::dvec3& MeshGeometry::GetNormal (unsigned int index) const
+glm::dvec3 MeshGeometry::GetNormal (unsigned int index) const
 {
-	return normals[index];
+	if (data->storage == MeshGeometryStorage::Double) {
+		return data->normals[index];
+	}
+	return DecodeNormal (data->compactNormals[index]);
 }
 
 glm::dvec3 MeshGeometry::GetNormal (unsigned int index, const glm::dmat4& transformation) const
 {
-	return glm::mat3 (transformation) * normals[index];
+	glm::dvec3 normal = GetNormal (index);
+	glm::dvec3 result;
+	Geometry::TransformNormals (transformation, &normal, 1, &result);
+	return result;
 }
 
 const MeshTriangle& MeshGeometry::GetTriangle (unsigned int index) const
 {
-	return triangles[index];
+	return data->triangles[index];
 }
 
-void MeshGeometry::EnumerateVertices (const glm::dmat4& transformation, const std::function<void (const glm::dvec3&)>& processor) const
+const std::vector<MeshTriangle>& MeshGeometry::GetTriangles () const
 {
-	for (const glm::dvec3& vertex : vertices) {
-		processor (glm::dvec3 (transformation * glm::dvec4 (vertex, 1.0)));
-	}
+	return data->triangles;
 }
 
-void MeshGeometry::EnumerateNormals (const glm::dmat4& transformation, const std::function<void (const glm::dvec3&)>& processor) const
+std::vector<glm::dvec3> MeshGeometry::GetTransformedVertices (const glm::dmat4& transformation) const
 {
-	glm::mat3 normalTransformation (transformation);
-	for (const glm::dvec3& normal : normals) {
-		processor (normalTransformation * normal);
-	}
+	std::vector<glm::dvec3> result (VertexCount ());
+	const glm::dvec3* vertices = GetVertices (0, result.size (), result.data ());
+	Geometry::TransformPoints (transformation, vertices, result.size (), result.data ());
+	return result;
 }
 
-void MeshGeometry::EnumerateTriangles (const std::function<void (const MeshTriangle&)>& processor) const
+std::vector<glm::dvec3> MeshGeometry::GetTransformedNormals (const glm::dmat4& transformation) const
 {
-	for (const MeshTriangle& triangle : triangles) {
-		processor (triangle);
-	}
+	std::vector<glm::dvec3> result (NormalCount ());
+	const glm::dvec3* normals = GetNormals (0, result.size (), result.data ());
+	Geometry::TransformNormals (transformation, normals, result.size (), result.data ());
+	return result;
 }
 
 const Geometry::BoundingBox& MeshGeometry::GetBoundingBox () const
 {
-	return bounds;
+	return data->bounds;
 }
 
-Checksum MeshGeometry::CalcCheckSum () const
+bool MeshGeometry::operator== (const MeshGeometry& rhs) const
 {
-	Checksum result;
-	for (const glm::dvec3& vec : vertices) {
-		result.Add (vec.x);
-		result.Add (vec.y);
-		result.Add (vec.z);
+	if (data == rhs.data) {
+		return true;
 	}
-	for (const glm::dvec3& vec : normals) {
-		result.Add (vec.x);
-		result.Add (vec.y);
-		result.Add (vec.z);
+	if (data->storage != rhs.data->storage || data->triangles != rhs.data->triangles) {
+		return false;
 	}
-	for (const MeshTriangle& tri : triangles) {
-		result.Add (tri.CalcCheckSum ());
+	if (data->storage == MeshGeometryStorage::Double) {
+		return data->vertices == rhs.data->vertices && data->normals == rhs.data->normals;
 	}
+	return	data->compactOrigin == rhs.data->compactOrigin &&
+			data->compactStep == rhs.data->compactStep &&
+			data->compactVertices == rhs.data->compactVertices &&
+			data->compactNormals == rhs.data->compactNormals;
+}
+
+bool MeshGeometry::operator!= (const MeshGeometry& rhs) const
+{
+	return !operator== (rhs);
+}
+
+Checksum MeshGeometry::CalcCheckSum () const
+{
+	Checksum result;
+	result.Add ((int) data->storage);
+	if (data->storage == MeshGeometryStorage::Compact) {
+		result.AddData (&data->compactOrigin, sizeof (glm::dvec3));
+		result.Add (data->compactStep);
+	}
+	result.Add (VertexCount ());
+	result.Add (data->verticesChecksum);
+	result.Add (NormalCount ());
+	result.Add (data->normalsChecksum);
+	result.Add (data->triangles.size ());
+	result.Add (data->trianglesChecksum);
+	return result;
+}
+
+size_t MeshGeometry::CalcMemorySize () const
+{
+	size_t result = sizeof (MeshGeometry) + sizeof (Data);
+	result += data->vertices.capacity () * sizeof (glm::dvec3);
+	result += data->normals.capacity () * sizeof (glm::dvec3);
+	result += data->compactVertices.capacity () * sizeof (glm::vec3);
+	result += data->compactNormals.capacity () * sizeof (glm::i16vec2);
+	result += data->triangles.capacity () * sizeof (MeshTriangle);
 	return result;
 }
 
 void MeshGeometry::Clear()
 {
-	vertices.clear ();
-	normals.clear ();
-	triangles.clear ();
+	data = GetEmptyData ();
 }
 
-MeshMaterials::MeshMaterials ()
+MeshGeometry::Data::Data () :
+	storage (MeshGeometryStorage::Double),
+	vertices (),
+	normals (),
+	triangles (),
+	bounds (),
+	compactOrigin (0.0),
+	compactStep (1.0),
+	compactVertices (),
+	compactNormals (),
+	verticesChecksum (),
+	normalsChecksum (),
+	trianglesChecksum ()
 {
 
 }
 
-MaterialId MeshMaterials::AddMaterial (const Material& material)
+const std::shared_ptr<MeshGeometry::Data>& MeshGeometry::GetEmptyData ()
 {
-	materials.push_back (material);
-	return (MaterialId) (materials.size () - 1);
+	static const std::shared_ptr<Data> emptyData = std::make_shared<Data> ();
+	return emptyData;
 }
 
-const Material& MeshMaterials::GetMaterial (MaterialId materialId) const
+MeshGeometry::Data& MeshGeometry::GetMutableData ()
+{
+	if (data.use_count () > 1) {
+		data = std::make_shared<Data> (*data);
+	}
+	return *data;
+}
+
+const glm::dvec3* MeshGeometry::GetVertices (size_t start, size_t count, glm::dvec3* buffer) const
+{
+	if (data->storage == MeshGeometryStorage::Double) {
+		return data->vertices.data () + start;
+	}
+	for (size_t i = 0; i < count; i++) {
+		buffer[i] = DecodeVertex (data->compactVertices[start + i], data->compactOrigin);
+	}
+	return buffer;
+}
+
+const glm::dvec3* MeshGeometry::GetNormals (size_t start, size_t count, glm::dvec3* buffer) const
+{
+	if (data->storage == MeshGeometryStorage::Double) {
+		return data->normals.data () + start;
+	}
+	for (size_t i = 0; i < count; i++) {
+		buffer[i] = DecodeNormal (data->compactNormals[start + i]);
+	}
+	return buffer;
+}
+
+const unsigned int MeshMaterials::NoRange;
+
+MeshMaterials::MeshMaterials () :
+	data (GetEmptyData ())
 {
-	return materials[materialId];
+
 }
 
-void MeshMaterials::EnumerateMaterials (const std::function<void (MaterialId, const Material&)>& processor) const
+MeshMaterials::MeshMaterials (MeshMaterials&& rhs) :
+	data (std::move (rhs.data))
 {
-	for (MaterialId materialId = 0; materialId < materials.size (); materialId++) {
-		processor (materialId, materials[materialId]);
+	rhs.data = GetEmptyData ();
+}
+
+MeshMaterials& MeshMaterials::operator= (MeshMaterials&& rhs)
+{
+	if (this != &rhs) {
+		data = std::move (rhs.data);
+		rhs.data = GetEmptyData ();
 	}
+	return *this;
+}
+
+MaterialId MeshMaterials::AddMaterial (const Material& material)
+{
+	Data& mutableData = GetMutableData ();
+	mutableData.materials.push_back (material);
+	mutableData.materialsChecksum.Add (material.CalcCheckSum ());
+	return (MaterialId) (mutableData.materials.size () - 1);
+}
+
+const Material& MeshMaterials::GetMaterial (MaterialId materialId) const
+{
+	return data->materials[materialId];
 }
 
 unsigned int MeshMaterials::MaterialCount () const
 {
-	return (unsigned int) materials.size ();
+	return (unsigned int) data->materials.size ();
 }
 
 void MeshMaterials::AddTriangleMaterial (MaterialId materialId)
 {
-	triangleMaterials.push_back (materialId);
+	AddTriangleMaterials (materialId, 1);
+}
+
+void MeshMaterials::AddTriangleMaterials (MaterialId materialId, unsigned int count)
+{
+	if (materialId < 0) {
+		throw std::out_of_range ("invalid material id");
+	}
+	if (count == 0) {
+		return;
+	}
+	Data& mutableData = GetMutableData ();
+	std::vector<MeshMaterialRange>& ranges = mutableData.triangleRanges;
+	if (!ranges.empty () && ranges.back ().materialId == materialId) {
+		ranges.back ().triangleCount += count;
+	} else {
+		if (!ranges.empty ()) {
+			mutableData.closedRangesChecksum.Add (ranges.back ().CalcCheckSum ());
+		}
+		unsigned int rangeIndex = (unsigned int) ranges.size ();
+		ranges.push_back (MeshMaterialRange (materialId, mutableData.triangleCount, count));
+		mutableData.nextRanges.push_back (NoRange);
+		if ((size_t) materialId >= mutableData.firstRangesByMaterial.size ()) {
+			mutableData.firstRangesByMaterial.resize (materialId + 1, NoRange);
+			mutableData.lastRangesByMaterial.resize (materialId + 1, NoRange);
+		}
+		unsigned int lastRange = mutableData.lastRangesByMaterial[materialId];
+		if (lastRange == NoRange) {
+			mutableData.firstRangesByMaterial[materialId] = rangeIndex;
+		} else {
+			mutableData.nextRanges[lastRange] = rangeIndex;
+		}
+		mutableData.lastRangesByMaterial[materialId] = rangeIndex;
+	}
+	mutableData.triangleCount += count;
 }
 
 MaterialId MeshMaterials::GetTriangleMaterial (unsigned int triangleIndex) const
 {
-	return triangleMaterials[triangleIndex];
+	if (triangleIndex >= data->triangleCount) {
+		throw std::out_of_range ("invalid triangle index");
+	}
+	const std::vector<MeshMaterialRange>& ranges = data->triangleRanges;
+	auto found = std::upper_bound (ranges.begin (), ranges.end (), triangleIndex, [&] (unsigned int index, const MeshMaterialRange& range) {
+		return index < range.firstTriangle;
+	});
+	return (found - 1)->materialId;
+}
+
+unsigned int MeshMaterials::TriangleCount () const
+{
+	return data->triangleCount;
+}
+
+unsigned int MeshMaterials::MaterialRangeCount () const
+{
+	return (unsigned int) data->triangleRanges.size ();
+}
+
+bool MeshMaterials::operator== (const MeshMaterials& rhs) const
+{
+	if (data == rhs.data) {
+		return true;
+	}
+	return data->materials == rhs.data->materials && data->triangleRanges == rhs.data->triangleRanges;
+}
+
+bool MeshMaterials::operator!= (const MeshMaterials& rhs) const
+{
+	return !operator== (rhs);
 }
 
 Checksum MeshMaterials::CalcCheckSum () const
 {
 	Checksum result;
-	for (const Material& material : materials) {
-		result.Add (material.CalcCheckSum ());
-	}
-	for (MaterialId materialId : triangleMaterials) {
-		result.Add (materialId);
+	result.Add (data->materials.size ());
+	result.Add (data->materialsChecksum);
+	result.Add (data->triangleRanges.size ());
+	result.Add (data->closedRangesChecksum);
+	if (!data->triangleRanges.empty ()) {
+		result.Add (data->triangleRanges.back ().CalcCheckSum ());
 	}
 	return result;
 }
 
+size_t MeshMaterials::CalcMemorySize () const
+{
+	size_t result = sizeof (MeshMaterials) + sizeof (Data);
+	result += data->materials.capacity () * sizeof (Material);
+	result += data->triangleRanges.capacity () * sizeof (MeshMaterialRange);
+	result += data->nextRanges.capacity () * sizeof (unsigned int);
+	result += data->firstRangesByMaterial.capacity () * sizeof (unsigned int);
+	result += data->lastRangesByMaterial.capacity () * sizeof (unsigned int);
+	return result;
+}
+
 void MeshMaterials::Clear()
 {
-	materials.clear ();
-	triangleMaterials.clear ();
+	data = GetEmptyData ();
+}
+
+MeshMaterials::Data::Data () :
+	materials (),
+	triangleRanges (),
+	triangleCount (0),
+	nextRanges (),
+	firstRangesByMaterial (),
+	lastRangesByMaterial (),
+	materialsChecksum (),
+	closedRangesChecksum ()
+{
+
+}
+
+const std::shared_ptr<MeshMaterials::Data>& MeshMaterials::GetEmptyData ()
+{
+	static const std::shared_ptr<Data> emptyData = std::make_shared<Data> ();
+	return emptyData;
+}
+
+MeshMaterials::Data& MeshMaterials::GetMutableData ()
+{
+	if (data.use_count () > 1) {
+		data = std::make_shared<Data> (*data);
+	}
+	return *data;
 }
 
 Mesh::Mesh () :
@@ -311,6 +802,27 @@ unsigned int Mesh::AddTriangle (unsigned int v1, unsigned int v2, unsigned int v
 	return geometry.AddTriangle (v1, v2, v3, n1, n2, n3);
 }
 
+void Mesh::Reserve (unsigned int vertexCount, unsigned int normalCount, unsigned int triangleCount)
+{
+	geometry.Reserve (vertexCount, normalCount, triangleCount);
+}
+
+unsigned int Mesh::AppendVertices (const glm::dvec3* vertices, size_t count)
+{
+	return geometry.AppendVertices (vertices, count);
+}
+
+unsigned int Mesh::AppendNormals (const glm::dvec3* normals, size_t count)
+{
+	return geometry.AppendNormals (normals, count);
+}
+
+unsigned int Mesh::AppendTriangles (const MeshTriangle* triangles, size_t count, MaterialId mat)
+{
+	materials.AddTriangleMaterials (mat, (unsigned int) count);
+	return geometry.AppendTriangles (triangles, count);
+}
+
 const MeshGeometry& Mesh::GetGeometry () const
 {
 	return geometry;
@@ -321,6 +833,16 @@ const MeshMaterials& Mesh::GetMaterials () const
 	return materials;
 }
 
+MeshGeometry Mesh::ReleaseGeometry ()
+{
+	return std::move (geometry);
+}
+
+MeshMaterials Mesh::ReleaseMaterials ()
+{
+	return std::move (materials);
+}
+
 const glm::dmat4& Mesh::GetTransformation () const
 {
 	return transformation;
@@ -345,22 +867,4 @@ void Mesh::Clear ()
 
 const Mesh EmptyMesh;
 
-void EnumerateTrianglesByMaterial (const MeshGeometry& geometry, const MeshMaterials& materials, const std::function<void (MaterialId, const std::vector<unsigned int>&)>& processor)
-{
-	std::vector<MaterialId> materialVector;
-	std::unordered_map<MaterialId, std::vector<unsigned int>> trianglesByMaterial;
-	for (MaterialId materialId = 0; materialId < (int) materials.MaterialCount (); materialId++) {
-		materialVector.push_back (materialId);
-		trianglesByMaterial.insert ({ materialId, std::vector<unsigned int> ()});
-	}
-	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
-		MaterialId materialId = materials.GetTriangleMaterial (i);
-		trianglesByMaterial[materialId].push_back (i);
-	};
-	std::sort (materialVector.begin (), materialVector.end ());
-	for (MaterialId materialId : materialVector) {
-		processor (materialId, trianglesByMaterial[materialId]);
-	}
-}
-
 }
@@ -4,8 +4,10 @@
 #include "Checksum.hpp"
 #include "IncludeGLM.hpp"
 #include "BoundingShapes.hpp"
+#include "Transformation.hpp"
 
 #include <vector>
+#include <algorithm>
 #include <unordered_set>
 #include <unordered_map>
 #include <memory>
@@ -24,7 +26,11 @@ public:
 	const glm::dvec3&	GetColor () const;
 	void				SetColor (const glm::dvec3& newColor);
 
+	bool				operator== (const Material& rhs) const;
+	bool				operator!= (const Material& rhs) const;
+
 	Checksum			CalcCheckSum () const;
+	size_t				CalcMemorySize () const;
 
 private:
 	glm::dvec3 color;
@@ -38,7 +44,10 @@ public:
 	MeshTriangle (	unsigned int v1, unsigned int v2, unsigned int v3,
 					unsigned int n1, unsigned int n2, unsigned int n3);
 
-	Checksum CalcCheckSum () const;
+	bool		operator== (const MeshTriangle& rhs) const;
+	bool		operator!= (const MeshTriangle& rhs) const;
+
+	Checksum	CalcCheckSum () const;
 
 	unsigned int	v1;
 	unsigned int	v2;
@@ -48,15 +57,41 @@ public:
 	unsigned int	n3;
 };
 
+class MeshMaterialRange
+{
+public:
+	MeshMaterialRange (MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount);
+
+	bool		operator== (const MeshMaterialRange& rhs) const;
+	bool		operator!= (const MeshMaterialRange& rhs) const;
+
+	Checksum	CalcCheckSum () const;
+
+	MaterialId		materialId;
+	unsigned int	firstTriangle;
+	unsigned int	triangleCount;
+};
+
+// Compact storage keeps positions as floats on a power of two grid relative
+// to the bounding box origin and normals as 16-bit octahedral coordinates.
+// Decoded values encode back to the same data, so values read from a compact
+// geometry survive being added to another compact geometry unchanged.
+
+enum class MeshGeometryStorage
+{
+	Double,
+	Compact
+};
+
 class MeshGeometry
 {
 public:
 	MeshGeometry ();
 	MeshGeometry (const MeshGeometry& rhs) = default;
-	MeshGeometry (MeshGeometry&& rhs) = default;
+	MeshGeometry (MeshGeometry&& rhs);
 
 	MeshGeometry&					operator= (const MeshGeometry& rhs) = default;
-	MeshGeometry&					operator= (MeshGeometry&& rhs) = default;
+	MeshGeometry&					operator= (MeshGeometry&& rhs);
 
 	unsigned int					AddVertex (double x, double y, double z);
 	unsigned int					AddVertex (const glm::dvec3& vertex);
@@ -68,31 +103,74 @@ public:
 	unsigned int					AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3, unsigned int normal);
 	unsigned int					AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3, unsigned int n1, unsigned int n2, unsigned int n3);
 
+	void							Reserve (unsigned int vertexCount, unsigned int normalCount, unsigned int triangleCount);
+	unsigned int					AppendVertices (const glm::dvec3* vertices, size_t count);
+	unsigned int					AppendNormals (const glm::dvec3* normals, size_t count);
+	unsigned int					AppendTriangles (const MeshTriangle* triangles, size_t count);
+
+	MeshGeometryStorage				GetStorage () const;
+	void							SetStorage (MeshGeometryStorage newStorage);
+
 	unsigned int					VertexCount () const;
 	unsigned int					NormalCount () const;
 	unsigned int					TriangleCount () const;
 
-	const glm::dvec3&				GetVertex (unsigned int index) const;
+	glm::dvec3						GetVertex (unsigned int index) const;
 	glm::dvec3						GetVertex (unsigned int index, const glm::dmat4& transformation) const;
 
-	const glm::dvec3&				GetNormal (unsigned int index) const;
+	glm::dvec3						GetNormal (unsigned int index) const;
 	glm::dvec3						GetNormal (unsigned int index, const glm::dmat4& transformation) const;
 
 	const MeshTriangle&				GetTriangle (unsigned int index) const;
+	const std::vector<MeshTriangle>&	GetTriangles () const;
 
-	void							EnumerateVertices (const glm::dmat4& transformation, const std::function<void (const glm::dvec3&)>& processor) const;
-	void							EnumerateNormals (const glm::dmat4& transformation, const std::function<void (const glm::dvec3&)>& processor) const;
-	void							EnumerateTriangles (const std::function<void (const MeshTriangle&)>& processor) const;
+	std::vector<glm::dvec3>			GetTransformedVertices (const glm::dmat4& transformation) const;
+	std::vector<glm::dvec3>			GetTransformedNormals (const glm::dmat4& transformation) const;
+
+	template <typename ProcessorType>
+	void							EnumerateVertices (const glm::dmat4& transformation, ProcessorType processor) const;
+	template <typename ProcessorType>
+	void							EnumerateNormals (const glm::dmat4& transformation, ProcessorType processor) const;
+	template <typename ProcessorType>
+	void							EnumerateTriangles (ProcessorType processor) const;
 
 	const Geometry::BoundingBox&	GetBoundingBox () const;
+
+	bool							operator== (const MeshGeometry& rhs) const;
+	bool							operator!= (const MeshGeometry& rhs) const;
+
 	Checksum						CalcCheckSum () const;
+	size_t							CalcMemorySize () const;
 	void							Clear ();
 
 private:
-	std::vector<glm::dvec3>			vertices;
-	std::vector<glm::dvec3>			normals;
-	std::vector<MeshTriangle>		triangles;
-	Geometry::BoundingBox			bounds;
+	struct Data
+	{
+		Data ();
+
+		MeshGeometryStorage			storage;
+		std::vector<glm::dvec3>		vertices;
+		std::vector<glm::dvec3>		normals;
+		std::vector<MeshTriangle>	triangles;
+		Geometry::BoundingBox		bounds;
+
+		glm::dvec3					compactOrigin;
+		double						compactStep;
+		std::vector<glm::vec3>		compactVertices;
+		std::vector<glm::i16vec2>	compactNormals;
+
+		Checksum					verticesChecksum;
+		Checksum					normalsChecksum;
+		Checksum					trianglesChecksum;
+	};
+
+	static const std::shared_ptr<Data>&	GetEmptyData ();
+	Data&								GetMutableData ();
+
+	const glm::dvec3*				GetVertices (size_t start, size_t count, glm::dvec3* buffer) const;
+	const glm::dvec3*				GetNormals (size_t start, size_t count, glm::dvec3* buffer) const;
+
+	std::shared_ptr<Data>			data;
 };
 
 class MeshMaterials
@@ -100,25 +178,58 @@ class MeshMaterials
 public:
 	MeshMaterials ();
 	MeshMaterials (const MeshMaterials& rhs) = default;
-	MeshMaterials (MeshMaterials&& rhs) = default;
+	MeshMaterials (MeshMaterials&& rhs);
 
 	MeshMaterials&			operator= (const MeshMaterials& rhs) = default;
-	MeshMaterials&			operator= (MeshMaterials&& MeshMaterials) = default;
+	MeshMaterials&			operator= (MeshMaterials&& rhs);
 
 	MaterialId				AddMaterial (const Material& material);
 	const Material&			GetMaterial (MaterialId materialId) const;
-	void					EnumerateMaterials (const std::function<void (MaterialId, const Material&)>& processor) const;
+	template <typename ProcessorType>
+	void					EnumerateMaterials (ProcessorType processor) const;
 	unsigned int			MaterialCount () const;
 
 	void					AddTriangleMaterial (MaterialId materialId);
+	void					AddTriangleMaterials (MaterialId materialId, unsigned int count);
 	MaterialId				GetTriangleMaterial (unsigned int triangleIndex) const;
+	unsigned int			TriangleCount () const;
+	unsigned int			MaterialRangeCount () const;
+	template <typename ProcessorType>
+	void					EnumerateTrianglesByMaterial (ProcessorType processor) const;
+
+	bool					operator== (const MeshMaterials& rhs) const;
+	bool					operator!= (const MeshMaterials& rhs) const;
 
 	Checksum				CalcCheckSum () const;
+	size_t					CalcMemorySize () const;
 	void					Clear ();
 
 private:
-	std::vector<Material>		materials;
-	std::vector<MaterialId>		triangleMaterials;
+	struct Data
+	{
+		Data ();
+
+		std::vector<Material>			materials;
+		std::vector<MeshMaterialRange>	triangleRanges;
+		unsigned int					triangleCount;
+
+		// the ranges of every material are linked in triangle order, so appending a range
+		// doesn't move the others, and enumeration by material needs no sorting
+		std::vector<unsigned int>		nextRanges;
+		std::vector<unsigned int>		firstRangesByMaterial;
+		std::vector<unsigned int>		lastRangesByMaterial;
+
+		// the last range may still grow, so only the ranges before it are in the checksum
+		Checksum						materialsChecksum;
+		Checksum						closedRangesChecksum;
+	};
+
+	static const unsigned int			NoRange = (unsigned int) -1;
+
+	static const std::shared_ptr<Data>&	GetEmptyData ();
+	Data&								GetMutableData ();
+
+	std::shared_ptr<Data>		data;
 };
 
 class Mesh
@@ -143,9 +254,17 @@ public:
 	unsigned int			AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3, unsigned int normal, MaterialId mat);
 	unsigned int			AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3, unsigned int n1, unsigned int n2, unsigned int n3, MaterialId mat);
 
+	void					Reserve (unsigned int vertexCount, unsigned int normalCount, unsigned int triangleCount);
+	unsigned int			AppendVertices (const glm::dvec3* vertices, size_t count);
+	unsigned int			AppendNormals (const glm::dvec3* normals, size_t count);
+	unsigned int			AppendTriangles (const MeshTriangle* triangles, size_t count, MaterialId mat);
+
 	const MeshGeometry&		GetGeometry () const;
 	const MeshMaterials&	GetMaterials () const;
 
+	MeshGeometry			ReleaseGeometry ();
+	MeshMaterials			ReleaseMaterials ();
+
 	const glm::dmat4&		GetTransformation () const;
 	void					SetTransformation (const glm::dmat4& newTransformation);
 	void					AddTransformation (const glm::dmat4& newTransformation);
@@ -160,7 +279,64 @@ private:
 
 extern const Mesh EmptyMesh;
 
-void EnumerateTrianglesByMaterial (const MeshGeometry& geometry, const MeshMaterials& materials, const std::function<void (MaterialId, const std::vector<unsigned int>&)>& processor);
+template <typename ProcessorType>
+void MeshGeometry::EnumerateVertices (const glm::dmat4& transformation, ProcessorType processor) const
+{
+	const size_t batchSize = 256;
+	glm::dvec3 transformed[batchSize];
+	size_t vertexCount = VertexCount ();
+	for (size_t start = 0; start < vertexCount; start += batchSize) {
+		size_t count = std::min (batchSize, vertexCount - start);
+		const glm::dvec3* vertices = GetVertices (start, count, transformed);
+		Geometry::TransformPoints (transformation, vertices, count, transformed);
+		for (size_t i = 0; i < count; i++) {
+			processor (transformed[i]);
+		}
+	}
+}
+
+template <typename ProcessorType>
+void MeshGeometry::EnumerateNormals (const glm::dmat4& transformation, ProcessorType processor) const
+{
+	const size_t batchSize = 256;
+	glm::dvec3 transformed[batchSize];
+	size_t normalCount = NormalCount ();
+	for (size_t start = 0; start < normalCount; start += batchSize) {
+		size_t count = std::min (batchSize, normalCount - start);
+		const glm::dvec3* normals = GetNormals (start, count, transformed);
+		Geometry::TransformNormals (transformation, normals, count, transformed);
+		for (size_t i = 0; i < count; i++) {
+			processor (transformed[i]);
+		}
+	}
+}
+
+template <typename ProcessorType>
+void MeshGeometry::EnumerateTriangles (ProcessorType processor) const
+{
+	for (const MeshTriangle& triangle : data->triangles) {
+		processor (triangle);
+	}
+}
+
+template <typename ProcessorType>
+void MeshMaterials::EnumerateMaterials (ProcessorType processor) const
+{
+	for (MaterialId materialId = 0; materialId < (MaterialId) data->materials.size (); materialId++) {
+		processor (materialId, data->materials[materialId]);
+	}
+}
+
+template <typename ProcessorType>
+void MeshMaterials::EnumerateTrianglesByMaterial (ProcessorType processor) const
+{
+	for (unsigned int firstRange : data->firstRangesByMaterial) {
+		for (unsigned int rangeIndex = firstRange; rangeIndex != NoRange; rangeIndex = data->nextRanges[rangeIndex]) {
+			const MeshMaterialRange& range = data->triangleRanges[rangeIndex];
+			processor (range.materialId, range.firstTriangle, range.triangleCount);
+		}
+	}
+}
 
 }
 
@@ -0,0 +1,329 @@
+#include "MeshBVH.hpp"
+#include "Geometry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace Modeler
+{
+
+static const unsigned int MaxLeafTriangleCount = 8;
+static const unsigned int BinCount = 16;
+
+// the cost of visiting a node compared to testing a triangle
+static const double TraversalCost = 1.0;
+
+// below this depth the splits are chosen by the surface area heuristic, then by the median,
+// which halves the triangles, so the depth can't exceed the traversal stack
+static const unsigned int MaxHeuristicDepth = 32;
+
+// the ray triangle intersection accepts hits slightly outside of the triangle
+static const double BoxInflation = 4.0 * Geometry::EPS;
+
+class TriangleBounds
+{
+public:
+	glm::dvec3	min;
+	glm::dvec3	max;
+	glm::dvec3	center;
+};
+
+class BuildTask
+{
+public:
+	unsigned int	node;
+	unsigned int	first;
+	unsigned int	count;
+	unsigned int	depth;
+};
+
+class Bin
+{
+public:
+	Bin () :
+		bounds (),
+		count (0)
+	{
+	}
+
+	Geometry::BoundingBox	bounds;
+	unsigned int			count;
+};
+
+static double GetSurfaceArea (const Geometry::BoundingBox& box)
+{
+	if (!box.IsValid ()) {
+		return 0.0;
+	}
+	glm::dvec3 size = box.GetMax () - box.GetMin ();
+	return 2.0 * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+RayPacket::RayPacket () :
+	rayCount (0)
+{
+	for (unsigned int i = 0; i < RayPacketSize; i++) {
+		originX[i] = originY[i] = originZ[i] = 0.0;
+		directionX[i] = directionY[i] = directionZ[i] = 0.0;
+		inverseDirectionX[i] = inverseDirectionY[i] = inverseDirectionZ[i] = 0.0;
+		maxDistances[i] = -1.0;
+	}
+}
+
+unsigned int RayPacket::RayCount () const
+{
+	return rayCount;
+}
+
+void RayPacket::AddRay (const glm::dvec3& origin, const glm::dvec3& direction, double maxDistance)
+{
+	if (rayCount >= RayPacketSize) {
+		throw std::logic_error ("ray packet is full");
+	}
+	originX[rayCount] = origin.x;
+	originY[rayCount] = origin.y;
+	originZ[rayCount] = origin.z;
+	directionX[rayCount] = direction.x;
+	directionY[rayCount] = direction.y;
+	directionZ[rayCount] = direction.z;
+	inverseDirectionX[rayCount] = (direction.x != 0.0) ? 1.0 / direction.x : std::numeric_limits<double>::max ();
+	inverseDirectionY[rayCount] = (direction.y != 0.0) ? 1.0 / direction.y : std::numeric_limits<double>::max ();
+	inverseDirectionZ[rayCount] = (direction.z != 0.0) ? 1.0 / direction.z : std::numeric_limits<double>::max ();
+	maxDistances[rayCount] = maxDistance;
+	rayCount++;
+}
+
+double RayPacket::GetMaxDistance () const
+{
+	double maxDistance = maxDistances[0];
+	for (unsigned int i = 1; i < RayPacketSize; i++) {
+		maxDistance = std::max (maxDistance, maxDistances[i]);
+	}
+	return maxDistance;
+}
+
+RayPacket RayPacket::Transform (const glm::dmat4& transformation) const
+{
+	RayPacket result;
+	for (unsigned int i = 0; i < rayCount; i++) {
+		glm::dvec3 origin (transformation * glm::dvec4 (originX[i], originY[i], originZ[i], 1.0));
+		glm::dvec3 direction (transformation * glm::dvec4 (directionX[i], directionY[i], directionZ[i], 0.0));
+		result.AddRay (origin, direction, maxDistances[i]);
+	}
+	return result;
+}
+
+bool RayPacket::HitsBox (const glm::dvec3& min, const glm::dvec3& max, double& entryDistance) const
+{
+	double entryDistances[RayPacketSize];
+	double exitDistances[RayPacketSize];
+	for (unsigned int i = 0; i < RayPacketSize; i++) {
+		double x1 = (min.x - originX[i]) * inverseDirectionX[i];
+		double x2 = (max.x - originX[i]) * inverseDirectionX[i];
+		double y1 = (min.y - originY[i]) * inverseDirectionY[i];
+		double y2 = (max.y - originY[i]) * inverseDirectionY[i];
+		double z1 = (min.z - originZ[i]) * inverseDirectionZ[i];
+		double z2 = (max.z - originZ[i]) * inverseDirectionZ[i];
+		entryDistances[i] = std::max (std::max (std::min (x1, x2), std::min (y1, y2)), std::max (std::min (z1, z2), 0.0));
+		exitDistances[i] = std::min (std::min (std::max (x1, x2), std::max (y1, y2)), std::min (std::max (z1, z2), maxDistances[i]));
+	}
+
+	bool hits = false;
+	entryDistance = std::numeric_limits<double>::max ();
+	for (unsigned int i = 0; i < RayPacketSize; i++) {
+		if (entryDistances[i] <= exitDistances[i]) {
+			hits = true;
+			entryDistance = std::min (entryDistance, entryDistances[i]);
+		}
+	}
+	return hits;
+}
+
+MeshBVH::MeshBVH () :
+	nodes (),
+	triangleIndices (),
+	maxDepth (0)
+{
+
+}
+
+MeshBVH::MeshBVH (const MeshGeometry& geometry) :
+	MeshBVH ()
+{
+	unsigned int triangleCount = geometry.TriangleCount ();
+	if (triangleCount == 0) {
+		return;
+	}
+
+	std::vector<glm::dvec3> vertices;
+	vertices.reserve (geometry.VertexCount ());
+	geometry.EnumerateVertices (glm::dmat4 (1.0), [&] (const glm::dvec3& vertex) {
+		vertices.push_back (vertex);
+	});
+
+	std::vector<TriangleBounds> triangleBounds (triangleCount);
+	triangleIndices.resize (triangleCount);
+	for (unsigned int i = 0; i < triangleCount; i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		const glm::dvec3& v1 = vertices[triangle.v1];
+		const glm::dvec3& v2 = vertices[triangle.v2];
+		const glm::dvec3& v3 = vertices[triangle.v3];
+		TriangleBounds& bounds = triangleBounds[i];
+		bounds.min = glm::min (glm::min (v1, v2), v3);
+		bounds.max = glm::max (glm::max (v1, v2), v3);
+		bounds.center = (bounds.min + bounds.max) * 0.5;
+		triangleIndices[i] = i;
+	}
+
+	nodes.push_back (Node ());
+	std::vector<BuildTask> tasks;
+	tasks.push_back ({ 0, 0, triangleCount, 1 });
+	while (!tasks.empty ()) {
+		BuildTask task = tasks.back ();
+		tasks.pop_back ();
+		maxDepth = std::max (maxDepth, task.depth);
+
+		Geometry::BoundingBox bounds;
+		Geometry::BoundingBox centerBounds;
+		for (unsigned int i = task.first; i < task.first + task.count; i++) {
+			const TriangleBounds& triangle = triangleBounds[triangleIndices[i]];
+			bounds.AddPoint (triangle.min);
+			bounds.AddPoint (triangle.max);
+			centerBounds.AddPoint (triangle.center);
+		}
+
+		glm::dvec3 size = bounds.GetMax () - bounds.GetMin ();
+		glm::dvec3 inflation (BoxInflation * std::max (std::max (size.x, size.y), size.z) + Geometry::EPS);
+		Node& node = nodes[task.node];
+		node.min = bounds.GetMin () - inflation;
+		node.max = bounds.GetMax () + inflation;
+		node.first = task.first;
+		node.triangleCount = task.count;
+		if (task.count <= 2) {
+			continue;
+		}
+
+		glm::dvec3 centerMin = centerBounds.GetMin ();
+		glm::dvec3 centerSize = centerBounds.GetMax () - centerMin;
+		unsigned int* first = &triangleIndices[task.first];
+		unsigned int* last = first + task.count;
+		unsigned int* middle = nullptr;
+
+		if (task.depth < MaxHeuristicDepth) {
+			int bestAxis = -1;
+			unsigned int bestSplit = 0;
+			double bestCost = std::numeric_limits<double>::max ();
+			std::array<Bin, BinCount> bins;
+			for (int axis = 0; axis < 3; axis++) {
+				if (centerSize[axis] <= 0.0) {
+					continue;
+				}
+				bins.fill (Bin ());
+				double binScale = BinCount / centerSize[axis];
+				for (unsigned int* it = first; it != last; ++it) {
+					const TriangleBounds& triangle = triangleBounds[*it];
+					unsigned int binIndex = std::min ((unsigned int) ((triangle.center[axis] - centerMin[axis]) * binScale), BinCount - 1);
+					bins[binIndex].bounds.AddPoint (triangle.min);
+					bins[binIndex].bounds.AddPoint (triangle.max);
+					bins[binIndex].count++;
+				}
+
+				std::array<double, BinCount> rightAreas;
+				std::array<unsigned int, BinCount> rightCounts;
+				Geometry::BoundingBox rightBounds;
+				unsigned int rightCount = 0;
+				for (unsigned int i = BinCount - 1; i > 0; i--) {
+					rightBounds.AddBox (bins[i].bounds);
+					rightCount += bins[i].count;
+					rightAreas[i] = GetSurfaceArea (rightBounds);
+					rightCounts[i] = rightCount;
+				}
+
+				Geometry::BoundingBox leftBounds;
+				unsigned int leftCount = 0;
+				for (unsigned int i = 1; i < BinCount; i++) {
+					leftBounds.AddBox (bins[i - 1].bounds);
+					leftCount += bins[i - 1].count;
+					if (leftCount == 0 || rightCounts[i] == 0) {
+						continue;
+					}
+					double cost = GetSurfaceArea (leftBounds) * leftCount + rightAreas[i] * rightCounts[i];
+					if (cost < bestCost) {
+						bestAxis = axis;
+						bestSplit = i;
+						bestCost = cost;
+					}
+				}
+			}
+
+			if (bestAxis == -1) {
+				// every center is in the same place
+				if (task.count <= MaxLeafTriangleCount) {
+					continue;
+				}
+			} else {
+				double leafCost = GetSurfaceArea (bounds) * task.count;
+				double splitCost = GetSurfaceArea (bounds) * TraversalCost + bestCost;
+				if (task.count <= MaxLeafTriangleCount && leafCost <= splitCost) {
+					continue;
+				}
+				double binScale = BinCount / centerSize[bestAxis];
+				middle = std::partition (first, last, [&] (unsigned int triangleIndex) {
+					const TriangleBounds& triangle = triangleBounds[triangleIndex];
+					unsigned int binIndex = std::min ((unsigned int) ((triangle.center[bestAxis] - centerMin[bestAxis]) * binScale), BinCount - 1);
+					return binIndex < bestSplit;
+				});
+			}
+		}
+
+		if (middle == nullptr) {
+			int axis = 0;
+			for (int i = 1; i < 3; i++) {
+				if (centerSize[i] > centerSize[axis]) {
+					axis = i;
+				}
+			}
+			middle = first + task.count / 2;
+			std::nth_element (first, middle, last, [&] (unsigned int a, unsigned int b) {
+				return triangleBounds[a].center[axis] < triangleBounds[b].center[axis];
+			});
+		}
+
+		unsigned int leftCount = (unsigned int) (middle - first);
+		unsigned int childIndex = (unsigned int) nodes.size ();
+		nodes.push_back (Node ());
+		nodes.push_back (Node ());
+		nodes[task.node].first = childIndex;
+		nodes[task.node].triangleCount = 0;
+		tasks.push_back ({ childIndex, task.first, leftCount, task.depth + 1 });
+		tasks.push_back ({ childIndex + 1, task.first + leftCount, task.count - leftCount, task.depth + 1 });
+	}
+}
+
+bool MeshBVH::IsEmpty () const
+{
+	return nodes.empty ();
+}
+
+unsigned int MeshBVH::NodeCount () const
+{
+	return (unsigned int) nodes.size ();
+}
+
+unsigned int MeshBVH::MaxDepth () const
+{
+	return maxDepth;
+}
+
+unsigned int MeshBVH::TriangleCount () const
+{
+	return (unsigned int) triangleIndices.size ();
+}
+
+unsigned int MeshBVH::GetLeafTriangle (unsigned int position) const
+{
+	return triangleIndices[position];
+}
+
+}
@@ -0,0 +1,304 @@
+#ifndef MODELER_MESHBVH_HPP
+#define MODELER_MESHBVH_HPP
+
+#include "IncludeGLM.hpp"
+#include "Mesh.hpp"
+#include "Ray.hpp"
+#include "Frustum.hpp"
+
+#include <vector>
+#include <limits>
+#include <utility>
+
+namespace Modeler
+{
+
+// Ray prepared for the slab test against the boxes of bounding volume hierarchies, the boxes
+// are hit only in front of the origin.
+
+class BVHRay
+{
+public:
+	BVHRay (const Geometry::Ray& ray);
+
+	bool		HitsBox (const glm::dvec3& min, const glm::dvec3& max) const;
+	// entryDistance is the distance of the first point of the ray in the box
+	bool		HitsBox (const glm::dvec3& min, const glm::dvec3& max, double maxDistance, double& entryDistance) const;
+
+private:
+	glm::dvec3	origin;
+	glm::dvec3	inverseDirection;
+};
+
+// Rays traced together with the coordinates stored in separate arrays, so the loops over the
+// rays can be vectorized. The unused rays have negative max distance, so they hit nothing.
+
+static const unsigned int RayPacketSize = 4;
+
+class RayPacket
+{
+public:
+	RayPacket ();
+
+	unsigned int	RayCount () const;
+	void			AddRay (const glm::dvec3& origin, const glm::dvec3& direction, double maxDistance);
+	double			GetMaxDistance () const;
+
+	// the directions are not normalized, so the distances remain the same
+	RayPacket		Transform (const glm::dmat4& transformation) const;
+
+	// entryDistance is the smallest distance where a ray enters the box
+	bool			HitsBox (const glm::dvec3& min, const glm::dvec3& max, double& entryDistance) const;
+
+	unsigned int	rayCount;
+	double			originX[RayPacketSize];
+	double			originY[RayPacketSize];
+	double			originZ[RayPacketSize];
+	double			directionX[RayPacketSize];
+	double			directionY[RayPacketSize];
+	double			directionZ[RayPacketSize];
+	double			inverseDirectionX[RayPacketSize];
+	double			inverseDirectionY[RayPacketSize];
+	double			inverseDirectionZ[RayPacketSize];
+	double			maxDistances[RayPacketSize];
+};
+
+// Bounding volume hierarchy over the triangles of a mesh geometry in the space of the geometry,
+// built with the surface area heuristic. Every mesh which shares the geometry can use it by
+// transforming the ray into the space of the geometry. The boxes are slightly inflated, so
+// every triangle which the tolerant ray triangle intersection may hit is found.
+
+class MeshBVH
+{
+public:
+	MeshBVH ();
+	MeshBVH (const MeshGeometry& geometry);
+
+	bool					IsEmpty () const;
+	unsigned int			NodeCount () const;
+	unsigned int			MaxDepth () const;
+
+	// the triangles are stored in leaf order, the leaves refer to ranges of positions
+	unsigned int			TriangleCount () const;
+	unsigned int			GetLeafTriangle (unsigned int position) const;
+
+	// processor (triangleIndex) for the triangles in the leaves hit by the ray, the ray is in the
+	// space of the geometry, and its direction doesn't have to be normalized
+	template <typename ProcessorType>
+	void					EnumerateRayTriangles (const Geometry::Ray& ray, ProcessorType processor) const;
+
+	// the same for the leaves closer than maxDistance measured in ray direction lengths, the
+	// processor may decrease maxDistance to skip the farther leaves, or make it negative to stop
+	template <typename ProcessorType>
+	void					EnumerateRayTriangles (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const;
+
+	// processor (firstPosition, triangleCount) for the leaves hit by any ray of the packet, the
+	// processor may decrease the max distances of the packet to skip the farther leaves
+	template <typename ProcessorType>
+	void					EnumerateRayPacketLeaves (const RayPacket& packet, ProcessorType processor) const;
+
+	// processor (triangleIndex, isInside) for the triangles in the leaves which may intersect
+	// the frustum, isInside is true if the leaf is surely inside, the processor returns false to
+	// stop the enumeration
+	template <typename ProcessorType>
+	void					EnumerateFrustumTriangles (const Geometry::Frustum& frustum, ProcessorType processor) const;
+
+private:
+	static const unsigned int MaxTreeDepth = 64;
+
+	class Node
+	{
+	public:
+		glm::dvec3		min;
+		glm::dvec3		max;
+		unsigned int	first;
+		unsigned int	triangleCount;
+	};
+
+	std::vector<Node>			nodes;
+	std::vector<unsigned int>	triangleIndices;
+	unsigned int				maxDepth;
+};
+
+inline BVHRay::BVHRay (const Geometry::Ray& ray) :
+	origin (ray.GetOrigin ()),
+	inverseDirection ()
+{
+	// a huge value instead of infinity keeps zero times zero out of the slab test
+	const glm::dvec3& direction = ray.GetDirection ();
+	for (int i = 0; i < 3; i++) {
+		inverseDirection[i] = (direction[i] != 0.0) ? 1.0 / direction[i] : std::numeric_limits<double>::max ();
+	}
+}
+
+inline bool BVHRay::HitsBox (const glm::dvec3& min, const glm::dvec3& max) const
+{
+	double entryDistance = 0.0;
+	return HitsBox (min, max, std::numeric_limits<double>::max (), entryDistance);
+}
+
+inline bool BVHRay::HitsBox (const glm::dvec3& min, const glm::dvec3& max, double maxDistance, double& entryDistance) const
+{
+	double minDistance = 0.0;
+	for (int i = 0; i < 3; i++) {
+		double distance1 = (min[i] - origin[i]) * inverseDirection[i];
+		double distance2 = (max[i] - origin[i]) * inverseDirection[i];
+		minDistance = std::max (minDistance, std::min (distance1, distance2));
+		maxDistance = std::min (maxDistance, std::max (distance1, distance2));
+	}
+	entryDistance = minDistance;
+	return minDistance <= maxDistance;
+}
+
+template <typename ProcessorType>
+void MeshBVH::EnumerateRayTriangles (const Geometry::Ray& ray, ProcessorType processor) const
+{
+	double maxDistance = std::numeric_limits<double>::max ();
+	EnumerateRayTriangles (ray, maxDistance, processor);
+}
+
+template <typename ProcessorType>
+void MeshBVH::EnumerateRayTriangles (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const
+{
+	BVHRay nodeRay (ray);
+	double rootDistance = 0.0;
+	if (nodes.empty () || !nodeRay.HitsBox (nodes[0].min, nodes[0].max, maxDistance, rootDistance)) {
+		return;
+	}
+
+	// the nearer child is visited first, so a decreasing maxDistance skips more nodes
+	unsigned int stack[MaxTreeDepth + 2];
+	double stackDistances[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = 0;
+	stackDistances[stackSize++] = rootDistance;
+	while (stackSize > 0 && maxDistance >= 0.0) {
+		stackSize--;
+		if (stackDistances[stackSize] > maxDistance) {
+			continue;
+		}
+		const Node& node = nodes[stack[stackSize]];
+		if (node.triangleCount > 0) {
+			for (unsigned int i = node.first; i < node.first + node.triangleCount && maxDistance >= 0.0; i++) {
+				processor (triangleIndices[i]);
+			}
+			continue;
+		}
+
+		unsigned int nearChild = node.first;
+		unsigned int farChild = node.first + 1;
+		double nearDistance = 0.0;
+		double farDistance = 0.0;
+		bool hitsNear = nodeRay.HitsBox (nodes[nearChild].min, nodes[nearChild].max, maxDistance, nearDistance);
+		bool hitsFar = nodeRay.HitsBox (nodes[farChild].min, nodes[farChild].max, maxDistance, farDistance);
+		if (hitsNear && hitsFar && farDistance < nearDistance) {
+			std::swap (nearChild, farChild);
+			std::swap (nearDistance, farDistance);
+		} else if (!hitsNear) {
+			nearChild = farChild;
+			nearDistance = farDistance;
+			hitsNear = hitsFar;
+			hitsFar = false;
+		}
+		if (hitsFar) {
+			stack[stackSize] = farChild;
+			stackDistances[stackSize++] = farDistance;
+		}
+		if (hitsNear) {
+			stack[stackSize] = nearChild;
+			stackDistances[stackSize++] = nearDistance;
+		}
+	}
+}
+
+template <typename ProcessorType>
+void MeshBVH::EnumerateRayPacketLeaves (const RayPacket& packet, ProcessorType processor) const
+{
+	double rootDistance = 0.0;
+	if (nodes.empty () || !packet.HitsBox (nodes[0].min, nodes[0].max, rootDistance)) {
+		return;
+	}
+
+	unsigned int stack[MaxTreeDepth + 2];
+	double stackDistances[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = 0;
+	stackDistances[stackSize++] = rootDistance;
+	while (stackSize > 0) {
+		stackSize--;
+		if (stackDistances[stackSize] > packet.GetMaxDistance ()) {
+			continue;
+		}
+		const Node& node = nodes[stack[stackSize]];
+		if (node.triangleCount > 0) {
+			processor (node.first, node.triangleCount);
+			continue;
+		}
+
+		unsigned int nearChild = node.first;
+		unsigned int farChild = node.first + 1;
+		double nearDistance = 0.0;
+		double farDistance = 0.0;
+		bool hitsNear = packet.HitsBox (nodes[nearChild].min, nodes[nearChild].max, nearDistance);
+		bool hitsFar = packet.HitsBox (nodes[farChild].min, nodes[farChild].max, farDistance);
+		if (hitsNear && hitsFar && farDistance < nearDistance) {
+			std::swap (nearChild, farChild);
+			std::swap (nearDistance, farDistance);
+		} else if (!hitsNear) {
+			nearChild = farChild;
+			nearDistance = farDistance;
+			hitsNear = hitsFar;
+			hitsFar = false;
+		}
+		if (hitsFar) {
+			stack[stackSize] = farChild;
+			stackDistances[stackSize++] = farDistance;
+		}
+		if (hitsNear) {
+			stack[stackSize] = nearChild;
+			stackDistances[stackSize++] = nearDistance;
+		}
+	}
+}
+
+template <typename ProcessorType>
+void MeshBVH::EnumerateFrustumTriangles (const Geometry::Frustum& frustum, ProcessorType processor) const
+{
+	if (nodes.empty ()) {
+		return;
+	}
+
+	unsigned int stack[MaxTreeDepth + 2];
+	bool stackInside[MaxTreeDepth + 2];
+	unsigned int stackSize = 0;
+	stack[stackSize] = 0;
+	stackInside[stackSize++] = false;
+	while (stackSize > 0) {
+		stackSize--;
+		const Node& node = nodes[stack[stackSize]];
+		bool isInside = stackInside[stackSize];
+		if (!isInside) {
+			Geometry::FrustumBoxRelation relation = frustum.GetBoxRelation (node.min, node.max);
+			if (relation == Geometry::FrustumBoxRelation::Outside) {
+				continue;
+			}
+			isInside = (relation == Geometry::FrustumBoxRelation::Inside);
+		}
+		if (node.triangleCount > 0) {
+			for (unsigned int i = node.first; i < node.first + node.triangleCount; i++) {
+				if (!processor (triangleIndices[i], isInside)) {
+					return;
+				}
+			}
+		} else {
+			stack[stackSize] = node.first;
+			stackInside[stackSize++] = isInside;
+			stack[stackSize] = node.first + 1;
+			stackInside[stackSize++] = isInside;
+		}
+	}
+}
+
+}
+
+#endif
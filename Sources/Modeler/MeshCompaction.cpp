@@ -0,0 +1,269 @@
+#include "MeshCompaction.hpp"
+#include "ParallelFor.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+
+namespace Modeler
+{
+
+// coincident vertices of converted or concatenated meshes differ only by rounding errors
+const double DefaultWeldTolerance = 1.0e-9;
+
+// below this count starting threads costs more than welding on one thread
+static const size_t MinParallelVertexCount = 65536;
+
+class NormalHash
+{
+public:
+	std::size_t operator() (const glm::dvec3& normal) const
+	{
+		std::hash<double> hasher;
+		return hasher (normal.x) ^ (hasher (normal.y) * 31) ^ (hasher (normal.z) * 961);
+	}
+};
+
+static std::uint64_t GetCellKey (std::int64_t x, std::int64_t y, std::int64_t z)
+{
+	// different cells may get the same key, it only adds a few candidates to check
+	std::uint64_t key = (std::uint64_t) x * 73856093ull;
+	key ^= (std::uint64_t) y * 19349669ull;
+	key ^= (std::uint64_t) z * 83492791ull;
+	return key;
+}
+
+template <typename ProcessorType>
+static void EnumerateLowerNeighbours (const std::vector<glm::dvec3>& vertices, const std::vector<glm::i64vec3>& cells, const std::vector<std::pair<std::uint64_t, unsigned int>>& cellVertices, double tolerance, unsigned int vertexIndex, ProcessorType processor)
+{
+	const glm::dvec3& vertex = vertices[vertexIndex];
+	const glm::i64vec3& cell = cells[vertexIndex];
+	for (std::int64_t dx = -1; dx <= 1; dx++) {
+		for (std::int64_t dy = -1; dy <= 1; dy++) {
+			for (std::int64_t dz = -1; dz <= 1; dz++) {
+				std::uint64_t key = GetCellKey (cell.x + dx, cell.y + dy, cell.z + dz);
+				auto first = std::lower_bound (cellVertices.begin (), cellVertices.end (), std::make_pair (key, 0u));
+				for (auto it = first; it != cellVertices.end () && it->first == key; ++it) {
+					if (it->second < vertexIndex && glm::distance (vertex, vertices[it->second]) <= tolerance) {
+						processor (it->second);
+					}
+				}
+			}
+		}
+	}
+}
+
+static std::vector<unsigned int> WeldVertices (const std::vector<glm::dvec3>& vertices, double tolerance)
+{
+	std::vector<unsigned int> welded (vertices.size ());
+	if (vertices.empty ()) {
+		return welded;
+	}
+
+	Geometry::BoundingBox boundingBox;
+	for (const glm::dvec3& vertex : vertices) {
+		boundingBox.AddPoint (vertex);
+	}
+
+	// with zero tolerance only equal vertices are welded, they are in the same cell of any grid
+	double cellSize = tolerance;
+	if (cellSize == 0.0) {
+		glm::dvec3 size = boundingBox.GetMax () - boundingBox.GetMin ();
+		cellSize = std::max (std::max (size.x, size.y), size.z) / std::max (1.0, std::cbrt ((double) vertices.size ()));
+		if (cellSize == 0.0) {
+			cellSize = 1.0;
+		}
+	}
+
+	std::vector<glm::i64vec3> cells (vertices.size ());
+	std::vector<std::pair<std::uint64_t, unsigned int>> cellVertices (vertices.size ());
+	for (unsigned int i = 0; i < vertices.size (); i++) {
+		glm::dvec3 relative = (vertices[i] - boundingBox.GetMin ()) / cellSize;
+		cells[i] = glm::i64vec3 ((std::int64_t) std::floor (relative.x), (std::int64_t) std::floor (relative.y), (std::int64_t) std::floor (relative.z));
+		cellVertices[i] = { GetCellKey (cells[i].x, cells[i].y, cells[i].z), i };
+	}
+	std::sort (cellVertices.begin (), cellVertices.end ());
+
+	std::vector<size_t> bucketStarts;
+	for (size_t i = 0; i < cellVertices.size (); i++) {
+		if (i == 0 || cellVertices[i].first != cellVertices[i - 1].first) {
+			bucketStarts.push_back (i);
+		}
+	}
+	bucketStarts.push_back (cellVertices.size ());
+
+	// the pairs within the tolerance are collected in two passes, first counting, then storing
+	// the lower index neighbours of every vertex, the buckets are processed independently,
+	// because they only read the grid and write the data of their own vertices
+	bool isParallel = vertices.size () >= MinParallelVertexCount;
+	std::vector<size_t> neighbourStarts (vertices.size () + 1, 0);
+	ParallelForRanges (bucketStarts.size () - 1, isParallel, [&] (size_t firstBucket, size_t endBucket) {
+		for (size_t i = bucketStarts[firstBucket]; i < bucketStarts[endBucket]; i++) {
+			unsigned int vertexIndex = cellVertices[i].second;
+			size_t count = 0;
+			EnumerateLowerNeighbours (vertices, cells, cellVertices, tolerance, vertexIndex, [&] (unsigned int) {
+				count++;
+			});
+			neighbourStarts[vertexIndex + 1] = count;
+		}
+	});
+	for (size_t i = 0; i < vertices.size (); i++) {
+		neighbourStarts[i + 1] += neighbourStarts[i];
+	}
+
+	std::vector<unsigned int> neighbours (neighbourStarts.back ());
+	ParallelForRanges (bucketStarts.size () - 1, isParallel, [&] (size_t firstBucket, size_t endBucket) {
+		for (size_t i = bucketStarts[firstBucket]; i < bucketStarts[endBucket]; i++) {
+			unsigned int vertexIndex = cellVertices[i].second;
+			size_t next = neighbourStarts[vertexIndex];
+			EnumerateLowerNeighbours (vertices, cells, cellVertices, tolerance, vertexIndex, [&] (unsigned int neighbour) {
+				neighbours[next++] = neighbour;
+			});
+		}
+	});
+
+	// union-find over the pairs, the root of every group is its lowest index vertex, so the
+	// groups are the transitive closure of the pairs, and they don't depend on the order
+	for (unsigned int i = 0; i < vertices.size (); i++) {
+		welded[i] = i;
+	}
+	auto findRoot = [&] (unsigned int vertex) {
+		while (welded[vertex] != vertex) {
+			welded[vertex] = welded[welded[vertex]];
+			vertex = welded[vertex];
+		}
+		return vertex;
+	};
+	for (unsigned int i = 0; i < vertices.size (); i++) {
+		for (size_t j = neighbourStarts[i]; j < neighbourStarts[i + 1]; j++) {
+			unsigned int root1 = findRoot (i);
+			unsigned int root2 = findRoot (neighbours[j]);
+			if (root1 < root2) {
+				welded[root2] = root1;
+			} else if (root2 < root1) {
+				welded[root1] = root2;
+			}
+		}
+	}
+	for (unsigned int i = 0; i < vertices.size (); i++) {
+		welded[i] = findRoot (i);
+	}
+	return welded;
+}
+
+MeshGeometry CompactMeshGeometry (const MeshGeometry& geometry, double weldTolerance, std::vector<unsigned int>& keptTriangles)
+{
+	if (weldTolerance < 0.0) {
+		throw std::logic_error ("invalid weld tolerance");
+	}
+
+	std::vector<glm::dvec3> vertices;
+	vertices.reserve (geometry.VertexCount ());
+	geometry.EnumerateVertices (glm::dmat4 (1.0), [&] (const glm::dvec3& vertex) {
+		vertices.push_back (vertex);
+	});
+	std::vector<unsigned int> welded = WeldVertices (vertices, weldTolerance);
+
+	const unsigned int NoIndex = (unsigned int) -1;
+	std::vector<unsigned int> vertexMap (vertices.size (), NoIndex);
+	std::vector<unsigned int> normalMap (geometry.NormalCount (), NoIndex);
+	std::vector<MeshTriangle> triangles;
+	keptTriangles.clear ();
+	for (unsigned int i = 0; i < geometry.TriangleCount (); i++) {
+		const MeshTriangle& triangle = geometry.GetTriangle (i);
+		MeshTriangle weldedTriangle (welded[triangle.v1], welded[triangle.v2], welded[triangle.v3], triangle.n1, triangle.n2, triangle.n3);
+		if (weldedTriangle.v1 == weldedTriangle.v2 || weldedTriangle.v1 == weldedTriangle.v3 || weldedTriangle.v2 == weldedTriangle.v3) {
+			continue;
+		}
+		for (unsigned int vertex : { weldedTriangle.v1, weldedTriangle.v2, weldedTriangle.v3 }) {
+			vertexMap[vertex] = 0;
+		}
+		for (unsigned int normal : { weldedTriangle.n1, weldedTriangle.n2, weldedTriangle.n3 }) {
+			normalMap[normal] = 0;
+		}
+		triangles.push_back (weldedTriangle);
+		keptTriangles.push_back (i);
+	}
+
+	// the remaining vertices and normals keep their original order
+	std::vector<glm::dvec3> newVertices;
+	for (unsigned int i = 0; i < vertices.size (); i++) {
+		if (vertexMap[i] != NoIndex) {
+			vertexMap[i] = (unsigned int) newVertices.size ();
+			newVertices.push_back (vertices[i]);
+		}
+	}
+
+	std::vector<glm::dvec3> newNormals;
+	std::unordered_map<glm::dvec3, unsigned int, NormalHash> normalIndices;
+	for (unsigned int i = 0; i < normalMap.size (); i++) {
+		if (normalMap[i] == NoIndex) {
+			continue;
+		}
+		glm::dvec3 normal = geometry.GetNormal (i);
+		auto inserted = normalIndices.insert ({ normal, (unsigned int) newNormals.size () });
+		if (inserted.second) {
+			newNormals.push_back (normal);
+		}
+		normalMap[i] = inserted.first->second;
+	}
+
+	for (MeshTriangle& triangle : triangles) {
+		triangle = MeshTriangle (
+			vertexMap[triangle.v1], vertexMap[triangle.v2], vertexMap[triangle.v3],
+			normalMap[triangle.n1], normalMap[triangle.n2], normalMap[triangle.n3]
+		);
+	}
+
+	MeshGeometry result;
+	result.Reserve ((unsigned int) newVertices.size (), (unsigned int) newNormals.size (), (unsigned int) triangles.size ());
+	result.AppendVertices (newVertices.data (), newVertices.size ());
+	result.AppendNormals (newNormals.data (), newNormals.size ());
+	result.AppendTriangles (triangles.data (), triangles.size ());
+	result.SetStorage (geometry.GetStorage ());
+	return result;
+}
+
+Mesh CompactMesh (const MeshGeometry& geometry, const MeshMaterials& materials, double weldTolerance)
+{
+	if (materials.TriangleCount () != geometry.TriangleCount ()) {
+		throw std::logic_error ("invalid triangle materials");
+	}
+
+	std::vector<unsigned int> keptTriangles;
+	MeshGeometry compacted = CompactMeshGeometry (geometry, weldTolerance, keptTriangles);
+
+	Mesh result;
+	materials.EnumerateMaterials ([&] (MaterialId, const Material& material) {
+		result.AddMaterial (material);
+	});
+
+	const std::vector<MeshTriangle>& triangles = compacted.GetTriangles ();
+	std::vector<glm::dvec3> vertices = compacted.GetTransformedVertices (glm::dmat4 (1.0));
+	std::vector<glm::dvec3> normals = compacted.GetTransformedNormals (glm::dmat4 (1.0));
+	result.Reserve (compacted.VertexCount (), compacted.NormalCount (), compacted.TriangleCount ());
+	result.AppendVertices (vertices.data (), vertices.size ());
+	result.AppendNormals (normals.data (), normals.size ());
+
+	size_t rangeStart = 0;
+	while (rangeStart < keptTriangles.size ()) {
+		MaterialId material = materials.GetTriangleMaterial (keptTriangles[rangeStart]);
+		size_t rangeEnd = rangeStart + 1;
+		while (rangeEnd < keptTriangles.size () && materials.GetTriangleMaterial (keptTriangles[rangeEnd]) == material) {
+			rangeEnd++;
+		}
+		result.AppendTriangles (triangles.data () + rangeStart, rangeEnd - rangeStart, material);
+		rangeStart = rangeEnd;
+	}
+
+	return result;
+}
+
+Mesh CompactMesh (const Mesh& mesh, double weldTolerance)
+{
+	Mesh result = CompactMesh (mesh.GetGeometry (), mesh.GetMaterials (), weldTolerance);
+	result.SetTransformation (mesh.GetTransformation ());
+	return result;
+}
+
+}
@@ -0,0 +1,24 @@
+#ifndef MODELER_MESHCOMPACTION_HPP
+#define MODELER_MESHCOMPACTION_HPP
+
+#include "Mesh.hpp"
+
+#include <vector>
+
+namespace Modeler
+{
+
+extern const double DefaultWeldTolerance;
+
+// Welds vertices which are not farther from each other than the tolerance, merges equal
+// normals, drops unreferenced vertices and normals, and removes the triangles which became
+// degenerate. The welded groups are the transitive closure of the vertex pairs within the
+// tolerance, and they take the position of the lowest index vertex of the group.
+// The original indices of the remaining triangles are collected in keptTriangles.
+MeshGeometry	CompactMeshGeometry (const MeshGeometry& geometry, double weldTolerance, std::vector<unsigned int>& keptTriangles);
+Mesh			CompactMesh (const MeshGeometry& geometry, const MeshMaterials& materials, double weldTolerance);
+Mesh			CompactMesh (const Mesh& mesh, double weldTolerance);
+
+}
+
+#endif
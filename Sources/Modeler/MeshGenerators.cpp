@@ -1,9 +1,18 @@
 #include "MeshGenerators.hpp"
 #include "Geometry.hpp"
 
+#include <cstdint>
+#include <unordered_map>
+
 namespace Modeler
 {
 
+static const double DefaultChordalDeviation = 0.005;
+static const double DefaultMaxSegmentAngle = PI / 9.0;
+static const int MinCircleSegmentation = 6;
+static const int MaxCircleSegmentation = 1024;
+static const int MaxIcosphereFrequency = 128;
+
 static void AddRectangle (Mesh& mesh, unsigned int v1, unsigned int v2, unsigned int v3, unsigned int v4, MaterialId mat)
 {
 	mesh.AddTriangle (v1, v2, v3, mat);
@@ -69,12 +78,130 @@ static glm::dvec3 SphericalToCartesian (double radius, double theta, double phi)
 	);
 };
 
+class IcosphereEdgeVertexCache
+{
+public:
+	IcosphereEdgeVertexCache (std::vector<glm::dvec3>& vertices, unsigned int frequency) :
+		vertices (vertices),
+		frequency (frequency),
+		edgeFirstVertices ()
+	{
+	}
+
+	// the step-th of the frequency - 1 inner points of the edge counted from the start vertex,
+	// the points of an edge are created once and shared by the two triangles of the edge
+	unsigned int GetEdgeVertex (unsigned int startVertex, unsigned int endVertex, unsigned int step)
+	{
+		unsigned int minVertex = std::min (startVertex, endVertex);
+		unsigned int maxVertex = std::max (startVertex, endVertex);
+		std::uint64_t key = ((std::uint64_t) minVertex << 32) | (std::uint64_t) maxVertex;
+		auto inserted = edgeFirstVertices.insert ({ key, (unsigned int) vertices.size () });
+		if (inserted.second) {
+			for (unsigned int i = 1; i < frequency; i++) {
+				double weight = (double) i / (double) frequency;
+				vertices.push_back (glm::normalize (vertices[minVertex] * (1.0 - weight) + vertices[maxVertex] * weight));
+			}
+		}
+		unsigned int firstVertex = inserted.first->second;
+		if (startVertex == minVertex) {
+			return firstVertex + step - 1;
+		} else {
+			return firstVertex + frequency - step - 1;
+		}
+	}
+
+private:
+	std::vector<glm::dvec3>&							vertices;
+	unsigned int										frequency;
+	std::unordered_map<std::uint64_t, unsigned int>	edgeFirstVertices;
+};
+
 static void AddVertexAtDistance (Mesh& mesh, double a, double b, double c, double distance)
 {
 	glm::dvec3 vertex (a, b, c);
 	mesh.AddVertex (glm::normalize (vertex) * distance);
 }
 
+TessellationTolerance::TessellationTolerance () :
+	TessellationTolerance (DefaultChordalDeviation, DefaultMaxSegmentAngle)
+{
+}
+
+TessellationTolerance::TessellationTolerance (double chordalDeviation, double maxSegmentAngle) :
+	chordalDeviation (chordalDeviation),
+	maxSegmentAngle (maxSegmentAngle)
+{
+}
+
+bool TessellationTolerance::Check () const
+{
+	return Geometry::IsGreater (chordalDeviation, 0.0) && Geometry::IsGreater (maxSegmentAngle, 0.0) && Geometry::IsLowerOrEqual (maxSegmentAngle, PI / 2.0);
+}
+
+double TessellationTolerance::GetChordalDeviation () const
+{
+	return chordalDeviation;
+}
+
+double TessellationTolerance::GetMaxSegmentAngle () const
+{
+	return maxSegmentAngle;
+}
+
+bool TessellationTolerance::operator== (const TessellationTolerance& rhs) const
+{
+	return chordalDeviation == rhs.chordalDeviation && maxSegmentAngle == rhs.maxSegmentAngle;
+}
+
+bool TessellationTolerance::operator!= (const TessellationTolerance& rhs) const
+{
+	return !operator== (rhs);
+}
+
+int CalculateCircleSegmentation (double radius, const TessellationTolerance& tolerance)
+{
+	if (!tolerance.Check ()) {
+		throw std::logic_error ("invalid tessellation tolerance");
+	}
+	double segmentAngle = tolerance.GetMaxSegmentAngle ();
+	if (Geometry::IsLower (tolerance.GetChordalDeviation (), radius)) {
+		double chordalAngle = 2.0 * acos (1.0 - tolerance.GetChordalDeviation () / radius);
+		segmentAngle = std::min (segmentAngle, chordalAngle);
+	}
+	double segmentation = ceil ((2.0 * PI) / segmentAngle - Geometry::EPS);
+	if (segmentation >= (double) MaxCircleSegmentation) {
+		return MaxCircleSegmentation;
+	}
+	return std::max ((int) segmentation, MinCircleSegmentation);
+}
+
+int CalculateSphereSegmentation (double radius, const TessellationTolerance& tolerance)
+{
+	int circleSegmentation = CalculateCircleSegmentation (radius, tolerance);
+	return (circleSegmentation + 1) / 2;
+}
+
+int CalculateIcosphereFrequency (double radius, const TessellationTolerance& tolerance)
+{
+	if (!tolerance.Check ()) {
+		throw std::logic_error ("invalid tessellation tolerance");
+	}
+
+	// the edges of an icosphere are at most 1.2 times longer than the divided icosahedron edge,
+	// and its triangles deviate the most at their centers, about edge / sqrt (3) far from the corners
+	static const double maxEdgeRatio = 1.2;
+	double edgeAngle = tolerance.GetMaxSegmentAngle ();
+	if (Geometry::IsLower (tolerance.GetChordalDeviation (), radius)) {
+		double centerAngle = acos (1.0 - tolerance.GetChordalDeviation () / radius);
+		edgeAngle = std::min (edgeAngle, centerAngle * sqrt (3.0));
+	}
+	double frequency = ceil (maxEdgeRatio * atan (2.0) / edgeAngle - Geometry::EPS);
+	if (frequency >= (double) MaxIcosphereFrequency) {
+		return MaxIcosphereFrequency;
+	}
+	return std::max ((int) frequency, 1);
+}
+
 Mesh GenerateBox (const Material& material, const glm::dmat4& transformation, double xSize, double ySize, double zSize)
 {
 	NaiveTriangulator triangulator;
@@ -125,6 +252,12 @@ Mesh GenerateCone (const Material& material, const glm::dmat4& transformation, d
 	bool onePointBottom = Geometry::IsEqual (bottomRadius, 0.0);
 	bool onePointTop = Geometry::IsEqual (topRadius, 0.0);
 
+	unsigned int segments = (unsigned int) segmentation;
+	unsigned int capCount = (onePointBottom ? 0 : 1) + (onePointTop ? 0 : 1);
+	unsigned int sideTriangleCount = (onePointBottom || onePointTop) ? segments : 2 * segments;
+	unsigned int sideNormalCount = isSmooth ? 2 * segments : sideTriangleCount;
+	mesh.Reserve (2 + capCount * segments, capCount + sideNormalCount, capCount * segments + sideTriangleCount);
+
 	std::vector<unsigned int> bottomVertices;
 	if (onePointBottom) {
 		bottomVertices.push_back (mesh.AddVertex (glm::dvec3 (0.0, 0.0, 0.0)));
@@ -153,16 +286,34 @@ Mesh GenerateCone (const Material& material, const glm::dmat4& transformation, d
 	glm::dvec3 topNormalCenter (0.0, 0.0, height - topCenterOffset);
 	glm::dvec3 bottomNormalCenter (0.0, 0.0, 0.0 - bottomCenterOffset);
 
+	std::vector<unsigned int> bottomNormals;
+	std::vector<unsigned int> topNormals;
+	if (isSmooth) {
+		if (!onePointBottom) {
+			bottomNormals.reserve (segments);
+			for (unsigned int vertex : bottomVertices) {
+				bottomNormals.push_back (mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (vertex) - bottomNormalCenter)));
+			}
+		}
+		if (!onePointTop) {
+			topNormals.reserve (segments);
+			for (unsigned int vertex : topVertices) {
+				topNormals.push_back (mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (vertex) - topNormalCenter)));
+			}
+		}
+	}
+
 	if (onePointTop) {
-		for (size_t i = 0; i < segmentation; i++) {
+		for (unsigned int i = 0; i < segments; i++) {
+			unsigned int next = (i == segments - 1 ? 0 : i + 1);
 			unsigned int a = bottomVertices[i];
-			unsigned int b = bottomVertices[i == segmentation - 1 ? 0 : i + 1];
+			unsigned int b = bottomVertices[next];
 			unsigned int c = topVertices[0];
 			if (isSmooth) {
+				unsigned int an = bottomNormals[i];
+				unsigned int bn = bottomNormals[next];
 				glm::dvec3 aNormal = glm::normalize (mesh.GetGeometry ().GetVertex (a) - bottomNormalCenter);
 				glm::dvec3 bNormal = glm::normalize (mesh.GetGeometry ().GetVertex (b) - bottomNormalCenter);
-				unsigned int an = mesh.AddNormal (aNormal);
-				unsigned int bn = mesh.AddNormal (bNormal);
 				unsigned int cn = mesh.AddNormal (glm::normalize ((aNormal + bNormal) / 2.0));
 				mesh.AddTriangle (a, b, c, an, bn, cn, materialId);
 			} else {
@@ -170,32 +321,34 @@ Mesh GenerateCone (const Material& material, const glm::dmat4& transformation, d
 			}
 		}
 	} else if (onePointBottom) {
-		for (size_t i = 0; i < segmentation; i++) {
+		for (unsigned int i = 0; i < segments; i++) {
+			unsigned int next = (i == segments - 1 ? 0 : i + 1);
 			unsigned int a = bottomVertices[0];
-			unsigned int b = topVertices[i == segmentation - 1 ? 0 : i + 1];
+			unsigned int b = topVertices[next];
 			unsigned int c = topVertices[i];
 			if (isSmooth) {
+				unsigned int bn = topNormals[next];
+				unsigned int cn = topNormals[i];
 				glm::dvec3 bNormal = glm::normalize (mesh.GetGeometry ().GetVertex (b) - topNormalCenter);
 				glm::dvec3 cNormal = glm::normalize (mesh.GetGeometry ().GetVertex (c) - topNormalCenter);
 				unsigned int an = mesh.AddNormal (glm::normalize ((bNormal + cNormal) / 2.0));
-				unsigned int bn = mesh.AddNormal (bNormal);
-				unsigned int cn = mesh.AddNormal (cNormal);
 				mesh.AddTriangle (a, b, c, an, bn, cn, materialId);
 			} else {
 				mesh.AddTriangle (a, b, c, materialId);
 			}
 		}
 	} else {
-		for (size_t i = 0; i < segmentation; i++) {
+		for (unsigned int i = 0; i < segments; i++) {
+			unsigned int next = (i == segments - 1 ? 0 : i + 1);
 			unsigned int a = bottomVertices[i];
-			unsigned int b = bottomVertices[i == segmentation - 1 ? 0 : i + 1];
-			unsigned int c = topVertices[i == segmentation - 1 ? 0 : i + 1];
+			unsigned int b = bottomVertices[next];
+			unsigned int c = topVertices[next];
 			unsigned int d = topVertices[i];
 			if (isSmooth) {
-				unsigned int an = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (a) - bottomNormalCenter));
-				unsigned int bn = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (b) - bottomNormalCenter));
-				unsigned int cn = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (c) - topNormalCenter));
-				unsigned int dn = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (d) - topNormalCenter));
+				unsigned int an = bottomNormals[i];
+				unsigned int bn = bottomNormals[next];
+				unsigned int cn = topNormals[next];
+				unsigned int dn = topNormals[i];
 				mesh.AddTriangle (a, b, c, an, bn, cn, materialId);
 				mesh.AddTriangle (a, c, d, an, cn, dn, materialId);
 			} else {
@@ -215,6 +368,9 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 
 	unsigned int segments = (unsigned int) segmentation;
 	unsigned int circleSegments = segments * 2;
+	unsigned int triangleCount = 2 * circleSegments * (segments - 1);
+	unsigned int vertexCount = 2 + circleSegments * (segments - 1);
+	mesh.Reserve (vertexCount, isSmooth ? vertexCount : triangleCount, triangleCount);
 
 	unsigned int topVertex = mesh.AddVertex (SphericalToCartesian (radius, 0.0, 0.0));
 	double segmentAngle = PI / double (segments);
@@ -229,8 +385,12 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 	}
 	unsigned int bottomVertex = mesh.AddVertex (SphericalToCartesian (radius, PI, 0.0));
 
-	unsigned int topVertexNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (topVertex)));
-	unsigned int bottomVertexNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (bottomVertex)));
+	// in smooth mode every vertex has its own normal with the same index
+	if (isSmooth) {
+		for (unsigned int i = 0; i < vertexCount; i++) {
+			mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (i)));
+		}
+	}
 
 	for (unsigned int i = 1; i <= segments; i++) {
 		for (unsigned int j = 0; j < circleSegments; j++) {
@@ -240,9 +400,7 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 				unsigned int curr = offset + j;
 				unsigned int next = last ? offset : curr + 1;
 				if (isSmooth) {
-					unsigned int currNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (curr)));
-					unsigned int nextNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (next)));
-					mesh.AddTriangle (curr, next, topVertex, currNormal, nextNormal, topVertexNormal, materialId);
+					mesh.AddTriangle (curr, next, topVertex, curr, next, topVertex, materialId);
 				} else {
 					mesh.AddTriangle (curr, next, topVertex, materialId);
 				}
@@ -253,12 +411,8 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 				unsigned int top = curr - circleSegments;
 				unsigned int ntop = last ? offset - circleSegments : top + 1;
 				if (isSmooth) {
-					unsigned int currNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (curr)));
-					unsigned int nextNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (next)));
-					unsigned int topNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (top)));
-					unsigned int ntopNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (ntop)));
-					mesh.AddTriangle (curr, next, ntop, currNormal, nextNormal, ntopNormal, materialId);
-					mesh.AddTriangle (curr, ntop, top, currNormal, ntopNormal, topNormal, materialId);
+					mesh.AddTriangle (curr, next, ntop, curr, next, ntop, materialId);
+					mesh.AddTriangle (curr, ntop, top, curr, ntop, top, materialId);
 				} else {
 					AddRectangle (mesh, curr, next, ntop, top, materialId);
 				}
@@ -267,9 +421,7 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 				unsigned int curr = offset + j;
 				unsigned int next = last ? offset : curr + 1;
 				if (isSmooth) {
-					unsigned int currNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (curr)));
-					unsigned int nextNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (next)));
-					mesh.AddTriangle (curr, bottomVertex, next, currNormal, bottomVertexNormal, nextNormal, materialId);
+					mesh.AddTriangle (curr, bottomVertex, next, curr, bottomVertex, next, materialId);
 				} else {
 					mesh.AddTriangle (curr, bottomVertex, next, materialId);
 				}
@@ -280,6 +432,93 @@ Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation,
 	return mesh;
 }
 
+Mesh GenerateIcosphere (const Material& material, const glm::dmat4& transformation, double radius, int frequency, bool isSmooth)
+{
+	unsigned int divisions = (unsigned int) frequency;
+	unsigned int vertexCount = 10 * divisions * divisions + 2;
+	unsigned int triangleCount = 20 * divisions * divisions;
+
+	Mesh icosahedron = GeneratePlatonicSolid (material, glm::dmat4 (1.0), PlatonicSolidType::Icosahedron, 1.0);
+	const MeshGeometry& baseGeometry = icosahedron.GetGeometry ();
+
+	std::vector<glm::dvec3> vertices;
+	vertices.reserve (vertexCount);
+	for (unsigned int i = 0; i < baseGeometry.VertexCount (); i++) {
+		vertices.push_back (baseGeometry.GetVertex (i));
+	}
+
+	std::vector<std::array<unsigned int, 3>> triangles;
+	triangles.reserve (triangleCount);
+	IcosphereEdgeVertexCache edgeVertexCache (vertices, divisions);
+	std::vector<unsigned int> faceVertices ((divisions + 1) * (divisions + 1));
+	baseGeometry.EnumerateTriangles ([&] (const MeshTriangle& baseTriangle) {
+		// i, j and k are the barycentric weights of the first, second and third corner multiplied by the frequency
+		unsigned int a = baseTriangle.v1;
+		unsigned int b = baseTriangle.v2;
+		unsigned int c = baseTriangle.v3;
+		for (unsigned int i = 0; i <= divisions; i++) {
+			for (unsigned int j = 0; j <= divisions - i; j++) {
+				unsigned int k = divisions - i - j;
+				unsigned int vertex = 0;
+				if (i == divisions) {
+					vertex = a;
+				} else if (j == divisions) {
+					vertex = b;
+				} else if (k == divisions) {
+					vertex = c;
+				} else if (k == 0) {
+					vertex = edgeVertexCache.GetEdgeVertex (a, b, j);
+				} else if (i == 0) {
+					vertex = edgeVertexCache.GetEdgeVertex (b, c, k);
+				} else if (j == 0) {
+					vertex = edgeVertexCache.GetEdgeVertex (c, a, i);
+				} else {
+					glm::dvec3 position = vertices[a] * (double) i + vertices[b] * (double) j + vertices[c] * (double) k;
+					vertex = (unsigned int) vertices.size ();
+					vertices.push_back (glm::normalize (position));
+				}
+				faceVertices[i * (divisions + 1) + j] = vertex;
+			}
+		}
+		for (unsigned int i = 0; i < divisions; i++) {
+			for (unsigned int j = 0; j < divisions - i; j++) {
+				unsigned int curr = faceVertices[i * (divisions + 1) + j];
+				unsigned int nextI = faceVertices[(i + 1) * (divisions + 1) + j];
+				unsigned int nextJ = faceVertices[i * (divisions + 1) + j + 1];
+				triangles.push_back ({ nextI, nextJ, curr });
+				if (i + j < divisions - 1) {
+					unsigned int nextIJ = faceVertices[(i + 1) * (divisions + 1) + j + 1];
+					triangles.push_back ({ nextI, nextIJ, nextJ });
+				}
+			}
+		}
+	});
+
+	Mesh mesh;
+	MaterialId materialId = mesh.AddMaterial (material);
+	mesh.SetTransformation (transformation);
+	mesh.Reserve (vertexCount, isSmooth ? vertexCount : triangleCount, triangleCount);
+
+	// the vertices are on the unit sphere, so in smooth mode they are the normals with the same index
+	for (const glm::dvec3& vertex : vertices) {
+		mesh.AddVertex (vertex * radius);
+	}
+	if (isSmooth) {
+		for (const glm::dvec3& vertex : vertices) {
+			mesh.AddNormal (vertex);
+		}
+	}
+	for (const std::array<unsigned int, 3>& triangle : triangles) {
+		if (isSmooth) {
+			mesh.AddTriangle (triangle[0], triangle[1], triangle[2], triangle[0], triangle[1], triangle[2], materialId);
+		} else {
+			mesh.AddTriangle (triangle[0], triangle[1], triangle[2], materialId);
+		}
+	}
+
+	return mesh;
+}
+
 Mesh GenerateTorus (const Material& material, const glm::dmat4& transformation, double outerRadius, double innerRadius, int outerSegmentation, int innerSegmentation, bool isSmooth)
 {
 	Mesh mesh;
@@ -295,8 +534,12 @@ Mesh GenerateTorus (const Material& material, const glm::dmat4& transformation,
 
 	unsigned int outerSegments = (unsigned int) outerSegmentation;
 	unsigned int innerSegments = (unsigned int) innerSegmentation;
+	unsigned int triangleCount = 2 * outerSegments * innerSegments;
+	mesh.Reserve (outerSegments * innerSegments, isSmooth ? outerSegments * innerSegments : triangleCount, triangleCount);
+
 	double segmentAngle = (2.0 * PI) / double (outerSegmentation);
 	std::vector<glm::dvec3> outerCenterPoints;
+	outerCenterPoints.reserve (outerSegments);
 	for (unsigned int i = 0; i < outerSegments; i++) {
 		glm::dmat4 rotMatrix = glm::rotate (glm::dmat4 (1.0), i * segmentAngle, glm::dvec3 (0.0, 0.0, 1.0));
 		outerCenterPoints.push_back (glm::dvec3 (rotMatrix * glm::dvec4 (firstOuterCenter, 1.0)));
@@ -306,6 +549,16 @@ Mesh GenerateTorus (const Material& material, const glm::dmat4& transformation,
 		}
 	}
 
+	// in smooth mode every vertex has its own normal with the same index
+	if (isSmooth) {
+		for (unsigned int i = 0; i < outerSegments; i++) {
+			for (unsigned int j = 0; j < innerSegments; j++) {
+				unsigned int vertex = i * innerSegments + j;
+				mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (vertex) - outerCenterPoints[i]));
+			}
+		}
+	}
+
 	for (unsigned int i = 0; i < outerSegments; i++) {
 		bool outerLast = (i == outerSegments - 1);
 		for (unsigned j = 0; j < innerSegments; j++) {
@@ -326,14 +579,8 @@ Mesh GenerateTorus (const Material& material, const glm::dmat4& transformation,
 				top = i * innerSegments;
 			}
 			if (isSmooth) {
-				glm::dvec3 firstCenterPoint = outerCenterPoints[i];
-				glm::dvec3 secondCenterPoint = outerCenterPoints[outerLast ? 0 : i + 1];
-				unsigned int currNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (curr) - firstCenterPoint));
-				unsigned int nextNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (next) - secondCenterPoint));
-				unsigned int ntopNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (ntop) - secondCenterPoint));
-				unsigned int topNormal = mesh.AddNormal (glm::normalize (mesh.GetGeometry ().GetVertex (top) - firstCenterPoint));
-				mesh.AddTriangle (curr, next, ntop, currNormal, nextNormal, ntopNormal, materialId);
-				mesh.AddTriangle (curr, ntop, top, currNormal, ntopNormal, topNormal, materialId);
+				mesh.AddTriangle (curr, next, ntop, curr, next, ntop, materialId);
+				mesh.AddTriangle (curr, ntop, top, curr, ntop, top, materialId);
 			} else {
 				mesh.AddTriangle (curr, next, ntop, materialId);
 				mesh.AddTriangle (curr, ntop, top, materialId);
@@ -369,6 +616,7 @@ Mesh GeneratePlatonicSolid (const Material& material, const glm::dmat4& transfor
 	mesh.SetTransformation (transformation);
 
 	if (type == PlatonicSolidType::Tetrahedron) {
+		mesh.Reserve (4, 4, 4);
 		double a = 1.0;
 
 		AddVertexAtDistance (mesh, +a, +a, +a, radius);
@@ -381,6 +629,7 @@ Mesh GeneratePlatonicSolid (const Material& material, const glm::dmat4& transfor
 		mesh.AddTriangle (0, 3, 2, materialId);
 		mesh.AddTriangle (1, 2, 3, materialId);
 	} else if (type == PlatonicSolidType::Hexahedron) {
+		mesh.Reserve (8, 12, 12);
 		double a = 1.0;
 
 		AddVertexAtDistance (mesh, +a, +a, +a, radius);
@@ -399,6 +648,7 @@ Mesh GeneratePlatonicSolid (const Material& material, const glm::dmat4& transfor
 		AddRectangle (mesh, 2, 6, 7, 3, materialId);
 		AddRectangle (mesh, 4, 5, 7, 6, materialId);
 	} else if (type == PlatonicSolidType::Octahedron) {
+		mesh.Reserve (6, 8, 8);
 		double a = 1.0;
 		double b = 0.0;
 
@@ -418,6 +668,7 @@ Mesh GeneratePlatonicSolid (const Material& material, const glm::dmat4& transfor
 		mesh.AddTriangle (1, 4, 2, materialId);
 		mesh.AddTriangle (1, 5, 3, materialId);
 	} else if (type == PlatonicSolidType::Dodecahedron) {
+		mesh.Reserve (20, 36, 36);
 		double a = 1.0;
 		double b = 0.0;
 		double c = (1.0 + sqrt (5.0)) / 2.0;
@@ -457,6 +708,7 @@ Mesh GeneratePlatonicSolid (const Material& material, const glm::dmat4& transfor
 		AddConvexPolygon (mesh, { 5, 9, 11, 7, 19 }, materialId);
 		AddConvexPolygon (mesh, { 6, 17, 19, 7, 15 }, materialId);
 	} else if (type == PlatonicSolidType::Icosahedron) {
+		mesh.Reserve (12, 20, 20);
 		double a = 1.0;
 		double b = 0.0;
 		double c = (1.0 + sqrt (5.0)) / 2.0;
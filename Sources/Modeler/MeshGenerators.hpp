@@ -19,12 +19,43 @@ enum class PlatonicSolidType
 	Icosahedron
 };
 
+enum class SphereType
+{
+	UVSphere,
+	Icosphere
+};
+
+class TessellationTolerance
+{
+public:
+	TessellationTolerance ();
+	TessellationTolerance (double chordalDeviation, double maxSegmentAngle);
+
+	bool		Check () const;
+	double		GetChordalDeviation () const;
+	double		GetMaxSegmentAngle () const;
+
+	bool		operator== (const TessellationTolerance& rhs) const;
+	bool		operator!= (const TessellationTolerance& rhs) const;
+
+private:
+	double		chordalDeviation;
+	double		maxSegmentAngle;
+};
+
+// segment count of a full circle, so that neither the distance between the chords and the
+// arc exceeds the chordal deviation, nor the angle of a segment exceeds the maximum angle
+int CalculateCircleSegmentation (double radius, const TessellationTolerance& tolerance);
+int CalculateSphereSegmentation (double radius, const TessellationTolerance& tolerance);
+int CalculateIcosphereFrequency (double radius, const TessellationTolerance& tolerance);
+
 Mesh GenerateBox (const Material& material, const glm::dmat4& transformation, double xSize, double ySize, double zSize);
 Mesh GenerateBoxShell (const Material& material, const glm::dmat4& transformation, double xSize, double ySize, double zSize, double thickness);
 Mesh GenerateCylinder (const Material& material, const glm::dmat4& transformation, double radius, double height, int segmentation, bool isSmooth);
 Mesh GenerateCylinderShell (const Material& material, const glm::dmat4& transformation, double radius, double height, int segmentation, bool isSmooth, double thickness);
 Mesh GenerateCone (const Material& material, const glm::dmat4& transformation, double topRadius, double bottomRadius, double height, int segmentation, bool isSmooth);
 Mesh GenerateSphere (const Material& material, const glm::dmat4& transformation, double radius, int segmentation, bool isSmooth);
+Mesh GenerateIcosphere (const Material& material, const glm::dmat4& transformation, double radius, int frequency, bool isSmooth);
 Mesh GenerateTorus (const Material& material, const glm::dmat4& transformation, double outerRadius, double innerRadius, int outerSegmentation, int innerSegmentation, bool isSmooth);
 Mesh GeneratePrism (const Material& material, const glm::dmat4& transformation, const std::vector<glm::dvec2>& basePolygon, double height, Triangulator& triangulator);
 Mesh GeneratePrismShell (const Material& material, const glm::dmat4& transformation, const std::vector<glm::dvec2>& basePolygon, double height, double thickness);
@@ -0,0 +1,353 @@
+#include "MeshOptimization.hpp"
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Modeler
+{
+
+// the parameters of the scoring function from the original description of the algorithm
+static const int ModelledCacheSize = 32;
+static const int MaxScoredValence = 32;
+static const double CacheDecayPower = 1.5;
+static const double LastTriangleScore = 0.75;
+static const double ValenceBoostScale = 2.0;
+static const double ValenceBoostPower = 0.5;
+
+class VertexScoreTable
+{
+public:
+	VertexScoreTable ()
+	{
+		for (int cachePosition = -1; cachePosition < ModelledCacheSize; cachePosition++) {
+			for (int valence = 0; valence <= MaxScoredValence; valence++) {
+				scores[cachePosition + 1][valence] = CalculateScore (cachePosition, valence);
+			}
+		}
+	}
+
+	double GetScore (int cachePosition, unsigned int remainingValence) const
+	{
+		return scores[cachePosition + 1][std::min (remainingValence, (unsigned int) MaxScoredValence)];
+	}
+
+private:
+	static double CalculateScore (int cachePosition, int remainingValence)
+	{
+		if (remainingValence == 0) {
+			return -1.0;
+		}
+		double score = 0.0;
+		if (cachePosition >= 0) {
+			if (cachePosition < 3) {
+				// the vertices of the last triangle get a fixed score, so the next triangle
+				// is not forced to share an edge with it, that would create long strips
+				score = LastTriangleScore;
+			} else {
+				double scaler = 1.0 / (ModelledCacheSize - 3);
+				score = std::pow (1.0 - (cachePosition - 3) * scaler, CacheDecayPower);
+			}
+		}
+		// vertices with few remaining triangles are preferred to finish them off
+		score += ValenceBoostScale * std::pow ((double) remainingValence, -ValenceBoostPower);
+		return score;
+	}
+
+	double scores[ModelledCacheSize + 1][MaxScoredValence + 1];
+};
+
+class TriangleOrderOptimizer
+{
+public:
+	TriangleOrderOptimizer (const std::vector<MeshTriangle>& triangles, unsigned int vertexCount) :
+		triangles (triangles),
+		scoreTable (),
+		localVertices (vertexCount, NoIndex)
+	{
+	}
+
+	void OptimizeRange (unsigned int firstTriangle, unsigned int triangleCount, std::vector<unsigned int>& order)
+	{
+		InitializeRange (firstTriangle, triangleCount);
+
+		std::vector<int> cache;
+		std::vector<int> newCache;
+		unsigned int firstNotAdded = 0;
+		unsigned int bestTriangle = FindBestTriangle ();
+		for (unsigned int addedCount = 0; addedCount < triangleCount; addedCount++) {
+			if (bestTriangle == NoIndex) {
+				// nothing to continue with in the cache, take the first remaining triangle
+				while (isTriangleAdded[firstNotAdded]) {
+					firstNotAdded++;
+				}
+				bestTriangle = firstNotAdded;
+			}
+
+			order.push_back (firstTriangle + bestTriangle);
+			isTriangleAdded[bestTriangle] = true;
+
+			newCache.clear ();
+			for (unsigned int vertex : rangeTriangles[bestTriangle]) {
+				RemoveVertexTriangle (vertex, bestTriangle);
+				newCache.push_back ((int) vertex);
+			}
+			for (int vertex : cache) {
+				if (std::find (newCache.begin (), newCache.begin () + 3, vertex) == newCache.begin () + 3) {
+					newCache.push_back (vertex);
+				}
+			}
+
+			for (size_t i = 0; i < newCache.size (); i++) {
+				unsigned int vertex = (unsigned int) newCache[i];
+				cachePositions[vertex] = (i < ModelledCacheSize) ? (int) i : -1;
+				vertexScores[vertex] = scoreTable.GetScore (cachePositions[vertex], remainingValences[vertex]);
+			}
+
+			bestTriangle = NoIndex;
+			double bestScore = -1.0;
+			for (int vertex : newCache) {
+				unsigned int start = vertexTriangleStarts[vertex];
+				for (unsigned int i = start; i < start + remainingValences[vertex]; i++) {
+					unsigned int triangle = vertexTriangles[i];
+					const std::array<unsigned int, 3>& triangleVertices = rangeTriangles[triangle];
+					double score = vertexScores[triangleVertices[0]] + vertexScores[triangleVertices[1]] + vertexScores[triangleVertices[2]];
+					if (score > bestScore) {
+						bestTriangle = triangle;
+						bestScore = score;
+					}
+				}
+			}
+
+			if (newCache.size () > ModelledCacheSize) {
+				newCache.resize (ModelledCacheSize);
+			}
+			std::swap (cache, newCache);
+		}
+
+		for (unsigned int globalVertex : globalVertices) {
+			localVertices[globalVertex] = NoIndex;
+		}
+	}
+
+private:
+	static const unsigned int NoIndex = (unsigned int) -1;
+
+	void InitializeRange (unsigned int firstTriangle, unsigned int triangleCount)
+	{
+		globalVertices.clear ();
+		rangeTriangles.resize (triangleCount);
+		for (unsigned int i = 0; i < triangleCount; i++) {
+			const MeshTriangle& triangle = triangles[firstTriangle + i];
+			std::array<unsigned int, 3>& triangleVertices = rangeTriangles[i];
+			triangleVertices = { triangle.v1, triangle.v2, triangle.v3 };
+			for (unsigned int& vertex : triangleVertices) {
+				if (localVertices[vertex] == NoIndex) {
+					localVertices[vertex] = (unsigned int) globalVertices.size ();
+					globalVertices.push_back (vertex);
+				}
+				vertex = localVertices[vertex];
+			}
+		}
+
+		size_t vertexCount = globalVertices.size ();
+		remainingValences.assign (vertexCount, 0);
+		for (const std::array<unsigned int, 3>& triangleVertices : rangeTriangles) {
+			for (unsigned int vertex : triangleVertices) {
+				remainingValences[vertex]++;
+			}
+		}
+		vertexTriangleStarts.assign (vertexCount, 0);
+		for (size_t i = 1; i < vertexCount; i++) {
+			vertexTriangleStarts[i] = vertexTriangleStarts[i - 1] + remainingValences[i - 1];
+		}
+		vertexTriangles.resize (triangleCount * 3);
+		std::vector<unsigned int> filled (vertexCount, 0);
+		for (unsigned int i = 0; i < triangleCount; i++) {
+			for (unsigned int vertex : rangeTriangles[i]) {
+				vertexTriangles[vertexTriangleStarts[vertex] + filled[vertex]++] = i;
+			}
+		}
+
+		cachePositions.assign (vertexCount, -1);
+		vertexScores.resize (vertexCount);
+		for (size_t i = 0; i < vertexCount; i++) {
+			vertexScores[i] = scoreTable.GetScore (-1, remainingValences[i]);
+		}
+		isTriangleAdded.assign (triangleCount, false);
+	}
+
+	unsigned int FindBestTriangle () const
+	{
+		unsigned int bestTriangle = NoIndex;
+		double bestScore = -1.0;
+		for (unsigned int i = 0; i < rangeTriangles.size (); i++) {
+			const std::array<unsigned int, 3>& triangleVertices = rangeTriangles[i];
+			double score = vertexScores[triangleVertices[0]] + vertexScores[triangleVertices[1]] + vertexScores[triangleVertices[2]];
+			if (score > bestScore) {
+				bestTriangle = i;
+				bestScore = score;
+			}
+		}
+		return bestTriangle;
+	}
+
+	void RemoveVertexTriangle (unsigned int vertex, unsigned int triangle)
+	{
+		unsigned int start = vertexTriangleStarts[vertex];
+		unsigned int last = start + remainingValences[vertex] - 1;
+		for (unsigned int i = start; i <= last; i++) {
+			if (vertexTriangles[i] == triangle) {
+				std::swap (vertexTriangles[i], vertexTriangles[last]);
+				break;
+			}
+		}
+		remainingValences[vertex]--;
+	}
+
+	const std::vector<MeshTriangle>&			triangles;
+	VertexScoreTable							scoreTable;
+	std::vector<unsigned int>					localVertices;
+	std::vector<unsigned int>					globalVertices;
+
+	std::vector<std::array<unsigned int, 3>>	rangeTriangles;
+	std::vector<unsigned int>					remainingValences;
+	std::vector<unsigned int>					vertexTriangleStarts;
+	std::vector<unsigned int>					vertexTriangles;
+	std::vector<int>							cachePositions;
+	std::vector<double>							vertexScores;
+	std::vector<bool>							isTriangleAdded;
+};
+
+double CalculateAverageCacheMissRatio (const MeshGeometry& geometry, unsigned int cacheSize)
+{
+	if (geometry.TriangleCount () == 0) {
+		return 0.0;
+	}
+
+	// a vertex is in the cache if it was among the last inserted ones
+	std::vector<unsigned int> insertionStamps (geometry.VertexCount (), 0);
+	unsigned int missCount = 0;
+	geometry.EnumerateTriangles ([&] (const MeshTriangle& triangle) {
+		for (unsigned int vertex : { triangle.v1, triangle.v2, triangle.v3 }) {
+			unsigned int stamp = insertionStamps[vertex];
+			if (stamp == 0 || stamp + cacheSize <= missCount) {
+				missCount++;
+				insertionStamps[vertex] = missCount;
+			}
+		}
+	});
+	return (double) missCount / (double) geometry.TriangleCount ();
+}
+
+MeshGeometry OptimizeTriangleOrder (const MeshGeometry& geometry, const MeshMaterials& materials)
+{
+	if (materials.TriangleCount () != geometry.TriangleCount ()) {
+		throw std::logic_error ("invalid triangle materials");
+	}
+
+	const std::vector<MeshTriangle>& triangles = geometry.GetTriangles ();
+	std::vector<unsigned int> order;
+	order.reserve (triangles.size ());
+	TriangleOrderOptimizer optimizer (triangles, geometry.VertexCount ());
+	while (order.size () < triangles.size ()) {
+		// the ranges are processed in triangle order to keep the original range layout
+		unsigned int firstTriangle = (unsigned int) order.size ();
+		MaterialId material = materials.GetTriangleMaterial (firstTriangle);
+		unsigned int triangleCount = 1;
+		while (firstTriangle + triangleCount < triangles.size () && materials.GetTriangleMaterial (firstTriangle + triangleCount) == material) {
+			triangleCount++;
+		}
+		optimizer.OptimizeRange (firstTriangle, triangleCount, order);
+	}
+
+	const unsigned int NoIndex = (unsigned int) -1;
+	std::vector<unsigned int> vertexMap (geometry.VertexCount (), NoIndex);
+	std::vector<unsigned int> normalMap (geometry.NormalCount (), NoIndex);
+	std::vector<unsigned int> vertexOrder;
+	std::vector<unsigned int> normalOrder;
+	vertexOrder.reserve (geometry.VertexCount ());
+	normalOrder.reserve (geometry.NormalCount ());
+	std::vector<MeshTriangle> newTriangles;
+	newTriangles.reserve (triangles.size ());
+	auto MapIndex = [] (unsigned int index, std::vector<unsigned int>& indexMap, std::vector<unsigned int>& indexOrder) {
+		if (indexMap[index] == NoIndex) {
+			indexMap[index] = (unsigned int) indexOrder.size ();
+			indexOrder.push_back (index);
+		}
+		return indexMap[index];
+	};
+	for (unsigned int triangleIndex : order) {
+		const MeshTriangle& triangle = triangles[triangleIndex];
+		unsigned int v1 = MapIndex (triangle.v1, vertexMap, vertexOrder);
+		unsigned int v2 = MapIndex (triangle.v2, vertexMap, vertexOrder);
+		unsigned int v3 = MapIndex (triangle.v3, vertexMap, vertexOrder);
+		unsigned int n1 = MapIndex (triangle.n1, normalMap, normalOrder);
+		unsigned int n2 = MapIndex (triangle.n2, normalMap, normalOrder);
+		unsigned int n3 = MapIndex (triangle.n3, normalMap, normalOrder);
+		newTriangles.push_back (MeshTriangle (v1, v2, v3, n1, n2, n3));
+	}
+
+	// unreferenced vertices and normals are kept at the end
+	for (unsigned int i = 0; i < geometry.VertexCount (); i++) {
+		MapIndex (i, vertexMap, vertexOrder);
+	}
+	for (unsigned int i = 0; i < geometry.NormalCount (); i++) {
+		MapIndex (i, normalMap, normalOrder);
+	}
+
+	std::vector<glm::dvec3> vertices;
+	std::vector<glm::dvec3> normals;
+	vertices.reserve (vertexOrder.size ());
+	normals.reserve (normalOrder.size ());
+	for (unsigned int vertex : vertexOrder) {
+		vertices.push_back (geometry.GetVertex (vertex));
+	}
+	for (unsigned int normal : normalOrder) {
+		normals.push_back (geometry.GetNormal (normal));
+	}
+
+	MeshGeometry result;
+	result.Reserve ((unsigned int) vertices.size (), (unsigned int) normals.size (), (unsigned int) newTriangles.size ());
+	result.AppendVertices (vertices.data (), vertices.size ());
+	result.AppendNormals (normals.data (), normals.size ());
+	result.AppendTriangles (newTriangles.data (), newTriangles.size ());
+	result.SetStorage (geometry.GetStorage ());
+	return result;
+}
+
+Mesh OptimizeTriangleOrder (const Mesh& mesh)
+{
+	const MeshMaterials& materials = mesh.GetMaterials ();
+	MeshGeometry optimized = OptimizeTriangleOrder (mesh.GetGeometry (), materials);
+
+	Mesh result;
+	materials.EnumerateMaterials ([&] (MaterialId, const Material& material) {
+		result.AddMaterial (material);
+	});
+
+	const std::vector<MeshTriangle>& triangles = optimized.GetTriangles ();
+	result.Reserve (optimized.VertexCount (), optimized.NormalCount (), optimized.TriangleCount ());
+	for (unsigned int i = 0; i < optimized.VertexCount (); i++) {
+		result.AddVertex (optimized.GetVertex (i));
+	}
+	for (unsigned int i = 0; i < optimized.NormalCount (); i++) {
+		result.AddNormal (optimized.GetNormal (i));
+	}
+
+	unsigned int firstTriangle = 0;
+	while (firstTriangle < triangles.size ()) {
+		MaterialId material = materials.GetTriangleMaterial (firstTriangle);
+		unsigned int triangleCount = 1;
+		while (firstTriangle + triangleCount < triangles.size () && materials.GetTriangleMaterial (firstTriangle + triangleCount) == material) {
+			triangleCount++;
+		}
+		result.AppendTriangles (triangles.data () + firstTriangle, triangleCount, material);
+		firstTriangle += triangleCount;
+	}
+	result.SetTransformation (mesh.GetTransformation ());
+	return result;
+}
+
+}
@@ -0,0 +1,21 @@
+#ifndef MODELER_MESHOPTIMIZATION_HPP
+#define MODELER_MESHOPTIMIZATION_HPP
+
+#include "Mesh.hpp"
+
+namespace Modeler
+{
+
+// average cache miss ratio: vertices transformed per triangle with a first in first out
+// post-transform vertex cache of the given size, it is between 0.5 and 3.0 for closed meshes
+double			CalculateAverageCacheMissRatio (const MeshGeometry& geometry, unsigned int cacheSize);
+
+// Reorders the triangles inside every material range for vertex cache reuse (Forsyth's linear
+// speed vertex cache optimization), then orders the vertices and normals by their first use.
+// The triangles keep their materials, so the materials of the mesh remain valid.
+MeshGeometry	OptimizeTriangleOrder (const MeshGeometry& geometry, const MeshMaterials& materials);
+Mesh			OptimizeTriangleOrder (const Mesh& mesh);
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "MeshPacketTriangles.hpp"
+
+namespace Modeler
+{
+
+MeshPacketTriangles::MeshPacketTriangles () :
+	triangleIndices (),
+	vertexX (),
+	vertexY (),
+	vertexZ (),
+	edge1X (),
+	edge1Y (),
+	edge1Z (),
+	edge2X (),
+	edge2Y (),
+	edge2Z ()
+{
+
+}
+
+MeshPacketTriangles::MeshPacketTriangles (const MeshGeometry& geometry, const MeshBVH& bvh) :
+	MeshPacketTriangles ()
+{
+	unsigned int triangleCount = bvh.TriangleCount ();
+	triangleIndices.resize (triangleCount);
+	std::vector<double>* arrays[] = { &vertexX, &vertexY, &vertexZ, &edge1X, &edge1Y, &edge1Z, &edge2X, &edge2Y, &edge2Z };
+	for (std::vector<double>* array : arrays) {
+		array->resize (triangleCount);
+	}
+
+	for (unsigned int position = 0; position < triangleCount; position++) {
+		unsigned int triangleIndex = bvh.GetLeafTriangle (position);
+		const MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+		glm::dvec3 v1 = geometry.GetVertex (triangle.v1);
+		glm::dvec3 edge1 = geometry.GetVertex (triangle.v2) - v1;
+		glm::dvec3 edge2 = geometry.GetVertex (triangle.v3) - v1;
+		triangleIndices[position] = triangleIndex;
+		vertexX[position] = v1.x;
+		vertexY[position] = v1.y;
+		vertexZ[position] = v1.z;
+		edge1X[position] = edge1.x;
+		edge1Y[position] = edge1.y;
+		edge1Z[position] = edge1.z;
+		edge2X[position] = edge2.x;
+		edge2Y[position] = edge2.y;
+		edge2Z[position] = edge2.z;
+	}
+}
+
+unsigned int MeshPacketTriangles::TriangleCount () const
+{
+	return (unsigned int) triangleIndices.size ();
+}
+
+unsigned int MeshPacketTriangles::GetTriangleIndex (unsigned int position) const
+{
+	return triangleIndices[position];
+}
+
+}
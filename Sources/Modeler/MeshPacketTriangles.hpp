@@ -0,0 +1,97 @@
+#ifndef MODELER_MESHPACKETTRIANGLES_HPP
+#define MODELER_MESHPACKETTRIANGLES_HPP
+
+#include "Mesh.hpp"
+#include "MeshBVH.hpp"
+#include "Geometry.hpp"
+
+#include <vector>
+
+namespace Modeler
+{
+
+// The triangles of a mesh geometry in the leaf order of its bounding volume hierarchy for
+// tracing ray packets. The first vertices and the edges are stored in separate arrays for
+// every coordinate, and the intersection follows the single ray triangle intersection, but it
+// is calculated in the space of the geometry.
+
+class MeshPacketTriangles
+{
+public:
+	MeshPacketTriangles ();
+	MeshPacketTriangles (const MeshGeometry& geometry, const MeshBVH& bvh);
+
+	unsigned int			TriangleCount () const;
+	unsigned int			GetTriangleIndex (unsigned int position) const;
+
+	// processor (rayIndex, position, distance) for the hits closer than the max distance of the
+	// ray on the triangles in the range, for mirrored meshes the back faces are hit
+	template <typename ProcessorType>
+	void					IntersectRayPacket (const RayPacket& packet, unsigned int firstPosition, unsigned int triangleCount, bool isMirrored, ProcessorType processor) const;
+
+private:
+	std::vector<unsigned int>	triangleIndices;
+	std::vector<double>			vertexX;
+	std::vector<double>			vertexY;
+	std::vector<double>			vertexZ;
+	std::vector<double>			edge1X;
+	std::vector<double>			edge1Y;
+	std::vector<double>			edge1Z;
+	std::vector<double>			edge2X;
+	std::vector<double>			edge2Y;
+	std::vector<double>			edge2Z;
+};
+
+template <typename ProcessorType>
+void MeshPacketTriangles::IntersectRayPacket (const RayPacket& packet, unsigned int firstPosition, unsigned int triangleCount, bool isMirrored, ProcessorType processor) const
+{
+	double cullingSign = isMirrored ? -1.0 : 1.0;
+	double determinants[RayPacketSize];
+	double us[RayPacketSize];
+	double vs[RayPacketSize];
+	double distances[RayPacketSize];
+	for (unsigned int position = firstPosition; position < firstPosition + triangleCount; position++) {
+		double e1x = edge1X[position];
+		double e1y = edge1Y[position];
+		double e1z = edge1Z[position];
+		double e2x = edge2X[position];
+		double e2y = edge2Y[position];
+		double e2z = edge2Z[position];
+		for (unsigned int i = 0; i < RayPacketSize; i++) {
+			double px = packet.directionY[i] * e2z - e2y * packet.directionZ[i];
+			double py = packet.directionZ[i] * e2x - e2z * packet.directionX[i];
+			double pz = packet.directionX[i] * e2y - e2x * packet.directionY[i];
+			double determinant = e1x * px + e1y * py + e1z * pz;
+			double invDeterminant = 1.0 / determinant;
+			double tx = packet.originX[i] - vertexX[position];
+			double ty = packet.originY[i] - vertexY[position];
+			double tz = packet.originZ[i] - vertexZ[position];
+			double qx = ty * e1z - e1y * tz;
+			double qy = tz * e1x - e1z * tx;
+			double qz = tx * e1y - e1x * ty;
+			determinants[i] = determinant * cullingSign;
+			us[i] = (tx * px + ty * py + tz * pz) * invDeterminant;
+			vs[i] = (packet.directionX[i] * qx + packet.directionY[i] * qy + packet.directionZ[i] * qz) * invDeterminant;
+			distances[i] = (e2x * qx + e2y * qy + e2z * qz) * invDeterminant;
+		}
+		for (unsigned int i = 0; i < RayPacketSize; i++) {
+			if (!Geometry::IsPositive (determinants[i])) {
+				continue;
+			}
+			if (Geometry::IsLower (us[i], 0.0) || Geometry::IsGreater (us[i], 1.0)) {
+				continue;
+			}
+			if (Geometry::IsLower (vs[i], 0.0) || Geometry::IsGreater (us[i] + vs[i], 1.0)) {
+				continue;
+			}
+			if (!Geometry::IsPositive (distances[i]) || distances[i] > packet.maxDistances[i]) {
+				continue;
+			}
+			processor (i, position, distances[i]);
+		}
+	}
+}
+
+}
+
+#endif
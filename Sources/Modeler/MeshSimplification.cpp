@@ -0,0 +1,754 @@
+#include "MeshSimplification.hpp"
+#include "Geometry.hpp"
+
+#include <queue>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Modeler
+{
+
+// weight of the planes perpendicular to open and material boundary edges compared
+// to the area weighted planes of the triangles, it keeps boundary vertices in place
+static const double BoundaryPlaneWeight = 1000.0;
+
+// the minimal cosine of the angle between the normal of a triangle before and after
+// a collapse, collapses which rotate a triangle more than this are rejected
+static const double MinNormalCosineAfterCollapse = 0.2;
+
+class ErrorQuadric
+{
+public:
+	ErrorQuadric () :
+		xx (0.0), xy (0.0), xz (0.0), xw (0.0),
+		yy (0.0), yz (0.0), yw (0.0),
+		zz (0.0), zw (0.0),
+		ww (0.0)
+	{
+	}
+
+	void AddPlane (const glm::dvec3& normal, double d, double weight)
+	{
+		xx += weight * normal.x * normal.x;
+		xy += weight * normal.x * normal.y;
+		xz += weight * normal.x * normal.z;
+		xw += weight * normal.x * d;
+		yy += weight * normal.y * normal.y;
+		yz += weight * normal.y * normal.z;
+		yw += weight * normal.y * d;
+		zz += weight * normal.z * normal.z;
+		zw += weight * normal.z * d;
+		ww += weight * d * d;
+	}
+
+	void Add (const ErrorQuadric& rhs)
+	{
+		xx += rhs.xx; xy += rhs.xy; xz += rhs.xz; xw += rhs.xw;
+		yy += rhs.yy; yz += rhs.yz; yw += rhs.yw;
+		zz += rhs.zz; zw += rhs.zw;
+		ww += rhs.ww;
+	}
+
+	double Evaluate (const glm::dvec3& p) const
+	{
+		return	xx * p.x * p.x + 2.0 * xy * p.x * p.y + 2.0 * xz * p.x * p.z + 2.0 * xw * p.x +
+				yy * p.y * p.y + 2.0 * yz * p.y * p.z + 2.0 * yw * p.y +
+				zz * p.z * p.z + 2.0 * zw * p.z +
+				ww;
+	}
+
+	bool FindMinimum (glm::dvec3& result) const
+	{
+		glm::dmat3 matrix (
+			xx, xy, xz,
+			xy, yy, yz,
+			xz, yz, zz
+		);
+		double det = glm::determinant (matrix);
+		double trace = xx + yy + zz;
+		if (std::fabs (det) <= 1.0e-10 * trace * trace * trace) {
+			return false;
+		}
+		result = glm::inverse (matrix) * glm::dvec3 (-xw, -yw, -zw);
+		return true;
+	}
+
+private:
+	double xx, xy, xz, xw;
+	double yy, yz, yw;
+	double zz, zw;
+	double ww;
+};
+
+// the candidates are kept small, because the heap holds a few entries for every edge,
+// the position of the collapse is calculated again when the candidate is processed
+class CollapseCandidate
+{
+public:
+	double			cost;
+	unsigned int	vertex1;
+	unsigned int	vertex2;
+	unsigned int	stamp1;
+	unsigned int	stamp2;
+
+	bool operator> (const CollapseCandidate& rhs) const
+	{
+		return cost > rhs.cost;
+	}
+};
+
+class MeshSimplifier
+{
+public:
+	MeshSimplifier (const MeshGeometry& geometry, const MeshMaterials& materials);
+
+	void	Simplify (unsigned int targetTriangleCount);
+	Mesh	GetResult () const;
+
+private:
+	struct Triangle
+	{
+		unsigned int	v[3];
+		unsigned int	n[3];
+		MaterialId		material;
+		bool			isFlat;
+		bool			isRemoved;
+	};
+
+	void	InitializeQuadrics ();
+	void	InitializeBoundaries ();
+
+	bool	CalculateCollapse (unsigned int vertex1, unsigned int vertex2, glm::dvec3& position, double& cost) const;
+	bool	CalculateCandidate (unsigned int vertex1, unsigned int vertex2, CollapseCandidate& candidate) const;
+	bool	IsBoundaryEdge (unsigned int vertex1, unsigned int vertex2) const;
+	bool	CanCollapse (unsigned int vertex1, unsigned int vertex2, const glm::dvec3& position);
+	bool	IsValidMovement (unsigned int vertex, unsigned int otherVertex, const glm::dvec3& position) const;
+	void	Collapse (unsigned int vertex1, unsigned int vertex2, const glm::dvec3& position);
+
+	void	CompactVertexTriangles (unsigned int vertex);
+	void	CollectNeighbours (unsigned int vertex, std::vector<unsigned int>& neighbours) const;
+	void	PushCandidates (unsigned int vertex);
+
+	const MeshMaterials&				materials;
+	std::vector<glm::dvec3>				positions;
+	std::vector<glm::dvec3>				normals;
+	std::vector<ErrorQuadric>			quadrics;
+	std::vector<bool>					isBoundary;
+	std::vector<bool>					isRemoved;
+	std::vector<unsigned int>			stamps;
+	std::vector<std::vector<unsigned int>>	vertexTriangles;
+	std::vector<Triangle>				triangles;
+	unsigned int						triangleCount;
+
+	std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, std::greater<CollapseCandidate>>	candidates;
+	std::vector<unsigned int>			neighbours1;
+	std::vector<unsigned int>			neighbours2;
+	std::vector<std::pair<unsigned int, unsigned int>>	normalPairs;
+};
+
+static std::uint64_t GetEdgeKey (unsigned int vertex1, unsigned int vertex2)
+{
+	unsigned int minVertex = std::min (vertex1, vertex2);
+	unsigned int maxVertex = std::max (vertex1, vertex2);
+	return ((std::uint64_t) minVertex << 32) | (std::uint64_t) maxVertex;
+}
+
+static glm::dvec3 CalculateTriangleNormal (const glm::dvec3& p1, const glm::dvec3& p2, const glm::dvec3& p3)
+{
+	return glm::cross (p2 - p1, p3 - p1);
+}
+
+MeshSimplifier::MeshSimplifier (const MeshGeometry& geometry, const MeshMaterials& materials) :
+	materials (materials),
+	positions (),
+	normals (),
+	quadrics (geometry.VertexCount ()),
+	isBoundary (geometry.VertexCount (), false),
+	isRemoved (geometry.VertexCount (), false),
+	stamps (geometry.VertexCount (), 0),
+	vertexTriangles (geometry.VertexCount ()),
+	triangles (),
+	triangleCount (0),
+	candidates (),
+	neighbours1 (),
+	neighbours2 (),
+	normalPairs ()
+{
+	if (materials.TriangleCount () != geometry.TriangleCount ()) {
+		throw std::logic_error ("invalid triangle materials");
+	}
+
+	positions.reserve (geometry.VertexCount ());
+	geometry.EnumerateVertices (glm::dmat4 (1.0), [&] (const glm::dvec3& vertex) {
+		positions.push_back (vertex);
+	});
+
+	normals.reserve (geometry.NormalCount ());
+	for (unsigned int i = 0; i < geometry.NormalCount (); i++) {
+		normals.push_back (geometry.GetNormal (i));
+	}
+
+	triangles.reserve (geometry.TriangleCount ());
+	geometry.EnumerateTriangles ([&] (const MeshTriangle& meshTriangle) {
+		Triangle triangle;
+		triangle.v[0] = meshTriangle.v1;
+		triangle.v[1] = meshTriangle.v2;
+		triangle.v[2] = meshTriangle.v3;
+		triangle.n[0] = meshTriangle.n1;
+		triangle.n[1] = meshTriangle.n2;
+		triangle.n[2] = meshTriangle.n3;
+		triangle.material = 0;
+		triangle.isFlat = (meshTriangle.n1 == meshTriangle.n2 && meshTriangle.n1 == meshTriangle.n3);
+		triangle.isRemoved = (meshTriangle.v1 == meshTriangle.v2 || meshTriangle.v1 == meshTriangle.v3 || meshTriangle.v2 == meshTriangle.v3);
+		triangles.push_back (triangle);
+	});
+
+	materials.EnumerateTrianglesByMaterial ([&] (MaterialId materialId, unsigned int firstTriangle, unsigned int rangeTriangleCount) {
+		for (unsigned int i = firstTriangle; i < firstTriangle + rangeTriangleCount; i++) {
+			triangles[i].material = materialId;
+		}
+	});
+
+	std::vector<unsigned int> triangleCounts (positions.size (), 0);
+	for (const Triangle& triangle : triangles) {
+		if (!triangle.isRemoved) {
+			for (unsigned int vertex : triangle.v) {
+				triangleCounts[vertex]++;
+			}
+		}
+	}
+	for (size_t i = 0; i < positions.size (); i++) {
+		vertexTriangles[i].reserve (triangleCounts[i]);
+	}
+	for (unsigned int i = 0; i < triangles.size (); i++) {
+		const Triangle& triangle = triangles[i];
+		if (!triangle.isRemoved) {
+			for (unsigned int vertex : triangle.v) {
+				vertexTriangles[vertex].push_back (i);
+			}
+			triangleCount++;
+		}
+	}
+
+	InitializeQuadrics ();
+	InitializeBoundaries ();
+}
+
+void MeshSimplifier::Simplify (unsigned int targetTriangleCount)
+{
+	while (triangleCount > targetTriangleCount && !candidates.empty ()) {
+		CollapseCandidate candidate = candidates.top ();
+		candidates.pop ();
+		if (isRemoved[candidate.vertex1] || isRemoved[candidate.vertex2]) {
+			continue;
+		}
+		if (stamps[candidate.vertex1] != candidate.stamp1 || stamps[candidate.vertex2] != candidate.stamp2) {
+			continue;
+		}
+		glm::dvec3 position;
+		double cost = 0.0;
+		if (!CalculateCollapse (candidate.vertex1, candidate.vertex2, position, cost)) {
+			continue;
+		}
+		if (!CanCollapse (candidate.vertex1, candidate.vertex2, position)) {
+			continue;
+		}
+		Collapse (candidate.vertex1, candidate.vertex2, position);
+	}
+}
+
+Mesh MeshSimplifier::GetResult () const
+{
+	Mesh result;
+	materials.EnumerateMaterials ([&] (MaterialId, const Material& material) {
+		result.AddMaterial (material);
+	});
+
+	const unsigned int NoIndex = (unsigned int) -1;
+	std::vector<unsigned int> vertexMap (positions.size (), NoIndex);
+	std::vector<unsigned int> normalMap (normals.size (), NoIndex);
+	unsigned int flatTriangleCount = 0;
+	for (const Triangle& triangle : triangles) {
+		if (triangle.isRemoved) {
+			continue;
+		}
+		for (unsigned int vertex : triangle.v) {
+			vertexMap[vertex] = 0;
+		}
+		if (triangle.isFlat) {
+			flatTriangleCount++;
+		} else {
+			for (unsigned int normal : triangle.n) {
+				normalMap[normal] = 0;
+			}
+		}
+	}
+
+	unsigned int vertexCount = 0;
+	for (size_t i = 0; i < positions.size (); i++) {
+		if (vertexMap[i] != NoIndex) {
+			vertexMap[i] = vertexCount++;
+		}
+	}
+	unsigned int normalCount = 0;
+	for (size_t i = 0; i < normals.size (); i++) {
+		if (normalMap[i] != NoIndex) {
+			normalMap[i] = normalCount++;
+		}
+	}
+
+	result.Reserve (vertexCount, normalCount + flatTriangleCount, triangleCount);
+	for (size_t i = 0; i < positions.size (); i++) {
+		if (vertexMap[i] != NoIndex) {
+			result.AddVertex (positions[i]);
+		}
+	}
+	for (size_t i = 0; i < normals.size (); i++) {
+		if (normalMap[i] != NoIndex) {
+			result.AddNormal (normals[i]);
+		}
+	}
+
+	for (const Triangle& triangle : triangles) {
+		if (triangle.isRemoved) {
+			continue;
+		}
+		unsigned int v1 = vertexMap[triangle.v[0]];
+		unsigned int v2 = vertexMap[triangle.v[1]];
+		unsigned int v3 = vertexMap[triangle.v[2]];
+		if (triangle.isFlat) {
+			glm::dvec3 normal = CalculateTriangleNormal (positions[triangle.v[0]], positions[triangle.v[1]], positions[triangle.v[2]]);
+			glm::dvec3 flatNormal = glm::length (normal) > 0.0 ? glm::normalize (normal) : normals[triangle.n[0]];
+			result.AddTriangle (v1, v2, v3, result.AddNormal (flatNormal), triangle.material);
+		} else {
+			result.AddTriangle (v1, v2, v3, normalMap[triangle.n[0]], normalMap[triangle.n[1]], normalMap[triangle.n[2]], triangle.material);
+		}
+	}
+
+	return result;
+}
+
+void MeshSimplifier::InitializeQuadrics ()
+{
+	for (const Triangle& triangle : triangles) {
+		if (triangle.isRemoved) {
+			continue;
+		}
+		const glm::dvec3& p1 = positions[triangle.v[0]];
+		glm::dvec3 normal = CalculateTriangleNormal (p1, positions[triangle.v[1]], positions[triangle.v[2]]);
+		double length = glm::length (normal);
+		if (length == 0.0) {
+			continue;
+		}
+		normal /= length;
+		double d = -glm::dot (normal, p1);
+		double area = length / 2.0;
+		for (unsigned int vertex : triangle.v) {
+			quadrics[vertex].AddPlane (normal, d, area);
+		}
+	}
+}
+
+void MeshSimplifier::InitializeBoundaries ()
+{
+	struct EdgeRecord
+	{
+		std::uint64_t	key;
+		unsigned int	triangle;
+		unsigned char	corner;
+
+		bool operator< (const EdgeRecord& rhs) const
+		{
+			return key < rhs.key;
+		}
+	};
+
+	std::vector<EdgeRecord> edges;
+	edges.reserve (triangleCount * 3);
+	for (unsigned int i = 0; i < triangles.size (); i++) {
+		const Triangle& triangle = triangles[i];
+		if (triangle.isRemoved) {
+			continue;
+		}
+		for (unsigned char corner = 0; corner < 3; corner++) {
+			edges.push_back ({ GetEdgeKey (triangle.v[corner], triangle.v[(corner + 1) % 3]), i, corner });
+		}
+	}
+	std::sort (edges.begin (), edges.end ());
+
+	// an edge is a boundary if it is open, non-manifold or it separates different materials,
+	// the boundary planes contain the edge and they are perpendicular to the triangles
+	size_t groupStart = 0;
+	while (groupStart < edges.size ()) {
+		size_t groupEnd = groupStart + 1;
+		while (groupEnd < edges.size () && edges[groupEnd].key == edges[groupStart].key) {
+			groupEnd++;
+		}
+		bool isBoundaryEdge = (groupEnd - groupStart != 2);
+		if (!isBoundaryEdge) {
+			isBoundaryEdge = triangles[edges[groupStart].triangle].material != triangles[edges[groupStart + 1].triangle].material;
+		}
+		if (isBoundaryEdge) {
+			for (size_t i = groupStart; i < groupEnd; i++) {
+				const Triangle& triangle = triangles[edges[i].triangle];
+				unsigned int begVertex = triangle.v[edges[i].corner];
+				unsigned int endVertex = triangle.v[(edges[i].corner + 1) % 3];
+				const glm::dvec3& beg = positions[begVertex];
+				glm::dvec3 edgeDir = positions[endVertex] - beg;
+				glm::dvec3 triangleNormal = CalculateTriangleNormal (positions[triangle.v[0]], positions[triangle.v[1]], positions[triangle.v[2]]);
+				glm::dvec3 planeNormal = glm::cross (edgeDir, triangleNormal);
+				double length = glm::length (planeNormal);
+				if (length > 0.0) {
+					planeNormal /= length;
+					double d = -glm::dot (planeNormal, beg);
+					double weight = BoundaryPlaneWeight * glm::dot (edgeDir, edgeDir);
+					quadrics[begVertex].AddPlane (planeNormal, d, weight);
+					quadrics[endVertex].AddPlane (planeNormal, d, weight);
+				}
+				isBoundary[begVertex] = true;
+				isBoundary[endVertex] = true;
+			}
+		}
+		groupStart = groupEnd;
+	}
+
+	std::vector<CollapseCandidate> initialCandidates;
+	initialCandidates.reserve (edges.size () / 2);
+	for (size_t i = 0; i < edges.size (); i++) {
+		if (i > 0 && edges[i].key == edges[i - 1].key) {
+			continue;
+		}
+		CollapseCandidate candidate;
+		if (CalculateCandidate ((unsigned int) (edges[i].key >> 32), (unsigned int) (edges[i].key & 0xFFFFFFFF), candidate)) {
+			initialCandidates.push_back (candidate);
+		}
+	}
+	candidates = std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, std::greater<CollapseCandidate>> (std::greater<CollapseCandidate> (), std::move (initialCandidates));
+}
+
+bool MeshSimplifier::CalculateCandidate (unsigned int vertex1, unsigned int vertex2, CollapseCandidate& candidate) const
+{
+	glm::dvec3 position;
+	double cost = 0.0;
+	if (!CalculateCollapse (vertex1, vertex2, position, cost)) {
+		return false;
+	}
+	candidate.cost = cost;
+	candidate.vertex1 = vertex1;
+	candidate.vertex2 = vertex2;
+	candidate.stamp1 = stamps[vertex1];
+	candidate.stamp2 = stamps[vertex2];
+	return true;
+}
+
+bool MeshSimplifier::CalculateCollapse (unsigned int vertex1, unsigned int vertex2, glm::dvec3& position, double& cost) const
+{
+	ErrorQuadric quadric = quadrics[vertex1];
+	quadric.Add (quadrics[vertex2]);
+
+	const glm::dvec3& p1 = positions[vertex1];
+	const glm::dvec3& p2 = positions[vertex2];
+	bool isBoundary1 = isBoundary[vertex1];
+	bool isBoundary2 = isBoundary[vertex2];
+
+	// a boundary vertex can only move along the boundary, so an inner vertex is merged into it,
+	// and an edge connecting two different boundary vertices can't be collapsed
+	if (isBoundary1 && isBoundary2) {
+		if (!IsBoundaryEdge (vertex1, vertex2)) {
+			return false;
+		}
+		glm::dvec3 mid = (p1 + p2) / 2.0;
+		position = mid;
+		double minCost = quadric.Evaluate (mid);
+		for (const glm::dvec3& p : { p1, p2 }) {
+			double cost = quadric.Evaluate (p);
+			if (cost < minCost) {
+				position = p;
+				minCost = cost;
+			}
+		}
+	} else if (isBoundary1) {
+		position = p1;
+	} else if (isBoundary2) {
+		position = p2;
+	} else {
+		glm::dvec3 mid = (p1 + p2) / 2.0;
+		if (!quadric.FindMinimum (position) || glm::distance (position, mid) > glm::distance (p1, p2)) {
+			position = mid;
+			double minCost = quadric.Evaluate (mid);
+			for (const glm::dvec3& p : { p1, p2 }) {
+				double cost = quadric.Evaluate (p);
+				if (cost < minCost) {
+					position = p;
+					minCost = cost;
+				}
+			}
+		}
+	}
+
+	cost = quadric.Evaluate (position);
+	return true;
+}
+
+bool MeshSimplifier::IsBoundaryEdge (unsigned int vertex1, unsigned int vertex2) const
+{
+	unsigned int edgeTriangleCount = 0;
+	MaterialId firstMaterial = 0;
+	bool isMaterialBoundary = false;
+	for (unsigned int triangleIndex : vertexTriangles[vertex1]) {
+		const Triangle& triangle = triangles[triangleIndex];
+		if (triangle.isRemoved) {
+			continue;
+		}
+		if (triangle.v[0] != vertex2 && triangle.v[1] != vertex2 && triangle.v[2] != vertex2) {
+			continue;
+		}
+		if (edgeTriangleCount == 0) {
+			firstMaterial = triangle.material;
+		} else if (triangle.material != firstMaterial) {
+			isMaterialBoundary = true;
+		}
+		edgeTriangleCount++;
+	}
+	return edgeTriangleCount != 2 || isMaterialBoundary;
+}
+
+bool MeshSimplifier::CanCollapse (unsigned int vertex1, unsigned int vertex2, const glm::dvec3& position)
+{
+	CompactVertexTriangles (vertex1);
+	CompactVertexTriangles (vertex2);
+
+	unsigned int sharedTriangleCount = 0;
+	for (unsigned int triangleIndex : vertexTriangles[vertex1]) {
+		const Triangle& triangle = triangles[triangleIndex];
+		if (triangle.v[0] == vertex2 || triangle.v[1] == vertex2 || triangle.v[2] == vertex2) {
+			sharedTriangleCount++;
+		}
+	}
+	if (sharedTriangleCount == 0) {
+		return false;
+	}
+
+	// link condition: the vertices connected to both vertices are exactly the opposite
+	// vertices of the triangles of the edge, otherwise the collapse makes the mesh non-manifold
+	CollectNeighbours (vertex1, neighbours1);
+	CollectNeighbours (vertex2, neighbours2);
+	size_t commonCount = 0;
+	size_t unionCount = 0;
+	size_t i1 = 0;
+	size_t i2 = 0;
+	while (i1 < neighbours1.size () || i2 < neighbours2.size ()) {
+		if (i2 == neighbours2.size () || (i1 < neighbours1.size () && neighbours1[i1] < neighbours2[i2])) {
+			i1++;
+		} else if (i1 == neighbours1.size () || neighbours2[i2] < neighbours1[i1]) {
+			i2++;
+		} else {
+			commonCount++;
+			i1++;
+			i2++;
+		}
+		unionCount++;
+	}
+	if (commonCount != sharedTriangleCount) {
+		return false;
+	}
+
+	// both vertices are in the union, less than three other vertices means that
+	// the collapse would leave a degenerate or double sided piece behind
+	if (unionCount < 5) {
+		return false;
+	}
+
+	return IsValidMovement (vertex1, vertex2, position) && IsValidMovement (vertex2, vertex1, position);
+}
+
+bool MeshSimplifier::IsValidMovement (unsigned int vertex, unsigned int otherVertex, const glm::dvec3& position) const
+{
+	for (unsigned int triangleIndex : vertexTriangles[vertex]) {
+		const Triangle& triangle = triangles[triangleIndex];
+		if (triangle.v[0] == otherVertex || triangle.v[1] == otherVertex || triangle.v[2] == otherVertex) {
+			continue;
+		}
+		glm::dvec3 oldPositions[3];
+		glm::dvec3 newPositions[3];
+		for (int i = 0; i < 3; i++) {
+			oldPositions[i] = positions[triangle.v[i]];
+			newPositions[i] = (triangle.v[i] == vertex) ? position : oldPositions[i];
+		}
+		glm::dvec3 oldNormal = CalculateTriangleNormal (oldPositions[0], oldPositions[1], oldPositions[2]);
+		glm::dvec3 newNormal = CalculateTriangleNormal (newPositions[0], newPositions[1], newPositions[2]);
+		double oldLength = glm::length (oldNormal);
+		double newLength = glm::length (newNormal);
+		if (newLength <= oldLength * 1.0e-6) {
+			return false;
+		}
+		if (oldLength > 0.0 && glm::dot (oldNormal, newNormal) < MinNormalCosineAfterCollapse * oldLength * newLength) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void MeshSimplifier::Collapse (unsigned int vertex1, unsigned int vertex2, const glm::dvec3& position)
+{
+	positions[vertex1] = position;
+	quadrics[vertex1].Add (quadrics[vertex2]);
+	isBoundary[vertex1] = isBoundary[vertex1] || isBoundary[vertex2];
+	isRemoved[vertex2] = true;
+	stamps[vertex1]++;
+	stamps[vertex2]++;
+
+	// the triangles of the collapsed edge tell which normal of the removed vertex continues
+	// in which normal of the kept vertex, normals on the two sides of a hard edge are mapped
+	// separately, and the normals without a pair are kept as they are
+	normalPairs.clear ();
+	for (unsigned int triangleIndex : vertexTriangles[vertex2]) {
+		const Triangle& triangle = triangles[triangleIndex];
+		for (int i = 0; i < 3; i++) {
+			if (triangle.v[i] != vertex1) {
+				continue;
+			}
+			for (int j = 0; j < 3; j++) {
+				if (triangle.v[j] == vertex2) {
+					normalPairs.push_back ({ triangle.n[j], triangle.n[i] });
+				}
+			}
+		}
+	}
+
+	std::vector<unsigned int>& triangles1 = vertexTriangles[vertex1];
+	for (unsigned int triangleIndex : vertexTriangles[vertex2]) {
+		Triangle& triangle = triangles[triangleIndex];
+		if (triangle.v[0] == vertex1 || triangle.v[1] == vertex1 || triangle.v[2] == vertex1) {
+			triangle.isRemoved = true;
+			triangleCount--;
+		} else {
+			for (int i = 0; i < 3; i++) {
+				if (triangle.v[i] != vertex2) {
+					continue;
+				}
+				triangle.v[i] = vertex1;
+				if (triangle.isFlat) {
+					continue;
+				}
+				for (const std::pair<unsigned int, unsigned int>& normalPair : normalPairs) {
+					if (normalPair.first == triangle.n[i]) {
+						triangle.n[i] = normalPair.second;
+						break;
+					}
+				}
+			}
+			triangles1.push_back (triangleIndex);
+		}
+	}
+	std::vector<unsigned int> ().swap (vertexTriangles[vertex2]);
+	CompactVertexTriangles (vertex1);
+
+	PushCandidates (vertex1);
+}
+
+void MeshSimplifier::CompactVertexTriangles (unsigned int vertex)
+{
+	std::vector<unsigned int>& vertexTriangleList = vertexTriangles[vertex];
+	vertexTriangleList.erase (std::remove_if (vertexTriangleList.begin (), vertexTriangleList.end (), [&] (unsigned int triangleIndex) {
+		return triangles[triangleIndex].isRemoved;
+	}), vertexTriangleList.end ());
+}
+
+void MeshSimplifier::CollectNeighbours (unsigned int vertex, std::vector<unsigned int>& neighbours) const
+{
+	neighbours.clear ();
+	for (unsigned int triangleIndex : vertexTriangles[vertex]) {
+		const Triangle& triangle = triangles[triangleIndex];
+		if (triangle.isRemoved) {
+			continue;
+		}
+		for (unsigned int neighbour : triangle.v) {
+			if (neighbour != vertex) {
+				neighbours.push_back (neighbour);
+			}
+		}
+	}
+	std::sort (neighbours.begin (), neighbours.end ());
+	neighbours.erase (std::unique (neighbours.begin (), neighbours.end ()), neighbours.end ());
+}
+
+void MeshSimplifier::PushCandidates (unsigned int vertex)
+{
+	CollectNeighbours (vertex, neighbours1);
+	for (unsigned int neighbour : neighbours1) {
+		CollapseCandidate candidate;
+		if (CalculateCandidate (vertex, neighbour, candidate)) {
+			candidates.push (candidate);
+		}
+	}
+}
+
+Mesh SimplifyMesh (const MeshGeometry& geometry, const MeshMaterials& materials, unsigned int targetTriangleCount)
+{
+	MeshSimplifier simplifier (geometry, materials);
+	simplifier.Simplify (targetTriangleCount);
+	return simplifier.GetResult ();
+}
+
+Mesh SimplifyMesh (const Mesh& mesh, double ratio)
+{
+	if (!Geometry::IsGreater (ratio, 0.0) || Geometry::IsGreater (ratio, 1.0)) {
+		throw std::logic_error ("invalid simplification ratio");
+	}
+	const MeshGeometry& geometry = mesh.GetGeometry ();
+	unsigned int targetTriangleCount = (unsigned int) (ratio * geometry.TriangleCount ());
+	Mesh result = SimplifyMesh (geometry, mesh.GetMaterials (), targetTriangleCount);
+	result.SetTransformation (mesh.GetTransformation ());
+	return result;
+}
+
+static MeshLodChain BuildMeshLodChain (const MeshGeometry& geometry, const MeshMaterials& materials, const std::vector<double>& ratios)
+{
+	MeshLodChain lodChain;
+	lodChain.reserve (ratios.size ());
+	for (double ratio : ratios) {
+		if (!Geometry::IsGreater (ratio, 0.0) || Geometry::IsGreater (ratio, 1.0)) {
+			throw std::logic_error ("invalid simplification ratio");
+		}
+		unsigned int targetTriangleCount = (unsigned int) (ratio * geometry.TriangleCount ());
+		if (lodChain.empty ()) {
+			lodChain.push_back (SimplifyMesh (geometry, materials, targetTriangleCount));
+		} else {
+			const Mesh& previous = lodChain.back ();
+			lodChain.push_back (SimplifyMesh (previous.GetGeometry (), previous.GetMaterials (), targetTriangleCount));
+		}
+	}
+	return lodChain;
+}
+
+MeshLodChain BuildMeshLodChain (const Mesh& mesh, const std::vector<double>& ratios)
+{
+	MeshLodChain lodChain = BuildMeshLodChain (mesh.GetGeometry (), mesh.GetMaterials (), ratios);
+	for (Mesh& lod : lodChain) {
+		lod.SetTransformation (mesh.GetTransformation ());
+	}
+	return lodChain;
+}
+
+std::size_t MeshLodKeyHash::operator() (const MeshLodKey& key) const
+{
+	std::hash<int> hasher;
+	return hasher (key.first) ^ (hasher (key.second) * 31);
+}
+
+std::unordered_map<MeshLodKey, MeshLodChain, MeshLodKeyHash> BuildMeshLodChains (const Model& model, const std::vector<double>& ratios)
+{
+	// geometries are simplified in their own coordinate system
+	std::unordered_map<MeshLodKey, MeshLodChain, MeshLodKeyHash> lodChains;
+	model.EnumerateMeshes ([&] (MeshId, const MeshRef& meshRef) {
+		MeshLodKey key (meshRef.GetGeometryId (), meshRef.GetMaterialsId ());
+		if (lodChains.find (key) != lodChains.end ()) {
+			return;
+		}
+		lodChains.insert ({ key, BuildMeshLodChain (model.GetMeshGeometry (meshRef), model.GetMeshMaterials (meshRef), ratios) });
+	});
+	return lodChains;
+}
+
+}
@@ -0,0 +1,40 @@
+#ifndef MODELER_MESHSIMPLIFICATION_HPP
+#define MODELER_MESHSIMPLIFICATION_HPP
+
+#include "Mesh.hpp"
+#include "Model.hpp"
+
+#include <vector>
+#include <unordered_map>
+
+namespace Modeler
+{
+
+using MeshLodChain = std::vector<Mesh>;
+using MeshLodKey = std::pair<MeshGeometryId, MeshMaterialsId>;
+
+class MeshLodKeyHash
+{
+public:
+	std::size_t operator() (const MeshLodKey& key) const;
+};
+
+// Quadric error edge collapse simplification. Edges are collapsed in the order of
+// their error until the triangle count reaches the target. Open edges and edges
+// between triangles of different materials are preserved, triangles keep their
+// original material, and the result refers to the same material ids. Smooth triangles
+// keep the original normals of their corners, so hard edges survive, and triangles with
+// one normal on every corner stay flat with a normal recalculated from their new shape.
+Mesh					SimplifyMesh (const MeshGeometry& geometry, const MeshMaterials& materials, unsigned int targetTriangleCount);
+Mesh					SimplifyMesh (const Mesh& mesh, double ratio);
+
+// builds one level for every ratio, each level is simplified from the previous one
+MeshLodChain			BuildMeshLodChain (const Mesh& mesh, const std::vector<double>& ratios);
+
+// builds one chain for every geometry and materials pair of the model, the materials decide
+// the preserved boundaries, so meshes sharing a geometry with other materials get own chains
+std::unordered_map<MeshLodKey, MeshLodChain, MeshLodKeyHash>	BuildMeshLodChains (const Model& model, const std::vector<double>& ratios);
+
+}
+
+#endif
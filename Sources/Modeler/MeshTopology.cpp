@@ -1,10 +1,97 @@
 #include "MeshTopology.hpp"
+#include "ParallelFor.hpp"
+
+#include <cstdint>
+#include <stdexcept>
 
 namespace Modeler
 {
 
 const unsigned int NoTriangle = (unsigned int) -1;
 
+// below this count starting threads costs more than sorting on one thread
+static const size_t MinParallelRecordCount = 65536;
+
+struct EdgeRecord
+{
+	std::uint64_t	key;
+	unsigned int	record;
+};
+
+static std::uint64_t GetEdgeKey (unsigned int v1, unsigned int v2)
+{
+	return ((std::uint64_t) std::min (v1, v2) << 32) | std::max (v1, v2);
+}
+
+static void SortEdgeRecords (std::vector<EdgeRecord>& records, bool isParallel)
+{
+	// least significant digit radix sort, it is stable, so the records of an edge remain in
+	// creation order, the digits which are the same in every key don't need a pass
+	const int DigitBits = 11;
+	const size_t BucketCount = 1 << DigitBits;
+	const std::uint64_t DigitMask = BucketCount - 1;
+	if (records.empty ()) {
+		return;
+	}
+
+	size_t chunkCount = isParallel ? GetParallelThreadCount () : 1;
+	size_t chunkSize = (records.size () + chunkCount - 1) / chunkCount;
+	auto GetChunkStart = [&] (size_t chunk) {
+		return std::min (chunk * chunkSize, records.size ());
+	};
+
+	std::vector<std::uint64_t> chunkDifferences (chunkCount, 0);
+	ParallelForRanges (chunkCount, isParallel, [&] (size_t firstChunk, size_t endChunk) {
+		for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+			for (size_t i = GetChunkStart (chunk); i < GetChunkStart (chunk + 1); i++) {
+				chunkDifferences[chunk] |= records[i].key ^ records[0].key;
+			}
+		}
+	});
+	std::uint64_t differentBits = 0;
+	for (std::uint64_t difference : chunkDifferences) {
+		differentBits |= difference;
+	}
+
+	std::vector<EdgeRecord> sorted (records.size ());
+	std::vector<size_t> offsets (chunkCount * BucketCount);
+	for (int shift = 0; shift < 64; shift += DigitBits) {
+		if (((differentBits >> shift) & DigitMask) == 0) {
+			continue;
+		}
+
+		std::fill (offsets.begin (), offsets.end (), 0);
+		ParallelForRanges (chunkCount, isParallel, [&] (size_t firstChunk, size_t endChunk) {
+			for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+				size_t* counts = &offsets[chunk * BucketCount];
+				for (size_t i = GetChunkStart (chunk); i < GetChunkStart (chunk + 1); i++) {
+					counts[(records[i].key >> shift) & DigitMask]++;
+				}
+			}
+		});
+
+		// every chunk writes its records of a bucket after the ones of the previous chunks
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < BucketCount; bucket++) {
+			for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+				size_t count = offsets[chunk * BucketCount + bucket];
+				offsets[chunk * BucketCount + bucket] = offset;
+				offset += count;
+			}
+		}
+
+		ParallelForRanges (chunkCount, isParallel, [&] (size_t firstChunk, size_t endChunk) {
+			for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+				size_t* chunkOffsets = &offsets[chunk * BucketCount];
+				for (size_t i = GetChunkStart (chunk); i < GetChunkStart (chunk + 1); i++) {
+					sorted[chunkOffsets[(records[i].key >> shift) & DigitMask]++] = records[i];
+				}
+			}
+		});
+		std::swap (records, sorted);
+	}
+}
+
 MeshTopology::MeshTopology () :
 	isValid (true)
 {
@@ -47,9 +134,56 @@ bool MeshTopology::IsClosed () const
 	return true;
 }
 
+std::vector<unsigned int> FindFirstTriangleEdges (const MeshGeometry& geometry)
+{
+	// every triangle edge gets a record with an index of triangle index * 3 + edge index
+	const std::vector<MeshTriangle>& triangles = geometry.GetTriangles ();
+	size_t recordCount = triangles.size () * 3;
+	bool isParallel = recordCount >= MinParallelRecordCount;
+	std::vector<EdgeRecord> records (recordCount);
+	ParallelForRanges (triangles.size (), isParallel, [&] (size_t start, size_t end) {
+		for (size_t i = start; i < end; i++) {
+			const MeshTriangle& triangle = triangles[i];
+			unsigned int record = (unsigned int) i * 3;
+			records[record] = { GetEdgeKey (triangle.v1, triangle.v2), record };
+			records[record + 1] = { GetEdgeKey (triangle.v2, triangle.v3), record + 1 };
+			records[record + 2] = { GetEdgeKey (triangle.v3, triangle.v1), record + 2 };
+		}
+	});
+	SortEdgeRecords (records, isParallel);
+
+	// every record gets the first record of its edge, it is the first one after the stable sort
+	std::vector<unsigned int> recordEdges (recordCount);
+	ParallelForRanges (recordCount, isParallel, [&] (size_t start, size_t end) {
+		size_t first = start;
+		while (first > 0 && records[first - 1].key == records[start].key) {
+			first--;
+		}
+		for (size_t i = start; i < end; i++) {
+			if (records[i].key != records[first].key) {
+				first = i;
+			}
+			recordEdges[records[i].record] = records[first].record;
+		}
+	});
+	return recordEdges;
+}
+
 bool MeshTopologyBuilder::EdgeKey::operator== (const EdgeKey& rhs) const
 {
-	return (beg == rhs.beg && end == rhs.end) || (beg == rhs.end && end == rhs.beg);
+	return min == rhs.min && max == rhs.max;
+}
+
+std::size_t MeshTopologyBuilder::EdgeKeyHash::operator() (const EdgeKey& key) const
+{
+	// blocks of 16 x 16 index pairs are mixed with the finalizer of splitmix64, so regular index
+	// patterns don't end up in the same buckets, but the edges around a vertex mostly stay in
+	// neighbouring buckets, that keeps the lookups cache friendly on large meshes
+	std::uint64_t hash = ((std::uint64_t) (key.min >> 4) << 32) | (key.max >> 4);
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+	hash ^= hash >> 31;
+	return (std::size_t) ((hash << 8) | ((key.min & 15) << 4) | (key.max & 15));
 }
 
 MeshTopologyBuilder::MeshTopologyBuilder (MeshTopology& topology) :
@@ -58,6 +192,15 @@ MeshTopologyBuilder::MeshTopologyBuilder (MeshTopology& topology) :
 
 }
 
+void MeshTopologyBuilder::Reserve (unsigned int triangleCount)
+{
+	// a closed mesh has one and a half edges per triangle, reserving avoids rehashing the edges
+	unsigned int edgeCount = triangleCount + triangleCount / 2;
+	topology.triangles.reserve (triangleCount);
+	topology.edges.reserve (edgeCount);
+	edgeMap.reserve (edgeCount);
+}
+
 MeshTopologyBuilder::Result MeshTopologyBuilder::AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3)
 {
 	if (!topology.isValid) {
@@ -94,20 +237,68 @@ MeshTopologyBuilder::Result MeshTopologyBuilder::AddTriangleEdges (MeshTopology:
 	return Result::NoError;
 }
 
-MeshTopologyBuilder::Result MeshTopologyBuilder::AddEdge (unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge)
+MeshTopologyBuilder::Result MeshTopologyBuilder::Build (const MeshGeometry& geometry, MeshTopology& topology)
 {
-	EdgeKey key {v1, v2};
+	topology.Clear ();
+	topology.isValid = true;
+
+	const std::vector<MeshTriangle>& triangles = geometry.GetTriangles ();
+	size_t recordCount = triangles.size () * 3;
+	std::vector<unsigned int> recordEdges = FindFirstTriangleEdges (geometry);
+
+	// the edges are created and linked in record order like in the incremental build, the first
+	// record of an edge replaces its own entry with the index of the new edge
+	topology.triangles.resize (triangles.size ());
+	for (unsigned int record = 0; record < recordCount; record++) {
+		unsigned int triangleIndex = record / 3;
+		const MeshTriangle& triangle = triangles[triangleIndex];
+		MeshTopology::Triangle& topologyTriangle = topology.triangles[triangleIndex];
+		unsigned int v1 = triangle.v1;
+		unsigned int v2 = triangle.v2;
+		MeshTopology::TriangleEdge* triEdge = &topologyTriangle.edge1;
+		if (record % 3 == 1) {
+			v1 = triangle.v2;
+			v2 = triangle.v3;
+			triEdge = &topologyTriangle.edge2;
+		} else if (record % 3 == 2) {
+			v1 = triangle.v3;
+			v2 = triangle.v1;
+			triEdge = &topologyTriangle.edge3;
+		}
 
-	auto found = edgeMap.find (key);
-	if (found == edgeMap.end ()) {
+		if (recordEdges[record] == record) {
+			recordEdges[record] = (unsigned int) topology.edges.size ();
+			topology.edges.push_back (MeshTopology::Edge { v1, v2, NoTriangle, NoTriangle });
+			triEdge->edge = recordEdges[record];
+		} else {
+			triEdge->edge = recordEdges[recordEdges[record]];
+		}
+
+		Result result = LinkEdge (topology.edges[triEdge->edge], v1, v2, triangleIndex, *triEdge);
+		if (result != Result::NoError) {
+			topology.isValid = false;
+			topology.Clear ();
+			return result;
+		}
+	}
+
+	return Result::NoError;
+}
+
+MeshTopologyBuilder::Result MeshTopologyBuilder::AddEdge (unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge)
+{
+	EdgeKey key { std::min (v1, v2), std::max (v1, v2) };
+	auto inserted = edgeMap.insert ({ key, (unsigned int) topology.edges.size () });
+	if (inserted.second) {
 		topology.edges.push_back (MeshTopology::Edge { v1, v2, NoTriangle, NoTriangle });
-		edgeMap.insert ({ key, (unsigned int) topology.edges.size () - 1 });
 	}
 
-	triEdge.edge = edgeMap[key];
-	triEdge.reversed = false;
-	MeshTopology::Edge& edge = topology.edges[triEdge.edge];
+	triEdge.edge = inserted.first->second;
+	return LinkEdge (topology.edges[triEdge.edge], v1, v2, triangle, triEdge);
+}
 
+MeshTopologyBuilder::Result MeshTopologyBuilder::LinkEdge (MeshTopology::Edge& edge, unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge)
+{
 	if (edge.beg == v1 && edge.end == v2) {
 		if (edge.triangle1 != NoTriangle) {
 			return Result::NonManifoldEdgeFound;
@@ -1,8 +1,9 @@
 #ifndef MODELER_MESHTOPOLOGY_HPP
 #define MODELER_MESHTOPOLOGY_HPP
 
+#include "Mesh.hpp"
+
 #include <vector>
-#include <functional>
 #include <unordered_map>
 
 namespace Modeler
@@ -65,33 +66,41 @@ public:
 
 	MeshTopologyBuilder (MeshTopology& topology);
 
-	Result	AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3);
+	void			Reserve (unsigned int triangleCount);
+	Result			AddTriangle (unsigned int v1, unsigned int v2, unsigned int v3);
+
+	// Builds the topology of all the triangles at once by sorting the edges instead of looking
+	// them up one by one. The result is the same as adding the triangles in order to an empty
+	// topology, but it is much faster for large meshes.
+	static Result	Build (const MeshGeometry& geometry, MeshTopology& topology);
 
 private:
 	struct EdgeKey
 	{
 		bool			operator== (const EdgeKey& rhs) const;
 
-		unsigned int	beg;
-		unsigned int	end;
+		unsigned int	min;
+		unsigned int	max;
 	};
 	
 	struct EdgeKeyHash
 	{
-		template <class EdgeKey>
-		std::size_t operator() (const EdgeKey& key) const
-		{
-			return std::hash<unsigned int> {} (key.beg) + std::hash<unsigned int> {} (key.end);
-		}
+		std::size_t operator() (const EdgeKey& key) const;
 	};
 
-	Result	AddTriangleEdges (MeshTopology::Triangle& triangle, unsigned int v1, unsigned int v2, unsigned int v3);
-	Result	AddEdge (unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge);
+	Result			AddTriangleEdges (MeshTopology::Triangle& triangle, unsigned int v1, unsigned int v2, unsigned int v3);
+	Result			AddEdge (unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge);
+
+	static Result	LinkEdge (MeshTopology::Edge& edge, unsigned int v1, unsigned int v2, unsigned int triangle, MeshTopology::TriangleEdge& triEdge);
 
 	MeshTopology&												topology;
 	std::unordered_map<EdgeKey, unsigned int, EdgeKeyHash>		edgeMap;
 };
 
+// Returns the first triangle edge on the same vertices for every triangle edge. The triangle
+// edges are indexed as triangle index * 3 + edge index, and they are grouped by sorting.
+std::vector<unsigned int> FindFirstTriangleEdges (const MeshGeometry& geometry);
+
 }
 
 #endif
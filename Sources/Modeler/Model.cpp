@@ -8,10 +8,28 @@
 namespace Modeler
 {
 
-MeshRef::MeshRef (MeshGeometryId geometryId, MeshMaterialsId& materialsId, const glm::dmat4& transformation) :
+static bool IsOnBoundary (const Geometry::BoundingBox& box, const Geometry::BoundingBox& hull)
+{
+	if (!box.IsValid ()) {
+		return false;
+	}
+	const glm::dvec3& boxMin = box.GetMin ();
+	const glm::dvec3& boxMax = box.GetMax ();
+	const glm::dvec3& hullMin = hull.GetMin ();
+	const glm::dvec3& hullMax = hull.GetMax ();
+	for (int i = 0; i < 3; i++) {
+		if (boxMin[i] <= hullMin[i] || boxMax[i] >= hullMax[i]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+MeshRef::MeshRef (MeshGeometryId geometryId, MeshMaterialsId& materialsId, const glm::dmat4& transformation, const Geometry::BoundingBox& boundingBox) :
 	geometryId (geometryId),
 	materialsId (materialsId),
-	transformation (transformation)
+	transformation (transformation),
+	boundingBox (boundingBox)
 {
 }
 
@@ -30,6 +48,11 @@ const glm::dmat4& MeshRef::GetTransformation () const
 	return transformation;
 }
 
+const Geometry::BoundingBox& MeshRef::GetBoundingBox () const
+{
+	return boundingBox;
+}
+
 void MeshRef::SetUserData (const std::string& key, const UserDataConstPtr& data)
 {
 	userData.Set (key, data);
@@ -41,12 +64,26 @@ UserDataConstPtr MeshRef::GetUserData (const std::string & key) const
 }
 
 Model::Model () :
-	nextMeshId (0),
+	geometryStorage (MeshGeometryStorage::Double),
+	vertexCount (0),
+	triangleCount (0),
+	boundingBox (),
+	isBoundingBoxValid (true),
 	nextMaterialId (0)
 {
 	Clear ();
 }
 
+MeshGeometryStorage Model::GetGeometryStorage () const
+{
+	return geometryStorage;
+}
+
+void Model::SetGeometryStorage (MeshGeometryStorage newGeometryStorage)
+{
+	geometryStorage = newGeometryStorage;
+}
+
 const MeshGeometry& Model::GetMeshGeometry (const MeshRef& meshRef) const
 {
 	return geometries.GetData (meshRef.GetGeometryId ());
@@ -57,16 +94,42 @@ const MeshMaterials& Model::GetMeshMaterials (const MeshRef& meshRef) const
 	return materials.GetData (meshRef.GetMaterialsId ());
 }
 
-const MeshRef& Model::GetMesh (MeshId meshId) const
+const HalfEdgeMesh& Model::GetMeshHalfEdges (const MeshRef& meshRef) const
+{
+	MeshGeometryId geometryId = meshRef.GetGeometryId ();
+	auto found = halfEdgeMeshes.find (geometryId);
+	if (found == halfEdgeMeshes.end ()) {
+		std::unique_ptr<HalfEdgeMesh> halfEdgeMesh (new HalfEdgeMesh (geometries.GetData (geometryId)));
+		found = halfEdgeMeshes.insert ({ geometryId, std::move (halfEdgeMesh) }).first;
+	}
+	return *found->second;
+}
+
+const MeshBVH& Model::GetMeshBVH (const MeshRef& meshRef) const
 {
-	return meshRefs.at (meshId);
+	MeshGeometryId geometryId = meshRef.GetGeometryId ();
+	auto found = meshBVHs.find (geometryId);
+	if (found == meshBVHs.end ()) {
+		std::unique_ptr<MeshBVH> meshBVH (new MeshBVH (geometries.GetData (geometryId)));
+		found = meshBVHs.insert ({ geometryId, std::move (meshBVH) }).first;
+	}
+	return *found->second;
 }
 
-void Model::EnumerateMeshes (const std::function<void (MeshId, const MeshRef&)>& processor) const
+const MeshPacketTriangles& Model::GetMeshPacketTriangles (const MeshRef& meshRef) const
 {
-	for (const auto& it : meshRefs) {
-		processor (it.first, it.second);
+	MeshGeometryId geometryId = meshRef.GetGeometryId ();
+	auto found = meshPacketTriangles.find (geometryId);
+	if (found == meshPacketTriangles.end ()) {
+		std::unique_ptr<MeshPacketTriangles> packetTriangles (new MeshPacketTriangles (geometries.GetData (geometryId), GetMeshBVH (meshRef)));
+		found = meshPacketTriangles.insert ({ geometryId, std::move (packetTriangles) }).first;
 	}
+	return *found->second;
+}
+
+const MeshRef& Model::GetMesh (MeshId meshId) const
+{
+	return meshRefs.Get (meshId);
 }
 
 MeshId Model::AddMesh (const Mesh& mesh)
@@ -75,37 +138,69 @@ MeshId Model::AddMesh (const Mesh& mesh)
 	const MeshMaterials& meshMaterials = mesh.GetMaterials ();
 	const glm::dmat4& transformation = mesh.GetTransformation ();
 
-	MeshGeometryId meshGeometryId = geometries.AddReference (meshGeometry, meshGeometry.CalcCheckSum ());
+	MeshGeometryId meshGeometryId = -1;
+	if (meshGeometry.GetStorage () == geometryStorage) {
+		meshGeometryId = geometries.AddReference (meshGeometry, meshGeometry.CalcCheckSum ());
+	} else {
+		meshGeometryId = AddGeometry (MeshGeometry (meshGeometry));
+	}
 	MeshGeometryId meshMaterialsId = materials.AddReference (meshMaterials, meshMaterials.CalcCheckSum ());
+	return AddMeshRef (meshGeometryId, meshMaterialsId, transformation);
+}
 
-	MeshRef meshRef (meshGeometryId, meshMaterialsId, transformation);
-	MeshId meshId = nextMeshId++;
-	meshRefs.insert ({ meshId, meshRef });
-	return meshId;
+MeshId Model::AddMesh (Mesh&& mesh)
+{
+	Checksum materialsChecksum = mesh.GetMaterials ().CalcCheckSum ();
+	glm::dmat4 transformation = mesh.GetTransformation ();
+
+	MeshGeometryId meshGeometryId = AddGeometry (mesh.ReleaseGeometry ());
+	MeshGeometryId meshMaterialsId = materials.AddReference (mesh.ReleaseMaterials (), materialsChecksum);
+	return AddMeshRef (meshGeometryId, meshMaterialsId, transformation);
 }
 
 void Model::SetMeshUserData (MeshId meshId, const std::string& key, const UserDataConstPtr& data)
 {
-	MeshRef& meshRef = meshRefs.at (meshId);
+	MeshRef& meshRef = meshRefs.Get (meshId);
 	meshRef.SetUserData (key, data);
 }
 
 void Model::RemoveMesh (MeshId meshId)
 {
-	const MeshRef& meshRef = meshRefs.at (meshId);
+	const MeshRef& meshRef = meshRefs.Get (meshId);
 	MeshGeometryId meshGeometryId = meshRef.GetGeometryId ();
 	MeshGeometryId meshMaterialsId = meshRef.GetMaterialsId ();
-	geometries.RemoveReference (meshGeometryId);
+
+	const MeshGeometry& geometry = geometries.GetData (meshGeometryId);
+	vertexCount -= geometry.VertexCount ();
+	triangleCount -= geometry.TriangleCount ();
+	if (isBoundingBoxValid && IsOnBoundary (meshRef.GetBoundingBox (), boundingBox)) {
+		isBoundingBoxValid = false;
+	}
+	if (meshRef.GetBoundingBox ().IsValid ()) {
+		instanceBVH.RemoveInstance (meshId);
+	}
+	geometries.RemoveReference (meshGeometryId, [&] (MeshGeometryId erasedGeometryId) {
+		halfEdgeMeshes.erase (erasedGeometryId);
+		meshBVHs.erase (erasedGeometryId);
+		meshPacketTriangles.erase (erasedGeometryId);
+	});
 	materials.RemoveReference (meshMaterialsId);
-	meshRefs.erase (meshId);
+	meshRefs.Erase (meshId);
 }
 
 void Model::Clear ()
 {
 	geometries.Clear ();
 	materials.Clear ();
-	meshRefs.clear ();
-	nextMeshId = 0;
+	meshRefs.Clear ();
+	halfEdgeMeshes.clear ();
+	meshBVHs.clear ();
+	meshPacketTriangles.clear ();
+	instanceBVH.Clear ();
+	vertexCount = 0;
+	triangleCount = 0;
+	boundingBox = Geometry::BoundingBox ();
+	isBoundingBoxValid = true;
 	nextMaterialId = 0;
 }
 
@@ -114,30 +209,21 @@ ModelInfo Model::GetInfo () const
 	ModelInfo modelInfo;
 	modelInfo.meshGeometryCount = (unsigned int) geometries.DataCount ();
 	modelInfo.meshMaterialsCount = (unsigned int) materials.DataCount ();
-	modelInfo.meshCount = (unsigned int) meshRefs.size ();
-	modelInfo.vertexCount = 0;
-	modelInfo.triangleCount = 0;
-	for (const auto& it : meshRefs) {
-		const MeshRef& meshRef = it.second;
-		const MeshGeometry& geometry = geometries.GetData (meshRef.GetGeometryId ());
-		modelInfo.vertexCount += geometry.VertexCount ();
-		modelInfo.triangleCount += geometry.TriangleCount ();
-	}
+	modelInfo.meshCount = (unsigned int) meshRefs.Count ();
+	modelInfo.vertexCount = vertexCount;
+	modelInfo.triangleCount = triangleCount;
 	return modelInfo;
 }
 
 Geometry::BoundingBox Model::GetBoundingBox () const
 {
-	Geometry::BoundingBox boundingBox;
-	EnumerateMeshes ([&] (MeshId, const MeshRef& meshRef) {
-		const MeshGeometry& geometry = GetMeshGeometry (meshRef);
-		const Geometry::BoundingBox& geometryBoundingBox = geometry.GetBoundingBox ();
-		const glm::dmat4& transformation = meshRef.GetTransformation ();
-		Geometry::BoundingBox transformedBoundingBox = geometryBoundingBox.Transform (transformation);
-		transformedBoundingBox.EnumerateBoundingPoints ([&] (const glm::dvec3& point) {
-			boundingBox.AddPoint (point);
+	if (!isBoundingBoxValid) {
+		boundingBox = Geometry::BoundingBox ();
+		meshRefs.Enumerate ([&] (MeshId, const MeshRef& meshRef) {
+			boundingBox.AddBox (meshRef.GetBoundingBox ());
 		});
-	});
+		isBoundingBoxValid = true;
+	}
 	return boundingBox;
 }
 
@@ -153,4 +239,28 @@ Geometry::BoundingSphere Model::GetBoundingSphere () const
 	return Geometry::BoundingSphere (center, radius);
 }
 
+MeshId Model::AddMeshRef (MeshGeometryId geometryId, MeshMaterialsId materialsId, const glm::dmat4& transformation)
+{
+	const MeshGeometry& geometry = geometries.GetData (geometryId);
+	vertexCount += geometry.VertexCount ();
+	triangleCount += geometry.TriangleCount ();
+
+	Geometry::BoundingBox meshBoundingBox = geometry.GetBoundingBox ().Transform (transformation);
+	if (isBoundingBoxValid) {
+		boundingBox.AddBox (meshBoundingBox);
+	}
+	MeshId meshId = meshRefs.Insert (MeshRef (geometryId, materialsId, transformation, meshBoundingBox));
+	if (meshBoundingBox.IsValid ()) {
+		instanceBVH.AddInstance (meshId, meshBoundingBox);
+	}
+	return meshId;
+}
+
+MeshGeometryId Model::AddGeometry (MeshGeometry&& geometry)
+{
+	geometry.SetStorage (geometryStorage);
+	Checksum checksum = geometry.CalcCheckSum ();
+	return geometries.AddReference (std::move (geometry), checksum);
+}
+
 }
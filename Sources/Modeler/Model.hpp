@@ -4,13 +4,19 @@
 #include "Checksum.hpp"
 #include "IncludeGLM.hpp"
 #include "Mesh.hpp"
+#include "HalfEdgeMesh.hpp"
+#include "MeshBVH.hpp"
+#include "InstanceBVH.hpp"
+#include "MeshPacketTriangles.hpp"
 #include "UserData.hpp"
 #include "SharedData.hpp"
+#include "SlotMap.hpp"
 #include "BoundingShapes.hpp"
 
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <limits>
 
 namespace Modeler
 {
@@ -22,20 +28,22 @@ using MeshId = int;
 class MeshRef
 {
 public:
-	MeshRef (MeshGeometryId geometryId, MeshMaterialsId& materialsId, const glm::dmat4& transformation);
+	MeshRef (MeshGeometryId geometryId, MeshMaterialsId& materialsId, const glm::dmat4& transformation, const Geometry::BoundingBox& boundingBox);
 
-	MeshGeometryId		GetGeometryId () const;
-	MeshMaterialsId		GetMaterialsId () const;
-	const glm::dmat4&	GetTransformation () const;
+	MeshGeometryId					GetGeometryId () const;
+	MeshMaterialsId					GetMaterialsId () const;
+	const glm::dmat4&				GetTransformation () const;
+	const Geometry::BoundingBox&	GetBoundingBox () const;
 
-	void				SetUserData (const std::string& key, const UserDataConstPtr& data);
-	UserDataConstPtr	GetUserData (const std::string& key) const;
+	void							SetUserData (const std::string& key, const UserDataConstPtr& data);
+	UserDataConstPtr				GetUserData (const std::string& key) const;
 
 private:
-	MeshGeometryId		geometryId;
-	MeshMaterialsId		materialsId;
-	glm::dmat4			transformation;
-	UserDataCollection	userData;
+	MeshGeometryId			geometryId;
+	MeshMaterialsId			materialsId;
+	glm::dmat4				transformation;
+	Geometry::BoundingBox	boundingBox;
+	UserDataCollection		userData;
 };
 
 class ModelInfo
@@ -58,13 +66,39 @@ public:
 	Model&						operator= (const Model& rhs) = delete;
 	Model&						operator= (Model&& rhs) = delete;
 
+	// the storage is applied to geometries added after setting it
+	MeshGeometryStorage			GetGeometryStorage () const;
+	void						SetGeometryStorage (MeshGeometryStorage newGeometryStorage);
+
 	const MeshGeometry&			GetMeshGeometry (const MeshRef& meshRef) const;
 	const MeshMaterials&		GetMeshMaterials (const MeshRef& meshRef) const;
 
+	// built on first use and cached until the geometry is dropped from the model
+	const HalfEdgeMesh&			GetMeshHalfEdges (const MeshRef& meshRef) const;
+	const MeshBVH&				GetMeshBVH (const MeshRef& meshRef) const;
+	const MeshPacketTriangles&	GetMeshPacketTriangles (const MeshRef& meshRef) const;
+
 	const MeshRef&				GetMesh (MeshId meshId) const;
-	void						EnumerateMeshes (const std::function<void (MeshId, const MeshRef&)>& processor) const;
+	template <typename ProcessorType>
+	void						EnumerateMeshes (ProcessorType processor) const;
+	// processor (meshId, meshRef) for the meshes whose bounding box may be hit by the ray
+	template <typename ProcessorType>
+	void						EnumerateRayMeshes (const Geometry::Ray& ray, ProcessorType processor) const;
+	// the same for the bounding boxes closer than maxDistance, the processor may decrease
+	// maxDistance to skip the farther meshes, or make it negative to stop
+	template <typename ProcessorType>
+	void						EnumerateRayMeshes (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const;
+	// processor (meshId, meshRef) for the meshes whose bounding box may be hit by any ray of
+	// the packet, the processor may decrease the max distances of the packet
+	template <typename ProcessorType>
+	void						EnumerateRayPacketMeshes (const RayPacket& packet, ProcessorType processor) const;
+	// processor (meshId, meshRef, isInside) for the meshes whose bounding box may intersect the
+	// frustum, isInside is true if the bounding box is surely inside
+	template <typename ProcessorType>
+	void						EnumerateFrustumMeshes (const Geometry::Frustum& frustum, ProcessorType processor) const;
 
 	MeshId						AddMesh (const Mesh& mesh);
+	MeshId						AddMesh (Mesh&& mesh);
 	void						SetMeshUserData (MeshId meshId, const std::string& key, const UserDataConstPtr& data);
 	void						RemoveMesh (MeshId meshId);
 	void						Clear ();
@@ -74,14 +108,67 @@ public:
 	Geometry::BoundingSphere	GetBoundingSphere () const;
 
 private:
+	MeshId						AddMeshRef (MeshGeometryId geometryId, MeshMaterialsId materialsId, const glm::dmat4& transformation);
+	MeshGeometryId				AddGeometry (MeshGeometry&& geometry);
+
+	MeshGeometryStorage							geometryStorage;
 	SharedData<MeshGeometryId, MeshGeometry>	geometries;
 	SharedData<MeshMaterialsId, MeshMaterials>	materials;
-	std::unordered_map<MeshId, MeshRef>			meshRefs;
+	SlotMap<MeshId, MeshRef>					meshRefs;
+
+	mutable std::unordered_map<MeshGeometryId, std::unique_ptr<HalfEdgeMesh>>			halfEdgeMeshes;
+	mutable std::unordered_map<MeshGeometryId, std::unique_ptr<MeshBVH>>				meshBVHs;
+	mutable std::unordered_map<MeshGeometryId, std::unique_ptr<MeshPacketTriangles>>	meshPacketTriangles;
+	mutable InstanceBVH																	instanceBVH;
+
+	unsigned int								vertexCount;
+	unsigned int								triangleCount;
+	mutable Geometry::BoundingBox				boundingBox;
+	mutable bool								isBoundingBoxValid;
 
-	MeshId		nextMeshId;
 	MaterialId	nextMaterialId;
 };
 
+template <typename ProcessorType>
+void Model::EnumerateMeshes (ProcessorType processor) const
+{
+	meshRefs.Enumerate (processor);
+}
+
+template <typename ProcessorType>
+void Model::EnumerateRayMeshes (const Geometry::Ray& ray, ProcessorType processor) const
+{
+	double maxDistance = std::numeric_limits<double>::max ();
+	EnumerateRayMeshes (ray, maxDistance, processor);
+}
+
+template <typename ProcessorType>
+void Model::EnumerateRayMeshes (const Geometry::Ray& ray, double& maxDistance, ProcessorType processor) const
+{
+	instanceBVH.Update ();
+	instanceBVH.EnumerateRayInstances (ray, maxDistance, [&] (MeshId meshId) {
+		processor (meshId, meshRefs.Get (meshId));
+	});
+}
+
+template <typename ProcessorType>
+void Model::EnumerateRayPacketMeshes (const RayPacket& packet, ProcessorType processor) const
+{
+	instanceBVH.Update ();
+	instanceBVH.EnumerateRayPacketInstances (packet, [&] (MeshId meshId) {
+		processor (meshId, meshRefs.Get (meshId));
+	});
+}
+
+template <typename ProcessorType>
+void Model::EnumerateFrustumMeshes (const Geometry::Frustum& frustum, ProcessorType processor) const
+{
+	instanceBVH.Update ();
+	instanceBVH.EnumerateFrustumInstances (frustum, [&] (MeshId meshId, bool isInside) {
+		processor (meshId, meshRefs.Get (meshId), isInside);
+	});
+}
+
 }
 
 #endif
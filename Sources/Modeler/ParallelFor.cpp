@@ -0,0 +1,12 @@
+#include "ParallelFor.hpp"
+
+namespace Modeler
+{
+
+size_t GetParallelThreadCount ()
+{
+	// the number of hardware threads is not always known, then it returns zero
+	return std::max ((size_t) std::thread::hardware_concurrency (), (size_t) 1);
+}
+
+}
@@ -0,0 +1,40 @@
+#ifndef MODELER_PARALLELFOR_HPP
+#define MODELER_PARALLELFOR_HPP
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+namespace Modeler
+{
+
+size_t GetParallelThreadCount ();
+
+// Splits [0, count) to one range per thread and calls processor (start, end) for every range.
+// The ranges depend only on the count and the thread count, so a processor may use them to
+// address per range data. Without parallelism the whole interval is processed as one range.
+template <typename ProcessorType>
+void ParallelForRanges (size_t count, bool isParallel, ProcessorType processor);
+
+template <typename ProcessorType>
+void ParallelForRanges (size_t count, bool isParallel, ProcessorType processor)
+{
+	size_t threadCount = GetParallelThreadCount ();
+	if (!isParallel || threadCount <= 1 || count <= 1) {
+		processor ((size_t) 0, count);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	size_t rangeSize = (count + threadCount - 1) / threadCount;
+	for (size_t start = 0; start < count; start += rangeSize) {
+		threads.push_back (std::thread (processor, start, std::min (start + rangeSize, count)));
+	}
+	for (std::thread& thread : threads) {
+		thread.join ();
+	}
+}
+
+}
+
+#endif
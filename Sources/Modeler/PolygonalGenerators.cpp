@@ -38,6 +38,7 @@ static void AddPolygonalSideTrianglesToMesh (Mesh& mesh, MaterialId materialId,
 	bool isReversed = sidePoly.IsReversedOrientation ();
 
 	std::vector<unsigned int> normals;
+	normals.reserve (vertexCount);
 	for (unsigned int i = 0; i < vertexCount; i++) {
 		glm::dvec3 normal = sidePoly.CalculateNormal (i);
 		if (isReversed) {
@@ -132,6 +133,7 @@ Mesh PolygonalGenerator::Generate () const
 	Mesh mesh;
 	MaterialId materialId = mesh.AddMaterial (material);
 	mesh.SetTransformation (transformation);
+	ReserveMesh (mesh);
 
 	if (!AddTopAndBottomVertices (mesh)) {
 		return EmptyMesh;
@@ -181,6 +183,12 @@ PrismGenerator::~PrismGenerator ()
 {
 }
 
+void PrismGenerator::ReserveMesh (Mesh& mesh) const
+{
+	// enough for both triangulated and center point triangulated top and bottom
+	mesh.Reserve (2 * vertexCount + 2, vertexCount + 2, 4 * vertexCount);
+}
+
 bool PrismGenerator::AddTopAndBottomVertices (Mesh& mesh) const
 {
 	AddPolygonalVerticesToMesh (mesh, basePolygon, 0.0);
@@ -330,9 +338,15 @@ PrismShellGenerator::~PrismShellGenerator ()
 {
 }
 
+void PrismShellGenerator::ReserveMesh (Mesh& mesh) const
+{
+	mesh.Reserve (4 * vertexCount, 2 * vertexCount + 2, 8 * vertexCount);
+}
+
 bool PrismShellGenerator::AddTopAndBottomVertices (Mesh& mesh) const
 {
 	std::vector<glm::dvec2> innerPolygon;
+	innerPolygon.reserve (basePolygon.size ());
 	for (size_t i = 0; i < basePolygon.size (); i++) {
 		const glm::dvec2& prev = basePolygon[i > 0 ? i - 1 : basePolygon.size () - 1];
 		const glm::dvec2& curr = basePolygon[i];
@@ -44,6 +44,7 @@ public:
 	Mesh						Generate () const;
 
 protected:
+	virtual void				ReserveMesh (Mesh& mesh) const = 0;
 	virtual bool				AddTopAndBottomVertices (Mesh& mesh) const = 0;
 	virtual bool				AddTopAndBottomTriangles (Mesh& mesh, MaterialId materialId) const = 0;
 	virtual bool				AddSideTriangles (Mesh& mesh, MaterialId materialId) const = 0;
@@ -67,6 +68,7 @@ public:
 	virtual ~PrismGenerator ();
 
 protected:
+	virtual void	ReserveMesh (Mesh& mesh) const override;
 	virtual bool	AddTopAndBottomVertices (Mesh& mesh) const override;
 	virtual bool	AddSideTriangles (Mesh& mesh, MaterialId materialId) const override;
 
@@ -103,6 +105,7 @@ public:
 	virtual ~PrismShellGenerator ();
 
 private:
+	virtual void	ReserveMesh (Mesh& mesh) const override;
 	virtual bool	AddTopAndBottomVertices (Mesh& mesh) const override;
 	virtual bool	AddTopAndBottomTriangles (Mesh& mesh, MaterialId materialId) const override;
 	virtual bool	AddSideTriangles (Mesh& mesh, MaterialId materialId) const override;
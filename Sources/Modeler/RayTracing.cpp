@@ -1,6 +1,8 @@
 #include "RayTracing.hpp"
 
 #include <algorithm>
+#include <limits>
+#include <array>
 
 namespace Modeler
 {
@@ -12,49 +14,253 @@ RayModelIntersection::RayModelIntersection (MeshId meshId, unsigned int triangle
 {
 }
 
-Geometry::Ray GetScreenRay (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos)
+RayModelIntersectionResult::RayModelIntersectionResult () :
+	found (false),
+	intersection (-1, 0, Geometry::RayIntersection ())
 {
-	double screenX = screenPos.x / (screenSize.x * 0.5) - 1.0;
-	double screenY = screenPos.y / (screenSize.y * 0.5) - 1.0;
+}
+
+RayModelIntersectionResult::RayModelIntersectionResult (const RayModelIntersection& intersection) :
+	found (true),
+	intersection (intersection)
+{
+}
+
+static bool IsCloserIntersection (const RayModelIntersection& a, const RayModelIntersection& b)
+{
+	if (a.intersection.distance != b.intersection.distance) {
+		return a.intersection.distance < b.intersection.distance;
+	}
+	if (a.meshId != b.meshId) {
+		return a.meshId < b.meshId;
+	}
+	return a.triangleIndex < b.triangleIndex;
+}
+
+// processor (intersection) for the intersections closer than maxDistance, which the processor
+// may decrease to skip the farther parts of the model, or make negative to stop
+template <typename ProcessorType>
+static void EnumerateRayModelIntersections (const Model& model, const Geometry::Ray& ray, double& maxDistance, ProcessorType processor)
+{
+	// with a normalized direction the distances along the tree rays are world distances, and
+	// the candidate triangles are tested in world space, so the results don't depend on the trees
+	glm::dvec3 rayDirection = glm::normalize (ray.GetDirection ());
+	Geometry::Ray worldRay (ray.GetOrigin (), rayDirection);
+	model.EnumerateRayMeshes (worldRay, maxDistance, [&] (MeshId meshId, const MeshRef& meshRef) {
+		if (!Geometry::HasRayBoundingBoxIntersection (ray, meshRef.GetBoundingBox ())) {
+			return;
+		}
 
+		const MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
+		const glm::dmat4& transformation = meshRef.GetTransformation ();
+		glm::dmat4 inverseTransformation = glm::inverse (transformation);
+		glm::dvec3 meshRayOrigin (inverseTransformation * glm::dvec4 (ray.GetOrigin (), 1.0));
+		glm::dvec3 meshRayDirection (inverseTransformation * glm::dvec4 (rayDirection, 0.0));
+		Geometry::Ray meshRay (meshRayOrigin, meshRayDirection);
+		model.GetMeshBVH (meshRef).EnumerateRayTriangles (meshRay, maxDistance, [&] (unsigned int triangleIndex) {
+			const MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
+			glm::dvec3 v1 = geometry.GetVertex (triangle.v1, transformation);
+			glm::dvec3 v2 = geometry.GetVertex (triangle.v2, transformation);
+			glm::dvec3 v3 = geometry.GetVertex (triangle.v3, transformation);
+			Geometry::RayIntersectionResult result = Geometry::GetRayTriangleIntersection (ray, v1, v2, v3);
+			if (result.found && result.intersection.distance <= maxDistance) {
+				processor (RayModelIntersection (meshId, triangleIndex, result.intersection));
+			}
+		});
+	});
+}
+
+class ScreenRayGenerator
+{
+public:
+	ScreenRayGenerator (const Camera& camera, const glm::dvec2& screenSize);
+
+	Geometry::Ray	GetRay (const glm::dvec2& screenPos) const;
+
+private:
+	glm::dvec2		screenSize;
+	glm::dvec3		eye;
+	glm::dmat4		invMatrix;
+};
+
+ScreenRayGenerator::ScreenRayGenerator (const Camera& camera, const glm::dvec2& screenSize) :
+	screenSize (screenSize),
+	eye (camera.GetEye ()),
+	invMatrix ()
+{
 	glm::dmat4 projMatrix = camera.GetProjectionMatrix (screenSize.x, screenSize.y);
 	glm::dmat4 viewMatrix = camera.GetViewMatrix ();
+	invMatrix = glm::inverse (projMatrix * viewMatrix);
+}
+
+Geometry::Ray ScreenRayGenerator::GetRay (const glm::dvec2& screenPos) const
+{
+	double screenX = screenPos.x / (screenSize.x * 0.5) - 1.0;
+	double screenY = screenPos.y / (screenSize.y * 0.5) - 1.0;
 
-	glm::dmat4 invMatrix = glm::inverse (projMatrix * viewMatrix);
 	glm::dvec4 screenPosition (screenX, -screenY, 1.0, 1.0);
 	glm::dvec4 worldPosition = invMatrix * screenPosition;
 
 	glm::dvec3 rayDirection = glm::normalize (glm::dvec3 (worldPosition));
-	return Geometry::Ray (camera.GetEye (), rayDirection);
+	return Geometry::Ray (eye, rayDirection);
+}
+
+Geometry::Ray GetScreenRay (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos)
+{
+	ScreenRayGenerator generator (camera, screenSize);
+	return generator.GetRay (screenPos);
+}
+
+std::vector<Geometry::Ray> GetScreenRayGrid (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& gridMin, const glm::dvec2& gridMax, unsigned int columns, unsigned int rows)
+{
+	std::vector<Geometry::Ray> rays;
+	rays.reserve (columns * rows);
+	ScreenRayGenerator generator (camera, screenSize);
+	glm::dvec2 cellSize = (gridMax - gridMin) / glm::dvec2 (columns, rows);
+	for (unsigned int row = 0; row < rows; row++) {
+		for (unsigned int column = 0; column < columns; column++) {
+			glm::dvec2 screenPos = gridMin + cellSize * glm::dvec2 (column + 0.5, row + 0.5);
+			rays.push_back (generator.GetRay (screenPos));
+		}
+	}
+	return rays;
 }
 
 std::vector<RayModelIntersection> GetRayModelRayIntersections (const Model& model, const Geometry::Ray& ray)
 {
 	std::vector<RayModelIntersection> intersections;
-	model.EnumerateMeshes ([&] (MeshId meshId, const MeshRef& meshRef) {
+	double maxDistance = std::numeric_limits<double>::max ();
+	EnumerateRayModelIntersections (model, ray, maxDistance, [&] (const RayModelIntersection& intersection) {
+		intersections.push_back (intersection);
+	});
+	// the meshes and the triangles are visited in tree order, so equal distances are ordered by id
+	std::sort (intersections.begin (), intersections.end (), IsCloserIntersection);
+	return intersections;
+}
+
+RayModelIntersectionResult GetRayModelFirstIntersection (const Model& model, const Geometry::Ray& ray)
+{
+	RayModelIntersectionResult result;
+	double maxDistance = std::numeric_limits<double>::max ();
+	EnumerateRayModelIntersections (model, ray, maxDistance, [&] (const RayModelIntersection& intersection) {
+		if (!result.found || IsCloserIntersection (intersection, result.intersection)) {
+			result = RayModelIntersectionResult (intersection);
+			maxDistance = intersection.intersection.distance;
+		}
+	});
+	return result;
+}
+
+bool HasRayModelIntersection (const Model& model, const Geometry::Ray& ray, double maxDistance)
+{
+	bool found = false;
+	EnumerateRayModelIntersections (model, ray, maxDistance, [&] (const RayModelIntersection&) {
+		found = true;
+		maxDistance = -1.0;
+	});
+	return found;
+}
+
+std::vector<RayModelIntersectionResult> GetRayModelFirstIntersections (const Model& model, const std::vector<Geometry::Ray>& rays)
+{
+	std::vector<RayModelIntersectionResult> results (rays.size ());
+	for (size_t firstRay = 0; firstRay < rays.size (); firstRay += RayPacketSize) {
+		RayPacket packet;
+		unsigned int rayCount = (unsigned int) std::min (rays.size () - firstRay, (size_t) RayPacketSize);
+		for (unsigned int i = 0; i < rayCount; i++) {
+			const Geometry::Ray& ray = rays[firstRay + i];
+			packet.AddRay (ray.GetOrigin (), glm::normalize (ray.GetDirection ()), std::numeric_limits<double>::max ());
+		}
+
+		// the distances along the mesh space rays are world distances, since the transformed
+		// directions are not normalized
+		model.EnumerateRayPacketMeshes (packet, [&] (MeshId meshId, const MeshRef& meshRef) {
+			const glm::dmat4& transformation = meshRef.GetTransformation ();
+			bool isMirrored = glm::determinant (glm::dmat3 (transformation)) < 0.0;
+			RayPacket meshPacket = packet.Transform (glm::inverse (transformation));
+			const MeshPacketTriangles& triangles = model.GetMeshPacketTriangles (meshRef);
+			model.GetMeshBVH (meshRef).EnumerateRayPacketLeaves (meshPacket, [&] (unsigned int firstPosition, unsigned int triangleCount) {
+				triangles.IntersectRayPacket (meshPacket, firstPosition, triangleCount, isMirrored, [&] (unsigned int rayIndex, unsigned int position, double distance) {
+					glm::dvec3 origin (packet.originX[rayIndex], packet.originY[rayIndex], packet.originZ[rayIndex]);
+					glm::dvec3 direction (packet.directionX[rayIndex], packet.directionY[rayIndex], packet.directionZ[rayIndex]);
+					Geometry::RayIntersection rayIntersection (origin + direction * distance, distance);
+					RayModelIntersection intersection (meshId, triangles.GetTriangleIndex (position), rayIntersection);
+					RayModelIntersectionResult& result = results[firstRay + rayIndex];
+					if (!result.found || IsCloserIntersection (intersection, result.intersection)) {
+						result = RayModelIntersectionResult (intersection);
+						packet.maxDistances[rayIndex] = distance;
+						meshPacket.maxDistances[rayIndex] = distance;
+					}
+				});
+			});
+		});
+	}
+	return results;
+}
+
+Geometry::Frustum GetScreenFrustum (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos1, const glm::dvec2& screenPos2)
+{
+	// a rectangle narrower than a pixel is extended to a pixel around its center
+	glm::dvec2 rectMin = glm::min (screenPos1, screenPos2);
+	glm::dvec2 rectMax = glm::max (screenPos1, screenPos2);
+	for (int i = 0; i < 2; i++) {
+		if (rectMax[i] - rectMin[i] < 1.0) {
+			double center = (rectMin[i] + rectMax[i]) * 0.5;
+			rectMin[i] = center - 0.5;
+			rectMax[i] = center + 0.5;
+		}
+	}
+
+	glm::dmat4 projMatrix = camera.GetProjectionMatrix (screenSize.x, screenSize.y);
+	glm::dmat4 viewMatrix = camera.GetViewMatrix ();
+	glm::dmat4 invMatrix = glm::inverse (projMatrix * viewMatrix);
+
+	const glm::dvec2 rectCorners[4] = {
+		glm::dvec2 (rectMin.x, rectMin.y),
+		glm::dvec2 (rectMax.x, rectMin.y),
+		glm::dvec2 (rectMax.x, rectMax.y),
+		glm::dvec2 (rectMin.x, rectMax.y)
+	};
+	std::array<glm::dvec3, 8> corners;
+	for (int i = 0; i < 4; i++) {
+		double screenX = rectCorners[i].x / (screenSize.x * 0.5) - 1.0;
+		double screenY = rectCorners[i].y / (screenSize.y * 0.5) - 1.0;
+		glm::dvec4 nearPosition = invMatrix * glm::dvec4 (screenX, -screenY, -1.0, 1.0);
+		glm::dvec4 farPosition = invMatrix * glm::dvec4 (screenX, -screenY, 1.0, 1.0);
+		corners[i] = glm::dvec3 (nearPosition) / nearPosition.w;
+		corners[i + 4] = glm::dvec3 (farPosition) / farPosition.w;
+	}
+	return Geometry::Frustum (corners);
+}
+
+std::vector<MeshId> GetFrustumModelMeshes (const Model& model, const Geometry::Frustum& frustum)
+{
+	std::vector<MeshId> meshIds;
+	model.EnumerateFrustumMeshes (frustum, [&] (MeshId meshId, const MeshRef& meshRef, bool isInside) {
 		const MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
-		const Geometry::BoundingBox& boundingBox = geometry.GetBoundingBox ();
-		const glm::dmat4& transformation = meshRef.GetTransformation ();
-		Geometry::BoundingBox transformedBoundingBox = boundingBox.Transform (transformation);
-		if (!Geometry::HasRayBoundingBoxIntersection (ray, transformedBoundingBox)) {
+		if (geometry.TriangleCount () == 0) {
+			return;
+		}
+		if (isInside) {
+			meshIds.push_back (meshId);
 			return;
 		}
 
-		for (unsigned int triangleIndex = 0; triangleIndex < geometry.TriangleCount (); triangleIndex++) {
+		// the frustum is transformed into the space of the geometry, so the tree of the
+		// geometry can be used, and the vertices don't have to be transformed
+		Geometry::Frustum meshFrustum = frustum.Transform (glm::inverse (meshRef.GetTransformation ()));
+		bool found = false;
+		model.GetMeshBVH (meshRef).EnumerateFrustumTriangles (meshFrustum, [&] (unsigned int triangleIndex, bool isLeafInside) {
 			const MeshTriangle& triangle = geometry.GetTriangle (triangleIndex);
-			glm::dvec3 v1 = geometry.GetVertex (triangle.v1, transformation);
-			glm::dvec3 v2 = geometry.GetVertex (triangle.v2, transformation);
-			glm::dvec3 v3 = geometry.GetVertex (triangle.v3, transformation);
-			Geometry::RayIntersectionResult result = Geometry::GetRayTriangleIntersection (ray, v1, v2, v3);
-			if (result.found) {
-				intersections.push_back (RayModelIntersection (meshId, triangleIndex, result.intersection));
-			}
+			found = isLeafInside || meshFrustum.HasTriangleIntersection (geometry.GetVertex (triangle.v1), geometry.GetVertex (triangle.v2), geometry.GetVertex (triangle.v3));
+			return !found;
+		});
+		if (found) {
+			meshIds.push_back (meshId);
 		}
 	});
-	std::sort (intersections.begin (), intersections.end (), [] (const RayModelIntersection& a, const RayModelIntersection& b) {
-		return a.intersection.distance < b.intersection.distance;
-	});
-	return intersections;
+	std::sort (meshIds.begin (), meshIds.end ());
+	return meshIds;
 }
 
 }
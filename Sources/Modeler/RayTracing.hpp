@@ -4,6 +4,7 @@
 #include "IncludeGLM.hpp"
 #include "Ray.hpp"
 #include "RayIntersection.hpp"
+#include "Frustum.hpp"
 #include "Camera.hpp"
 #include "Model.hpp"
 
@@ -20,8 +21,24 @@ public:
 	Geometry::RayIntersection	intersection;
 };
 
-Geometry::Ray						GetScreenRay (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos);
-std::vector<RayModelIntersection>	GetRayModelRayIntersections (const Model& model, const Geometry::Ray& ray);
+class RayModelIntersectionResult
+{
+public:
+	RayModelIntersectionResult ();
+	RayModelIntersectionResult (const RayModelIntersection& intersection);
+
+	bool					found;
+	RayModelIntersection	intersection;
+};
+
+Geometry::Ray								GetScreenRay (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos);
+std::vector<Geometry::Ray>					GetScreenRayGrid (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& gridMin, const glm::dvec2& gridMax, unsigned int columns, unsigned int rows);
+std::vector<RayModelIntersection>			GetRayModelRayIntersections (const Model& model, const Geometry::Ray& ray);
+RayModelIntersectionResult					GetRayModelFirstIntersection (const Model& model, const Geometry::Ray& ray);
+bool										HasRayModelIntersection (const Model& model, const Geometry::Ray& ray, double maxDistance);
+std::vector<RayModelIntersectionResult>		GetRayModelFirstIntersections (const Model& model, const std::vector<Geometry::Ray>& rays);
+Geometry::Frustum							GetScreenFrustum (const Camera& camera, const glm::dvec2& screenSize, const glm::dvec2& screenPos1, const glm::dvec2& screenPos2);
+std::vector<MeshId>							GetFrustumModelMeshes (const Model& model, const Geometry::Frustum& frustum);
 
 }
 
@@ -2,76 +2,159 @@
 #define MODELER_SHAREDDATA_HPP
 
 #include "Checksum.hpp"
+#include "SlotMap.hpp"
 
 #include <unordered_map>
+#include <list>
+#include <utility>
 
 namespace Modeler
 {
 
+// Data that is no longer referenced is kept in a bounded pool of released
+// entries, so adding back identical data (e.g. on reevaluation) resurrects
+// it with the same id instead of storing it again. The least recently
+// released entries are dropped first.
+
 template <typename IdType, typename DataType>
 class SharedData
 {
 public:
+	static const size_t DefaultMaxReleasedCount = 256;
+	static const size_t DefaultMaxReleasedSize = 256 * 1024 * 1024;
+
 	SharedData () :
-		nextDataId (0)
+		SharedData (DefaultMaxReleasedCount, DefaultMaxReleasedSize)
+	{
+
+	}
+
+	SharedData (size_t maxReleasedCount, size_t maxReleasedSize) :
+		maxReleasedCount (maxReleasedCount),
+		maxReleasedSize (maxReleasedSize),
+		releasedSize (0)
 	{
 
 	}
 
 	const DataType& GetData (IdType id) const
 	{
-		return idToData.at (id);
+		return entries.Get (id).data;
 	}
 
 	size_t DataCount () const
 	{
-		return idToData.size ();
+		return entries.Count () - releasedIds.size ();
+	}
+
+	size_t ReleasedDataCount () const
+	{
+		return releasedIds.size ();
 	}
 
 	IdType AddReference (const DataType& data, const Checksum& checksum)
 	{
-		IdType id = -1;
-		auto foundData = checkSumToId.find (checksum);
-		if (foundData == checkSumToId.end ()) {
-			id = nextDataId++;
-			idToData.insert ({ id, data });
-			dataRefCount.insert ({ id, 1 });
-			checkSumToId.insert ({ checksum, id });
-			idToChecksum.insert ({ id, checksum });
-		} else {
-			id = foundData->second;
-			dataRefCount[id] += 1;
-		}
-		return id;
+		return AddReferenceInternal (data, checksum);
+	}
+
+	IdType AddReference (DataType&& data, const Checksum& checksum)
+	{
+		return AddReferenceInternal (std::move (data), checksum);
 	}
 
 	void RemoveReference (IdType id)
 	{
-		dataRefCount[id] -= 1;
-		if (dataRefCount[id] == 0) {
-			idToData.erase (id);
-			dataRefCount.erase (id);
-			checkSumToId.erase (idToChecksum.at (id));
-			idToChecksum.erase (id);
+		RemoveReference (id, [] (IdType) {});
+	}
+
+	// the processor is called with the ids of the released data dropped from the pool
+	template <typename ProcessorType>
+	void RemoveReference (IdType id, ProcessorType erasedProcessor)
+	{
+		Entry& entry = entries.Get (id);
+		entry.refCount -= 1;
+		if (entry.refCount == 0) {
+			entry.memorySize = entry.data.CalcMemorySize ();
+			entry.releasedPosition = releasedIds.insert (releasedIds.begin (), id);
+			releasedSize += entry.memorySize;
+			while (!releasedIds.empty () && (releasedIds.size () > maxReleasedCount || releasedSize > maxReleasedSize)) {
+				IdType erasedId = releasedIds.back ();
+				EraseReleasedData (erasedId);
+				erasedProcessor (erasedId);
+			}
 		}
 	}
 
 	void Clear ()
 	{
-		idToData.clear ();
-		dataRefCount.clear ();
+		entries.Clear ();
 		checkSumToId.clear ();
-		idToChecksum.clear ();
-		nextDataId = 0;
+		releasedIds.clear ();
+		releasedSize = 0;
 	}
 
 private:
-	std::unordered_map<IdType, DataType>	idToData;
-	std::unordered_map<IdType, int>			dataRefCount;
-	std::unordered_map<Checksum, IdType>	checkSumToId;
-	std::unordered_map<IdType, Checksum>	idToChecksum;
+	class Entry
+	{
+	public:
+		DataType							data;
+		int									refCount;
+		Checksum							checksum;
+		size_t								memorySize;
+		typename std::list<IdType>::iterator	releasedPosition;
+	};
+
+	template <typename DataRefType>
+	IdType AddReferenceInternal (DataRefType&& data, const Checksum& checksum)
+	{
+		IdType id = FindData (data, checksum);
+		if (id == -1) {
+			id = entries.Insert (Entry { std::forward<DataRefType> (data), 1, checksum, 0, releasedIds.end () });
+			checkSumToId.insert ({ checksum, id });
+		} else {
+			Entry& entry = entries.Get (id);
+			if (entry.refCount == 0) {
+				releasedIds.erase (entry.releasedPosition);
+				releasedSize -= entry.memorySize;
+			}
+			entry.refCount += 1;
+		}
+		return id;
+	}
+
+	void EraseReleasedData (IdType id)
+	{
+		Entry& entry = entries.Get (id);
+		auto foundIds = checkSumToId.equal_range (entry.checksum);
+		for (auto it = foundIds.first; it != foundIds.second; ++it) {
+			if (it->second == id) {
+				checkSumToId.erase (it);
+				break;
+			}
+		}
+		releasedIds.erase (entry.releasedPosition);
+		releasedSize -= entry.memorySize;
+		entries.Erase (id);
+	}
+
+	IdType FindData (const DataType& data, const Checksum& checksum) const
+	{
+		auto foundIds = checkSumToId.equal_range (checksum);
+		for (auto it = foundIds.first; it != foundIds.second; ++it) {
+			if (entries.Get (it->second).data == data) {
+				return it->second;
+			}
+		}
+		return -1;
+	}
+
+	SlotMap<IdType, Entry>						entries;
+	std::unordered_multimap<Checksum, IdType>	checkSumToId;
 
-	IdType									nextDataId;
+	std::list<IdType>							releasedIds;
+	size_t										maxReleasedCount;
+	size_t										maxReleasedSize;
+	size_t										releasedSize;
 };
 
 }
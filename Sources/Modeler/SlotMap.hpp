@@ -0,0 +1,197 @@
+#ifndef MODELER_SLOTMAP_HPP
+#define MODELER_SLOTMAP_HPP
+
+#include <vector>
+#include <stdexcept>
+#include <utility>
+
+namespace Modeler
+{
+
+// Values are stored in a dense array, so enumeration is a linear scan. Ids
+// contain a slot index and a generation counter, so an id of a removed value
+// is never valid again, even if its slot is reused. Enumeration order is
+// insertion order until the first removal.
+
+template <typename IdType, typename ValueType>
+class SlotMap
+{
+public:
+	SlotMap ();
+
+	size_t				Count () const;
+	bool				Contains (IdType id) const;
+
+	const ValueType&	Get (IdType id) const;
+	ValueType&			Get (IdType id);
+
+	IdType				Insert (const ValueType& value);
+	IdType				Insert (ValueType&& value);
+	void				Erase (IdType id);
+	void				Clear ();
+
+	template <typename ProcessorType>
+	void				Enumerate (ProcessorType processor) const;
+
+private:
+	static const unsigned int IndexBits = 22;
+	static const unsigned int IndexMask = (1u << IndexBits) - 1;
+	static const unsigned int MaxGeneration = (1u << (31 - IndexBits)) - 1;
+	static const unsigned int InvalidIndex = (unsigned int) -1;
+
+	class Slot
+	{
+	public:
+		unsigned int	generation;
+		unsigned int	position;
+	};
+
+	template <typename ValueRefType>
+	IdType				InsertInternal (ValueRefType&& value);
+	unsigned int		GetSlotIndex (IdType id) const;
+
+	std::vector<ValueType>		values;
+	std::vector<unsigned int>	valueSlots;
+	std::vector<Slot>			slots;
+	unsigned int				firstFreeSlot;
+	unsigned int				lastFreeSlot;
+};
+
+template <typename IdType, typename ValueType>
+SlotMap<IdType, ValueType>::SlotMap () :
+	values (),
+	valueSlots (),
+	slots (),
+	firstFreeSlot (InvalidIndex),
+	lastFreeSlot (InvalidIndex)
+{
+	static_assert (sizeof (IdType) == 4, "");
+}
+
+template <typename IdType, typename ValueType>
+size_t SlotMap<IdType, ValueType>::Count () const
+{
+	return values.size ();
+}
+
+template <typename IdType, typename ValueType>
+bool SlotMap<IdType, ValueType>::Contains (IdType id) const
+{
+	if (id < 0) {
+		return false;
+	}
+	unsigned int slotIndex = (unsigned int) id & IndexMask;
+	unsigned int generation = (unsigned int) id >> IndexBits;
+	return slotIndex < slots.size () && slots[slotIndex].generation == generation;
+}
+
+template <typename IdType, typename ValueType>
+const ValueType& SlotMap<IdType, ValueType>::Get (IdType id) const
+{
+	return values[slots[GetSlotIndex (id)].position];
+}
+
+template <typename IdType, typename ValueType>
+ValueType& SlotMap<IdType, ValueType>::Get (IdType id)
+{
+	return values[slots[GetSlotIndex (id)].position];
+}
+
+template <typename IdType, typename ValueType>
+IdType SlotMap<IdType, ValueType>::Insert (const ValueType& value)
+{
+	return InsertInternal (value);
+}
+
+template <typename IdType, typename ValueType>
+IdType SlotMap<IdType, ValueType>::Insert (ValueType&& value)
+{
+	return InsertInternal (std::move (value));
+}
+
+template <typename IdType, typename ValueType>
+void SlotMap<IdType, ValueType>::Erase (IdType id)
+{
+	unsigned int slotIndex = GetSlotIndex (id);
+	Slot& slot = slots[slotIndex];
+
+	unsigned int lastPosition = (unsigned int) values.size () - 1;
+	if (slot.position != lastPosition) {
+		values[slot.position] = std::move (values[lastPosition]);
+		valueSlots[slot.position] = valueSlots[lastPosition];
+		slots[valueSlots[slot.position]].position = slot.position;
+	}
+	values.pop_back ();
+	valueSlots.pop_back ();
+
+	slot.generation += 1;
+	slot.position = InvalidIndex;
+	if (slot.generation > MaxGeneration) {
+		return;
+	}
+	if (lastFreeSlot == InvalidIndex) {
+		firstFreeSlot = slotIndex;
+	} else {
+		slots[lastFreeSlot].position = slotIndex;
+	}
+	lastFreeSlot = slotIndex;
+}
+
+template <typename IdType, typename ValueType>
+void SlotMap<IdType, ValueType>::Clear ()
+{
+	values.clear ();
+	valueSlots.clear ();
+	slots.clear ();
+	firstFreeSlot = InvalidIndex;
+	lastFreeSlot = InvalidIndex;
+}
+
+template <typename IdType, typename ValueType>
+template <typename ProcessorType>
+void SlotMap<IdType, ValueType>::Enumerate (ProcessorType processor) const
+{
+	for (size_t i = 0; i < values.size (); i++) {
+		unsigned int slotIndex = valueSlots[i];
+		processor ((IdType) ((slots[slotIndex].generation << IndexBits) | slotIndex), values[i]);
+	}
+}
+
+template <typename IdType, typename ValueType>
+template <typename ValueRefType>
+IdType SlotMap<IdType, ValueType>::InsertInternal (ValueRefType&& value)
+{
+	unsigned int slotIndex = InvalidIndex;
+	if (firstFreeSlot != InvalidIndex) {
+		slotIndex = firstFreeSlot;
+		firstFreeSlot = slots[slotIndex].position;
+		if (firstFreeSlot == InvalidIndex) {
+			lastFreeSlot = InvalidIndex;
+		}
+	} else {
+		if (slots.size () > IndexMask) {
+			throw std::logic_error ("slot map is full");
+		}
+		slotIndex = (unsigned int) slots.size ();
+		slots.push_back ({ 0, InvalidIndex });
+	}
+
+	Slot& slot = slots[slotIndex];
+	slot.position = (unsigned int) values.size ();
+	values.push_back (std::forward<ValueRefType> (value));
+	valueSlots.push_back (slotIndex);
+	return (IdType) ((slot.generation << IndexBits) | slotIndex);
+}
+
+template <typename IdType, typename ValueType>
+unsigned int SlotMap<IdType, ValueType>::GetSlotIndex (IdType id) const
+{
+	if (!Contains (id)) {
+		throw std::out_of_range ("invalid slot map id");
+	}
+	return (unsigned int) id & IndexMask;
+}
+
+}
+
+#endif
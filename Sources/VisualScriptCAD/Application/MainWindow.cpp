@@ -8,10 +8,10 @@
 #include "InfoDialog.hpp"
 #include "ExportDialog.hpp"
 #include "CameraDialog.hpp"
+#include "TessellationDialog.hpp"
 #include "IconStore.hpp"
 #include "Version.hpp"
 #include "VersionInfo.hpp"
-#include "ApplicationHeaderIO.hpp"
 #include "XMLUtilities.hpp"
 
 #include "VisualScriptLogicMain.hpp"
@@ -105,7 +105,8 @@ void EditorModelBridge::UpdateModel ()
 }
 
 ApplicationState::ApplicationState () :
-	currentFileName ()
+	currentFileName (),
+	savedTessellationTolerance ()
 {
 
 }
@@ -130,6 +131,16 @@ const std::wstring& ApplicationState::GetCurrentFileName () const
 	return currentFileName;
 }
 
+void ApplicationState::SetSavedTessellationTolerance (const Modeler::TessellationTolerance& newSavedTolerance)
+{
+	savedTessellationTolerance = newSavedTolerance;
+}
+
+const Modeler::TessellationTolerance& ApplicationState::GetSavedTessellationTolerance () const
+{
+	return savedTessellationTolerance;
+}
+
 MenuBar::MenuBar () :
 	wxMenuBar ()
 {
@@ -162,6 +173,7 @@ MenuBar::MenuBar () :
 
 	wxMenu* modelMenu = new wxMenu ();
 	modelMenu->Append (CommandId::Model_Info, "Information...");
+	modelMenu->Append (CommandId::Model_Tessellation, "Tessellation...");
 	modelMenu->Append (CommandId::Model_Export, "Export...");
 	Append (modelMenu, L"&Model");
 
@@ -255,6 +267,7 @@ wxToolBarToolBase* ToolBar::AddRadioButton (int toolId, const void* imageData, s
 MainWindow::MainWindow (const std::wstring& defaultFileName) :
 	wxFrame (NULL, wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize (1000, 600)),
 	evaluationData (new ModelEvaluationData ()),
+	headerIO (evaluationData),
 	menuBar (new MenuBar ()),
 	toolBar (new ToolBar (this)),
 	editorAndModelSplitter (new wxSplitterWindow (this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSP_THIN_SASH | wxSP_LIVE_UPDATE)),
@@ -316,7 +329,6 @@ void MainWindow::OnClose (wxCloseEvent&)
 
 void MainWindow::ProcessCommand (CommandId commandId)
 {
-	WXAS::wxFileIO fileIO;
 	WXAS::NodeEditorControl* editor = nodeEditorControl->GetEditor ();
 	switch (commandId) {
 		case File_New:
@@ -343,12 +355,10 @@ void MainWindow::ProcessCommand (CommandId commandId)
 			{
 				wxFileDialog fileDialog (this, L"Save", L"", L"", L"VisualScriptCAD files (*.vsc)|*.vsc", wxFD_SAVE);
 				if (applicationState.HasCurrentFileName ()) {
-					editor->Save (applicationState.GetCurrentFileName (), &fileIO, &appHeaderIO);
+					SaveFile (applicationState.GetCurrentFileName ());
 				} else if (fileDialog.ShowModal () == wxID_OK) {
 					std::wstring fileName = fileDialog.GetPath ().ToStdWstring ();
-					editor->Save (fileName, &fileIO, &appHeaderIO);
-					applicationState.SetCurrentFileName (fileName);
-					userSettings.AddRecentFile (fileName);
+					SaveFile (fileName);
 				}
 			}
 			break;
@@ -357,9 +367,7 @@ void MainWindow::ProcessCommand (CommandId commandId)
 				wxFileDialog fileDialog (this, L"Save As", L"", L"", L"VisualScriptCAD files (*.vsc)|*.vsc", wxFD_SAVE);
 				if (fileDialog.ShowModal () == wxID_OK) {
 					std::wstring fileName = fileDialog.GetPath ().ToStdWstring ();
-					editor->Save (fileName, &fileIO, &appHeaderIO);
-					applicationState.SetCurrentFileName (fileName);
-					userSettings.AddRecentFile (fileName);
+					SaveFile (fileName);
 				}
 			}
 			break;
@@ -470,6 +478,18 @@ void MainWindow::ProcessCommand (CommandId commandId)
 				modelInfoDialog.ShowModal ();
 			}
 			break;
+		case Model_Tessellation:
+			{
+				TessellationDialog tessellationDialog (this, evaluationData->GetTessellationTolerance ());
+				if (tessellationDialog.ShowModal () == wxID_OK) {
+					Modeler::TessellationTolerance tolerance = tessellationDialog.GetTessellationTolerance ();
+					if (tolerance != evaluationData->GetTessellationTolerance ()) {
+						evaluationData->SetTessellationTolerance (tolerance);
+						nodeEditorControl->InvalidateNodes (evaluationData->GetMeshNodes ());
+					}
+				}
+			}
+			break;
 		case Model_Export:
 			{
 				const Modeler::Model& model = evaluationData->GetModel ();
@@ -532,7 +552,8 @@ void MainWindow::OnKeyDown (wxKeyEvent& evt)
 bool MainWindow::ConfirmLosingUnsavedChanges ()
 {
 	WXAS::NodeEditorControl* editor = nodeEditorControl->GetEditor ();
-	if (editor->NeedToSave ()) {
+	bool toleranceChanged = evaluationData->GetTessellationTolerance () != applicationState.GetSavedTessellationTolerance ();
+	if (editor->NeedToSave () || toleranceChanged) {
 		wxMessageDialog confirmationDialog (this, L"You have made some unsaved changes.\nAre you sure you want to continue?", L"Unsaved changes", wxYES_NO);
 		int result = confirmationDialog.ShowModal ();
 		if (result != wxID_YES) {
@@ -572,7 +593,9 @@ void MainWindow::NewFile ()
 	nodeEditorControl->Clear ();
 	modelControl->Clear ();
 	evaluationData->Clear ();
+	evaluationData->SetTessellationTolerance (Modeler::TessellationTolerance ());
 	applicationState.ClearCurrentFileName ();
+	applicationState.SetSavedTessellationTolerance (evaluationData->GetTessellationTolerance ());
 }
 
 void MainWindow::OpenFile (const std::wstring& fileName)
@@ -583,11 +606,12 @@ void MainWindow::OpenFile (const std::wstring& fileName)
 	bool success = false;
 	try {
 		WXAS::BusyCursorGuard busyCursor;
-		success = editor->Open (fileName, &fileIO, &appHeaderIO);
+		success = editor->Open (fileName, &fileIO, &headerIO);
 	} catch (...) {
 	}
 	if (success) {
 		applicationState.SetCurrentFileName (fileName);
+		applicationState.SetSavedTessellationTolerance (evaluationData->GetTessellationTolerance ());
 		userSettings.AddRecentFile (fileName);
 		editor->AlignToWindow ();
 		modelControl->FitToWindow ();
@@ -599,6 +623,17 @@ void MainWindow::OpenFile (const std::wstring& fileName)
 	}
 }
 
+void MainWindow::SaveFile (const std::wstring& fileName)
+{
+	WXAS::wxFileIO fileIO;
+	WXAS::NodeEditorControl* editor = nodeEditorControl->GetEditor ();
+	if (editor->Save (fileName, &fileIO, &headerIO)) {
+		applicationState.SetCurrentFileName (fileName);
+		applicationState.SetSavedTessellationTolerance (evaluationData->GetTessellationTolerance ());
+		userSettings.AddRecentFile (fileName);
+	}
+}
+
 BEGIN_EVENT_TABLE (MainWindow, wxFrame)
 EVT_MENU (wxID_ANY, MainWindow::OnCommand)
 EVT_CLOSE (MainWindow::OnClose)
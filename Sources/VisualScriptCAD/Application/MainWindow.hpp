@@ -2,6 +2,7 @@
 #define MAINWINDOW_HPP
 
 #include "ModelEvaluationData.hpp"
+#include "ApplicationHeaderIO.hpp"
 #include "NodeEditorControl.hpp"
 #include "ModelControl.hpp"
 
@@ -33,6 +34,7 @@ enum CommandId
 	Tool_Mode_Automatic			= 21,
 	Tool_Mode_Manual			= 22,
 	Tool_Mode_Update			= 23,
+	Model_Tessellation			= 24,
 	File_OpenRecent_First		= 100
 };
 
@@ -94,8 +96,12 @@ public:
 	bool					HasCurrentFileName () const;
 	const std::wstring&		GetCurrentFileName () const;
 
+	void									SetSavedTessellationTolerance (const Modeler::TessellationTolerance& newSavedTolerance);
+	const Modeler::TessellationTolerance&	GetSavedTessellationTolerance () const;
+
 private:
-	std::wstring currentFileName;
+	std::wstring						currentFileName;
+	Modeler::TessellationTolerance		savedTessellationTolerance;
 };
 
 class MainWindow : public wxFrame
@@ -117,8 +123,10 @@ private:
 
 	void	NewFile ();
 	void	OpenFile (const std::wstring& fileName);
+	void	SaveFile (const std::wstring& fileName);
 
 	std::shared_ptr<ModelEvaluationData>	evaluationData;
+	ApplicationHeaderIO						headerIO;
 	MenuBar*								menuBar;
 	ToolBar*								toolBar;
 	wxSplitterWindow*						editorAndModelSplitter;
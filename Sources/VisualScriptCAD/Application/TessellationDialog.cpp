@@ -0,0 +1,53 @@
+#include "TessellationDialog.hpp"
+
+static const wxSize nameMinSize (150, -1);
+static const wxSize controlMinSize (100, -1);
+
+TessellationDialog::TessellationDialog (wxWindow* parent, const Modeler::TessellationTolerance& tolerance) :
+	wxDialog (parent, wxID_ANY, L"Tessellation Settings", wxDefaultPosition, wxDefaultSize, wxDEFAULT_DIALOG_STYLE),
+	saveButton (new wxButton (this, DialogIds::SaveButtonId, L"Save")),
+	boxSizer (new wxBoxSizer (wxVERTICAL)),
+	chordalDeviationSpin (new wxSpinCtrlDouble (this, DialogIds::ChordalDeviationSpinId, L"", wxDefaultPosition, controlMinSize, wxSP_ARROW_KEYS, 0.0001, 1000.0, 0.0, 0.001)),
+	maxSegmentAngleSpin (new wxSpinCtrlDouble (this, DialogIds::MaxSegmentAngleSpinId, L"", wxDefaultPosition, controlMinSize, wxSP_ARROW_KEYS, 0.1, 90.0, 0.0, 1.0))
+{
+	{
+		wxBoxSizer* horizontalSizer = new wxBoxSizer (wxHORIZONTAL);
+		horizontalSizer->Add (new wxStaticText (this, wxID_ANY, L"Chordal Deviation", wxDefaultPosition, nameMinSize), 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+		horizontalSizer->Add (chordalDeviationSpin, 1, wxEXPAND | wxALL, 5);
+		boxSizer->Add (horizontalSizer, 0, wxEXPAND);
+	}
+
+	{
+		wxBoxSizer* horizontalSizer = new wxBoxSizer (wxHORIZONTAL);
+		horizontalSizer->Add (new wxStaticText (this, wxID_ANY, L"Max Segment Angle", wxDefaultPosition, nameMinSize), 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+		horizontalSizer->Add (maxSegmentAngleSpin, 1, wxEXPAND | wxALL, 5);
+		boxSizer->Add (horizontalSizer, 0, wxEXPAND);
+	}
+
+	chordalDeviationSpin->SetDigits (4);
+	chordalDeviationSpin->SetValue (tolerance.GetChordalDeviation ());
+	maxSegmentAngleSpin->SetDigits (1);
+	maxSegmentAngleSpin->SetValue (glm::degrees (tolerance.GetMaxSegmentAngle ()));
+
+	boxSizer->Add (saveButton, 0, wxEXPAND | wxDOWN | wxRIGHT | wxLEFT, 5);
+	SetSizerAndFit (boxSizer);
+	SetEscapeId (wxID_CANCEL);
+}
+
+Modeler::TessellationTolerance TessellationDialog::GetTessellationTolerance () const
+{
+	return Modeler::TessellationTolerance (chordalDeviationSpin->GetValue (), glm::radians (maxSegmentAngleSpin->GetValue ()));
+}
+
+void TessellationDialog::OnButtonClick (wxCommandEvent& evt)
+{
+	if (evt.GetId () == DialogIds::SaveButtonId) {
+		if (GetTessellationTolerance ().Check ()) {
+			EndModal (wxID_OK);
+		}
+	}
+}
+
+BEGIN_EVENT_TABLE (TessellationDialog, wxDialog)
+EVT_BUTTON (wxID_ANY, TessellationDialog::OnButtonClick)
+END_EVENT_TABLE ()
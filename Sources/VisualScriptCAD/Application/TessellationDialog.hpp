@@ -0,0 +1,34 @@
+#ifndef TESSELLATIONDIALOG_HPP
+#define TESSELLATIONDIALOG_HPP
+
+#include "MeshGenerators.hpp"
+
+#include <wx/wx.h>
+#include <wx/spinctrl.h>
+
+class TessellationDialog : public wxDialog
+{
+public:
+	enum DialogIds
+	{
+		ChordalDeviationSpinId = 1001,
+		MaxSegmentAngleSpinId = 1002,
+		SaveButtonId = 1100
+	};
+
+	TessellationDialog (wxWindow* parent, const Modeler::TessellationTolerance& tolerance);
+
+	Modeler::TessellationTolerance	GetTessellationTolerance () const;
+
+private:
+	void							OnButtonClick (wxCommandEvent& evt);
+
+	wxButton*						saveButton;
+	wxBoxSizer*						boxSizer;
+	wxSpinCtrlDouble*				chordalDeviationSpin;
+	wxSpinCtrlDouble*				maxSegmentAngleSpin;
+
+	DECLARE_EVENT_TABLE ();
+};
+
+#endif
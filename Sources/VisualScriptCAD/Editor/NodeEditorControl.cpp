@@ -122,6 +122,11 @@ void NodeEditorControl::Clear ()
 	nodeEditorControl->New ();
 }
 
+void NodeEditorControl::InvalidateNodes (const NE::NodeCollection& nodes)
+{
+	nodeEditorControl->InvalidateNodes (nodes);
+}
+
 void NodeEditorControl::OnKeyDown (wxKeyEvent& evt)
 {
 	nodeEditorControl->OnKeyDown (evt);
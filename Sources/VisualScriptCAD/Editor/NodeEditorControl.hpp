@@ -31,6 +31,7 @@ public:
 
 	WXAS::NodeEditorControl*	GetEditor ();
 	void						Clear ();
+	void						InvalidateNodes (const NE::NodeCollection& nodes);
 
 	void						OnKeyDown (wxKeyEvent& evt);
 
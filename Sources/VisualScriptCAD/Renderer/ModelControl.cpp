@@ -19,6 +19,17 @@ static const int canvasAttributes[] = {
 	0
 };
 
+static const NE::NodeId& GetMeshNodeId (const Modeler::Model& model, Modeler::MeshId meshId)
+{
+	const Modeler::MeshRef& meshRef = model.GetMesh (meshId);
+	Modeler::UserDataConstPtr userData = meshRef.GetUserData ("nodeid");
+	if (userData == nullptr) {
+		throw std::logic_error ("no user data in mesh");
+	}
+	std::shared_ptr<const NodeIdUserData> nodeIdUserData = std::dynamic_pointer_cast<const NodeIdUserData> (userData);
+	return nodeIdUserData->GetNodeId ();
+}
+
 SelectionUpdater::~SelectionUpdater ()
 {
 
@@ -35,7 +46,8 @@ ModelControl::ModelControl (wxWindow *parent, const Modeler::Model& model, Selec
 	mouseDownPosition (0, 0),
 	lastMousePosition (0, 0),
 	lastMouseButton (-1),
-	isMouseDown (false)
+	isMouseDown (false),
+	isSelecting (false)
 {
 	if (!InitContext ()) {
 		throw std::logic_error ("failed to init context");
@@ -108,11 +120,18 @@ void ModelControl::OnMouseDown (wxMouseEvent& evt)
 	lastMousePosition = evt.GetPosition ();
 	lastMouseButton = evt.GetButton ();
 	isMouseDown = true;
+	isSelecting = (lastMouseButton == 1 && wxGetKeyState (wxKeyCode::WXK_CONTROL));
 }
 
 void ModelControl::OnMouseMove (wxMouseEvent& evt)
 {
-	if (isMouseDown) {
+	if (isMouseDown && isSelecting) {
+		// the selection follows the rectangle while dragging instead of rotating the view
+		if (evt.GetPosition () != lastMousePosition) {
+			SelectNodesOfMeshes (mouseDownPosition, evt.GetPosition ());
+			lastMousePosition = evt.GetPosition ();
+		}
+	} else if (isMouseDown) {
 		wxPoint diff = evt.GetPosition () - lastMousePosition;
 		RenderScene::MouseButton mouseButton = RenderScene::MouseButton::Undefined;
 		switch (lastMouseButton) {
@@ -142,6 +161,7 @@ void ModelControl::OnMouseUp (wxMouseEvent& evt)
 
 	ReleaseMouse ();
 	isMouseDown = false;
+	isSelecting = false;
 }
 
 void ModelControl::OnMouseWheel (wxMouseEvent& evt)
@@ -201,16 +221,29 @@ void ModelControl::SelectNodeOfMesh (const wxPoint& mousePosition)
 	Geometry::Ray ray = Modeler::GetScreenRay (renderScene.GetCamera (), screenSize, screenPos);
 	
 	NE::NodeCollection nodesToSelect;
-	std::vector<Modeler::RayModelIntersection> intersections = Modeler::GetRayModelRayIntersections (model, ray);
-	if (!intersections.empty ()) {
-		const Modeler::RayModelIntersection& firstIntersection = intersections.front ();
-		const Modeler::MeshRef& meshRef = model.GetMesh (firstIntersection.meshId);
-		Modeler::UserDataConstPtr userData = meshRef.GetUserData ("nodeid");
-		if (userData == nullptr) {
-			throw std::logic_error ("no user data in mesh");
+	Modeler::RayModelIntersectionResult firstIntersection = Modeler::GetRayModelFirstIntersection (model, ray);
+	if (firstIntersection.found) {
+		nodesToSelect.Insert (GetMeshNodeId (model, firstIntersection.intersection.meshId));
+	}
+
+	selectionUpdater.UpdateSelection (nodesToSelect);
+}
+
+void ModelControl::SelectNodesOfMeshes (const wxPoint& rectCorner1, const wxPoint& rectCorner2)
+{
+	wxSize clientSize = GetClientSize ();
+	glm::dvec2 screenSize (clientSize.x, clientSize.y);
+	glm::dvec2 screenPos1 (rectCorner1.x + 0.5, rectCorner1.y + 0.5);
+	glm::dvec2 screenPos2 (rectCorner2.x + 0.5, rectCorner2.y + 0.5);
+	Geometry::Frustum frustum = Modeler::GetScreenFrustum (renderScene.GetCamera (), screenSize, screenPos1, screenPos2);
+
+	NE::NodeCollection nodesToSelect;
+	std::vector<Modeler::MeshId> meshIds = Modeler::GetFrustumModelMeshes (model, frustum);
+	for (Modeler::MeshId meshId : meshIds) {
+		const NE::NodeId& nodeId = GetMeshNodeId (model, meshId);
+		if (!nodesToSelect.Contains (nodeId)) {
+			nodesToSelect.Insert (nodeId);
 		}
-		std::shared_ptr<const NodeIdUserData> nodeIdUserData = std::dynamic_pointer_cast<const NodeIdUserData> (userData);
-		nodesToSelect.Insert (nodeIdUserData->GetNodeId ());
 	}
 
 	selectionUpdater.UpdateSelection (nodesToSelect);
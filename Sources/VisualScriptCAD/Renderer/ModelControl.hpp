@@ -52,6 +52,7 @@ public:
 private:
 	bool							InitContext ();
 	void							SelectNodeOfMesh (const wxPoint& mousePosition);
+	void							SelectNodesOfMeshes (const wxPoint& rectCorner1, const wxPoint& rectCorner2);
 
 	const Modeler::Model&			model;
 	SelectionUpdater&				selectionUpdater;
@@ -65,6 +66,7 @@ private:
 	wxPoint							lastMousePosition;
 	int								lastMouseButton;
 	bool							isMouseDown;
+	bool							isSelecting;
 
 	wxDECLARE_EVENT_TABLE ();
 };
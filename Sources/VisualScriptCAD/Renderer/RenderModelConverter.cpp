@@ -61,16 +61,17 @@ void RenderModelConverter::ConvertMeshRefToRenderMesh (const Modeler::Model& mod
 {
 	const Modeler::MeshGeometry& geometry = model.GetMeshGeometry (meshRef);
 	const Modeler::MeshMaterials& materials = model.GetMeshMaterials (meshRef);
+	const std::vector<Modeler::MeshTriangle>& meshTriangles = geometry.GetTriangles ();
 
 	std::unordered_map<Modeler::MaterialId, size_t> materialToRenderGeometry;
-	EnumerateTrianglesByMaterial (geometry, materials, [&] (Modeler::MaterialId materialId, const std::vector<unsigned int>& triangles) {
+	materials.EnumerateTrianglesByMaterial ([&] (Modeler::MaterialId materialId, unsigned int firstTriangle, unsigned int triangleCount) {
 		if (materialToRenderGeometry.find (materialId) == materialToRenderGeometry.end ()) {
 			renderMesh.AddRenderGeometry (RenderGeometry (MaterialToRenderMaterial (materials.GetMaterial (materialId))));
 			materialToRenderGeometry.insert ({ materialId, renderMesh.RenderGeometryCount () - 1 });
 		}
 		RenderGeometry& renderGeometry = renderMesh.GetRenderGeometry (materialToRenderGeometry[materialId]);
-		for (unsigned int triangleId : triangles) {
-			const Modeler::MeshTriangle& triangle = geometry.GetTriangle (triangleId);
+		for (unsigned int triangleId = firstTriangle; triangleId < firstTriangle + triangleCount; triangleId++) {
+			const Modeler::MeshTriangle& triangle = meshTriangles[triangleId];
 			glm::vec3 v1 = geometry.GetVertex (triangle.v1);
 			glm::vec3 v2 = geometry.GetVertex (triangle.v2);
 			glm::vec3 v3 = geometry.GetVertex (triangle.v3);
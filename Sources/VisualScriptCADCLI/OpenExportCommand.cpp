@@ -90,7 +90,7 @@ bool OpenExportCommand::Do (const std::vector<std::wstring>& parameters) const
 	NUIE::NodeEditor nodeEditor (env);
 
 	FileIO fileIO;
-	ApplicationHeaderIO headerIO;
+	ApplicationHeaderIO headerIO (evalData);
 
 	if (!nodeEditor.Open (vscFileName, &fileIO, &headerIO)) {
 		return false;
@@ -2,7 +2,12 @@
 #include "Version.hpp"
 #include "VersionInfo.hpp"
 
-ApplicationHeaderIO::ApplicationHeaderIO ()
+// files from version 4 are still supported, they don't contain the tessellation tolerance
+static const int MinFileVersion = 4;
+static const int TessellationToleranceFileVersion = 5;
+
+ApplicationHeaderIO::ApplicationHeaderIO (const std::shared_ptr<ModelEvaluationData>& evalData) :
+	evalData (evalData)
 {
 
 }
@@ -21,17 +26,30 @@ bool ApplicationHeaderIO::Read (NE::InputStream& inputStream) const
 	}
 	int readFileVersion = 0;
 	inputStream.Read (readFileVersion);
-	if (readFileVersion != FileVersion) {
+	if (readFileVersion < MinFileVersion || readFileVersion > FileVersion) {
 		return false;
 	}
+	Modeler::TessellationTolerance tolerance;
+	if (readFileVersion >= TessellationToleranceFileVersion) {
+		double chordalDeviation = 0.0;
+		double maxSegmentAngle = 0.0;
+		inputStream.Read (chordalDeviation);
+		inputStream.Read (maxSegmentAngle);
+		tolerance = Modeler::TessellationTolerance (chordalDeviation, maxSegmentAngle);
+		if (inputStream.GetStatus () != NE::Stream::Status::NoError || !tolerance.Check ()) {
+			return false;
+		}
+	}
+	evalData->SetTessellationTolerance (tolerance);
 	return true;
 }
 
 void ApplicationHeaderIO::Write (NE::OutputStream& outputStream) const
 {
+	const Modeler::TessellationTolerance& tolerance = evalData->GetTessellationTolerance ();
 	outputStream.Write (std::wstring (VSCAD_APP_NAME));
 	AppVersion.Write (outputStream);
 	outputStream.Write (FileVersion);
+	outputStream.Write (tolerance.GetChordalDeviation ());
+	outputStream.Write (tolerance.GetMaxSegmentAngle ());
 }
-
-const ApplicationHeaderIO appHeaderIO;
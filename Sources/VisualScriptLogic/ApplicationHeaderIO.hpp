@@ -2,15 +2,17 @@
 #define APPLICATIONHEADERIO_HPP
 
 #include "NUIE_NodeEditor.hpp"
+#include "ModelEvaluationData.hpp"
 
 class ApplicationHeaderIO : public NUIE::ExternalHeaderIO
 {
 public:
-	ApplicationHeaderIO ();
+	ApplicationHeaderIO (const std::shared_ptr<ModelEvaluationData>& evalData);
 	virtual bool Read (NE::InputStream& inputStream) const override;
 	virtual void Write (NE::OutputStream& outputStream) const override;
-};
 
-extern const ApplicationHeaderIO appHeaderIO;
+private:
+	std::shared_ptr<ModelEvaluationData> evalData;
+};
 
 #endif
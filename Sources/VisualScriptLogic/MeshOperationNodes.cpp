@@ -0,0 +1,76 @@
+#include "MeshOperationNodes.hpp"
+#include "NE_SingleValues.hpp"
+#include "BI_BuiltInFeatures.hpp"
+#include "NUIE_NodeCommonParameters.hpp"
+#include "BasicShapes.hpp"
+#include "MeshSimplification.hpp"
+#include "Geometry.hpp"
+
+NE::DynamicSerializationInfo	SimplifyShapeNode::serializationInfo (NE::ObjectId ("{6E1D8C3A-4B27-4F0E-9A5D-2C71B3E8F640}"), NE::ObjectVersion (1), SimplifyShapeNode::CreateSerializableInstance);
+
+SimplifyShapeNode::SimplifyShapeNode () :
+	SimplifyShapeNode (NE::String (), NUIE::Point ())
+{
+
+}
+
+SimplifyShapeNode::SimplifyShapeNode (const NE::String& name, const NUIE::Point& position) :
+	ShapeNode (name, position)
+{
+
+}
+
+void SimplifyShapeNode::Initialize ()
+{
+	ShapeNode::Initialize ();
+	RegisterFeature (BI::NodeFeaturePtr (new BI::ValueCombinationFeature ()));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("shape"), NE::String (L"Shape"), nullptr, NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("ratio"), NE::String (L"Ratio"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
+}
+
+void SimplifyShapeNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
+{
+	ShapeNode::RegisterParameters (parameterList);
+	NUIE::RegisterSlotDefaultValueNodeParameter<SimplifyShapeNode, NE::FloatValue> (parameterList, NE::SlotId ("ratio"), L"Ratio", NUIE::ParameterType::Float);
+}
+
+NE::ValueConstPtr SimplifyShapeNode::Calculate (NE::EvaluationEnv& env) const
+{
+	NE::ValueConstPtr shapeValue = EvaluateInputSlot (NE::SlotId ("shape"), env);
+	NE::ValueConstPtr ratioValue = EvaluateInputSlot (NE::SlotId ("ratio"), env);
+	if (!NE::IsComplexType<ShapeValue> (shapeValue) || !NE::IsComplexType<NE::NumberValue> (ratioValue)) {
+		return nullptr;
+	}
+
+	NE::ListValuePtr result (new NE::ListValue ());
+	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {shapeValue, ratioValue}, [&] (const NE::ValueCombination& combination) {
+		Modeler::ShapePtr shape (ShapeValue::Get (combination.GetValue (0)));
+		double ratio = NE::NumberValue::ToDouble (combination.GetValue (1));
+		if (!shape->Check () || !Geometry::IsGreater (ratio, 0.0) || Geometry::IsGreater (ratio, 1.0)) {
+			return false;
+		}
+		Modeler::Mesh simplified = Modeler::SimplifyMesh (shape->GenerateMesh (), ratio);
+		result->Push (NE::ValuePtr (new ShapeValue (Modeler::ShapePtr (new Modeler::MeshShape (glm::dmat4 (1.0), std::move (simplified))))));
+		return true;
+	});
+
+	if (!isValid) {
+		return nullptr;
+	}
+	return result;
+}
+
+NE::Stream::Status SimplifyShapeNode::Read (NE::InputStream& inputStream)
+{
+	NE::ObjectHeader header (inputStream);
+	ShapeNode::Read (inputStream);
+	return inputStream.GetStatus ();
+}
+
+NE::Stream::Status SimplifyShapeNode::Write (NE::OutputStream& outputStream) const
+{
+	NE::ObjectHeader header (outputStream, serializationInfo);
+	ShapeNode::Write (outputStream);
+	return outputStream.GetStatus ();
+}
@@ -0,0 +1,22 @@
+#ifndef MESHOPERATIONNODES_HPP
+#define MESHOPERATIONNODES_HPP
+
+#include "ShapeNode.hpp"
+
+class SimplifyShapeNode : public ShapeNode
+{
+	DYNAMIC_SERIALIZABLE (SimplifyShapeNode);
+
+public:
+	SimplifyShapeNode ();
+	SimplifyShapeNode (const NE::String& name, const NUIE::Point& position);
+
+	virtual void				Initialize () override;
+	virtual void				RegisterParameters (NUIE::NodeParameterList& parameterList) const;
+	virtual NE::ValueConstPtr	Calculate (NE::EvaluationEnv& env) const override;
+
+	virtual NE::Stream::Status	Read (NE::InputStream& inputStream) override;
+	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
+};
+
+#endif
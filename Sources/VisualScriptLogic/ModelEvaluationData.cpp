@@ -12,6 +12,7 @@ const NE::NodeId& NodeIdUserData::GetNodeId () const
 
 ModelEvaluationData::ModelEvaluationData () :
 	model (),
+	tessellationTolerance (),
 	addedMeshes (),
 	deletedMeshes ()
 {
@@ -29,8 +30,14 @@ const Modeler::Model& ModelEvaluationData::GetModel () const
 Modeler::MeshId ModelEvaluationData::AddMesh (const Modeler::Mesh& mesh, const NE::NodeId& nodeId)
 {
 	Modeler::MeshId meshId = model.AddMesh (mesh);
-	model.SetMeshUserData (meshId, "nodeid", Modeler::UserDataConstPtr (new NodeIdUserData (nodeId)));
-	addedMeshes.insert (meshId);
+	RegisterAddedMesh (meshId, nodeId);
+	return meshId;
+}
+
+Modeler::MeshId ModelEvaluationData::AddMesh (Modeler::Mesh&& mesh, const NE::NodeId& nodeId)
+{
+	Modeler::MeshId meshId = model.AddMesh (std::move (mesh));
+	RegisterAddedMesh (meshId, nodeId);
 	return meshId;
 }
 
@@ -40,6 +47,31 @@ void ModelEvaluationData::RemoveMesh (Modeler::MeshId meshId)
 	deletedMeshes.insert (meshId);
 }
 
+NE::NodeCollection ModelEvaluationData::GetMeshNodes () const
+{
+	NE::NodeCollection meshNodes;
+	model.EnumerateMeshes ([&] (Modeler::MeshId, const Modeler::MeshRef& meshRef) {
+		std::shared_ptr<const NodeIdUserData> nodeIdUserData = std::dynamic_pointer_cast<const NodeIdUserData> (meshRef.GetUserData ("nodeid"));
+		if (nodeIdUserData != nullptr && !meshNodes.Contains (nodeIdUserData->GetNodeId ())) {
+			meshNodes.Insert (nodeIdUserData->GetNodeId ());
+		}
+	});
+	return meshNodes;
+}
+
+const Modeler::TessellationTolerance& ModelEvaluationData::GetTessellationTolerance () const
+{
+	return tessellationTolerance;
+}
+
+void ModelEvaluationData::SetTessellationTolerance (const Modeler::TessellationTolerance& newTolerance)
+{
+	if (!newTolerance.Check ()) {
+		throw std::logic_error ("invalid tessellation tolerance");
+	}
+	tessellationTolerance = newTolerance;
+}
+
 const std::unordered_set<Modeler::MeshId>& ModelEvaluationData::GetAddedMeshes () const
 {
 	return addedMeshes;
@@ -61,3 +93,9 @@ void ModelEvaluationData::Clear ()
 	model.Clear ();
 	ClearAddedDeletedMeshes ();
 }
+
+void ModelEvaluationData::RegisterAddedMesh (Modeler::MeshId meshId, const NE::NodeId& nodeId)
+{
+	model.SetMeshUserData (meshId, "nodeid", Modeler::UserDataConstPtr (new NodeIdUserData (nodeId)));
+	addedMeshes.insert (meshId);
+}
@@ -2,8 +2,10 @@
 #define MODELEVALUATIONDATA_HPP
 
 #include "NE_NodeId.hpp"
+#include "NE_NodeCollection.hpp"
 #include "NE_EvaluationEnv.hpp"
 #include "Model.hpp"
+#include "MeshGenerators.hpp"
 
 class NodeIdUserData : public Modeler::UserData
 {
@@ -24,7 +26,12 @@ public:
 
 	const Modeler::Model&						GetModel () const;
 	Modeler::MeshId								AddMesh (const Modeler::Mesh& mesh, const NE::NodeId& nodeId);
+	Modeler::MeshId								AddMesh (Modeler::Mesh&& mesh, const NE::NodeId& nodeId);
 	void										RemoveMesh (Modeler::MeshId meshId);
+	NE::NodeCollection							GetMeshNodes () const;
+
+	const Modeler::TessellationTolerance&		GetTessellationTolerance () const;
+	void										SetTessellationTolerance (const Modeler::TessellationTolerance& newTolerance);
 
 	const std::unordered_set<Modeler::MeshId>&	GetAddedMeshes () const;
 	const std::unordered_set<Modeler::MeshId>&	GetDeletedMeshes () const;
@@ -33,7 +40,10 @@ public:
 	void										Clear ();
 
 private:
+	void										RegisterAddedMesh (Modeler::MeshId meshId, const NE::NodeId& nodeId);
+
 	Modeler::Model							model;
+	Modeler::TessellationTolerance			tessellationTolerance;
 	std::unordered_set<Modeler::MeshId>		addedMeshes;
 	std::unordered_set<Modeler::MeshId>		deletedMeshes;
 };
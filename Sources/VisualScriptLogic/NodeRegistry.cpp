@@ -10,6 +10,7 @@
 #include "Basic3DTransformationNodes.hpp"
 #include "TransformationNodes.hpp"
 #include "BooleanNodes.hpp"
+#include "MeshOperationNodes.hpp"
 #include "ExpressionNode.hpp"
 #include "PrismNode.hpp"
 
@@ -142,6 +143,9 @@ const NUIE::NodeRegistry& GetNodeRegistry ()
 		nodeRegistry.RegisterNode (L"Boolean Nodes", L"Union",
 			[] (const NUIE::Point& position) { return NUIE::UINodePtr (new UnionNode (NE::String (L"Union"), position)); }
 		);
+		nodeRegistry.RegisterNode (L"Mesh Nodes", L"Simplify Shape",
+			[] (const NUIE::Point& position) { return NUIE::UINodePtr (new SimplifyShapeNode (NE::String (L"Simplify Shape"), position)); }
+		);
 		nodeRegistry.RegisterNode (L"Other Nodes", L"Viewer",
 			[] (const NUIE::Point& position) { return NUIE::UINodePtr (new BI::MultiLineViewerNode (NE::String (L"Viewer"), position, 5)); }
 		);
@@ -8,6 +8,7 @@
 #include "MaterialNode.hpp"
 
 #include "IncludeGLM.hpp"
+#include "Transformation.hpp"
 #include "BasicShapes.hpp"
 
 NE::DynamicSerializationInfo	BoxNode::serializationInfo (NE::ObjectId ("{9C29EF6D-AD3B-466C-8574-95B82D4EC0D4}"), NE::ObjectVersion (1), BoxNode::CreateSerializableInstance);
@@ -15,14 +16,37 @@ NE::DynamicSerializationInfo	BoxShellNode::serializationInfo (NE::ObjectId ("{CC
 NE::DynamicSerializationInfo	CylinderNode::serializationInfo (NE::ObjectId ("{6C457800-788A-4747-A2D1-54158EFB2794}"), NE::ObjectVersion (1), CylinderNode::CreateSerializableInstance);
 NE::DynamicSerializationInfo	CylinderShellNode::serializationInfo (NE::ObjectId ("{73164BBB-3971-46FB-9D17-E6BCA5814420}"), NE::ObjectVersion (1), CylinderShellNode::CreateSerializableInstance);
 NE::DynamicSerializationInfo	ConeNode::serializationInfo (NE::ObjectId ("{586F0D6E-CBEB-4C19-8B9E-7358E3E75FD2}"), NE::ObjectVersion (1), ConeNode::CreateSerializableInstance);
-NE::DynamicSerializationInfo	SphereNode::serializationInfo (NE::ObjectId ("{686712CE-BF1B-438E-8C0A-B687A158A0BB}"), NE::ObjectVersion (1), SphereNode::CreateSerializableInstance);
+NE::DynamicSerializationInfo	SphereNode::serializationInfo (NE::ObjectId ("{686712CE-BF1B-438E-8C0A-B687A158A0BB}"), NE::ObjectVersion (2), SphereNode::CreateSerializableInstance);
 NE::DynamicSerializationInfo	TorusNode::serializationInfo (NE::ObjectId ("{E17CF103-A4B6-4498-BB7E-7A566C1F7D26}"), NE::ObjectVersion (1), TorusNode::CreateSerializableInstance);
 NE::DynamicSerializationInfo	PlatonicNode::serializationInfo (NE::ObjectId ("{F7321055-D370-4468-A895-32FA3AD1BF40}"), NE::ObjectVersion (1), PlatonicNode::CreateSerializableInstance);
 
+// zero segmentation means that the segment count is calculated from
+// the size of the shape and the tessellation tolerance of the model
+static const int AutomaticSegmentation = 0;
+
+static bool IsAutomaticSegmentation (int segmentation)
+{
+	return segmentation == AutomaticSegmentation;
+}
+
 static bool IsSmooth (int segmentation)
 {
 	static const int minSmoothSegmentation = 10;
-	return segmentation >= minSmoothSegmentation;
+	return IsAutomaticSegmentation (segmentation) || segmentation >= minSmoothSegmentation;
+}
+
+static Modeler::TessellationTolerance GetTessellationTolerance (NE::EvaluationEnv& env)
+{
+	if (!env.IsDataType<ModelEvaluationData> ()) {
+		return Modeler::TessellationTolerance ();
+	}
+	return env.GetData<ModelEvaluationData> ()->GetTessellationTolerance ();
+}
+
+// the tolerance is given in model space, so the size of the shape is measured after the transformation
+static double GetTransformedRadius (double radius, const NE::ValueConstPtr& transformationValue)
+{
+	return radius * Geometry::GetMaxAxisScale (TransformationValue::Get (transformationValue));
 }
 
 BoxNode::BoxNode () :
@@ -209,7 +233,7 @@ void CylinderNode::Initialize ()
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("transformation"), NE::String (L"Transformation"), NE::ValuePtr (new TransformationValue (glm::dmat4 (1.0))), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("radius"), NE::String (L"Radius"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("height"), NE::String (L"Height"), NE::ValuePtr (new NE::FloatValue (1.0f)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
 }
 
@@ -225,16 +249,22 @@ NE::ValueConstPtr CylinderNode::Calculate (NE::EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	Modeler::TessellationTolerance tolerance = GetTessellationTolerance (env);
 	NE::ListValuePtr result (new NE::ListValue ());
 	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {material, transformation, radiusValue, heightValue, segmentationValue}, [&] (const NE::ValueCombination& combination) {
+		double radius = NE::NumberValue::ToDouble (combination.GetValue (2));
 		int segmentation = NE::NumberValue::ToInteger (combination.GetValue (4));
+		bool isSmooth = IsSmooth (segmentation);
+		if (IsAutomaticSegmentation (segmentation)) {
+			segmentation = Modeler::CalculateCircleSegmentation (GetTransformedRadius (radius, combination.GetValue (1)), tolerance);
+		}
 		Modeler::ShapePtr shape (new Modeler::CylinderShape (
 			MaterialValue::Get (combination.GetValue (0)),
 			TransformationValue::Get (combination.GetValue (1)),
-			NE::NumberValue::ToDouble (combination.GetValue (2)),
+			radius,
 			NE::NumberValue::ToDouble (combination.GetValue (3)),
 			segmentation,
-			IsSmooth (segmentation)
+			isSmooth
 		));
 		if (!shape->Check ()) {
 			return false;
@@ -292,7 +322,7 @@ void CylinderShellNode::Initialize ()
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("radius"), NE::String (L"Radius"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("height"), NE::String (L"Height"), NE::ValuePtr (new NE::FloatValue (1.0f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("thickness"), NE::String (L"Thickness"), NE::ValuePtr (new NE::FloatValue (0.1f)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
 }
 
@@ -309,16 +339,22 @@ NE::ValueConstPtr CylinderShellNode::Calculate (NE::EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	Modeler::TessellationTolerance tolerance = GetTessellationTolerance (env);
 	NE::ListValuePtr result (new NE::ListValue ());
 	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {material, transformation, radiusValue, heightValue, thicknessValue, segmentationValue}, [&] (const NE::ValueCombination& combination) {
+		double radius = NE::NumberValue::ToDouble (combination.GetValue (2));
 		int segmentation = NE::NumberValue::ToInteger (combination.GetValue (5));
+		bool isSmooth = IsSmooth (segmentation);
+		if (IsAutomaticSegmentation (segmentation)) {
+			segmentation = Modeler::CalculateCircleSegmentation (GetTransformedRadius (radius, combination.GetValue (1)), tolerance);
+		}
 		Modeler::ShapePtr shape (new Modeler::CylinderShellShape (
 			MaterialValue::Get (combination.GetValue (0)),
 			TransformationValue::Get (combination.GetValue (1)),
-			NE::NumberValue::ToDouble (combination.GetValue (2)),
+			radius,
 			NE::NumberValue::ToDouble (combination.GetValue (3)),
 			segmentation,
-			IsSmooth (segmentation),
+			isSmooth,
 			NE::NumberValue::ToDouble (combination.GetValue (4))
 		));
 		if (!shape->Check ()) {
@@ -378,7 +414,7 @@ void ConeNode::Initialize ()
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("topradius"), NE::String (L"Top Radius"), NE::ValuePtr (new NE::FloatValue (0.3f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("bottomradius"), NE::String (L"Bottom Radius"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("height"), NE::String (L"Height"), NE::ValuePtr (new NE::FloatValue (1.0f)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
 }
 
@@ -395,17 +431,24 @@ NE::ValueConstPtr ConeNode::Calculate (NE::EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	Modeler::TessellationTolerance tolerance = GetTessellationTolerance (env);
 	NE::ListValuePtr result (new NE::ListValue ());
 	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {material, transformation, topRadiusValue, bottomRadiusValue, heightValue, segmentationValue}, [&] (const NE::ValueCombination& combination) {
+		double topRadius = NE::NumberValue::ToDouble (combination.GetValue (2));
+		double bottomRadius = NE::NumberValue::ToDouble (combination.GetValue (3));
 		int segmentation = NE::NumberValue::ToInteger (combination.GetValue (5));
+		bool isSmooth = IsSmooth (segmentation);
+		if (IsAutomaticSegmentation (segmentation)) {
+			segmentation = Modeler::CalculateCircleSegmentation (GetTransformedRadius (std::max (topRadius, bottomRadius), combination.GetValue (1)), tolerance);
+		}
 		Modeler::ShapePtr shape (new Modeler::ConeShape (
 			MaterialValue::Get (combination.GetValue (0)),
 			TransformationValue::Get (combination.GetValue (1)),
-			NE::NumberValue::ToDouble (combination.GetValue (2)),
-			NE::NumberValue::ToDouble (combination.GetValue (3)),
+			topRadius,
+			bottomRadius,
 			NE::NumberValue::ToDouble (combination.GetValue (4)),
 			segmentation,
-			IsSmooth (segmentation)
+			isSmooth
 		));
 		if (!shape->Check ()) {
 			return false;
@@ -443,6 +486,12 @@ NE::Stream::Status ConeNode::Write (NE::OutputStream& outputStream) const
 	return outputStream.GetStatus ();
 }
 
+static void SetSphereNodeType (Modeler::SphereType type, NUIE::UINodeInvalidator& invalidator, std::shared_ptr<SphereNode>& sphereNode)
+{
+	sphereNode->SetType (type);
+	invalidator.InvalidateValueAndDrawing ();
+}
+
 SphereNode::SphereNode () :
 	SphereNode (NE::String (), NUIE::Point ())
 {
@@ -450,7 +499,8 @@ SphereNode::SphereNode () :
 }
 
 SphereNode::SphereNode (const NE::String& name, const NUIE::Point& position) :
-	ShapeNode (name, position)
+	ShapeNode (name, position),
+	type (Modeler::SphereType::UVSphere)
 {
 
 }
@@ -462,7 +512,7 @@ void SphereNode::Initialize ()
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("material"), NE::String (L"Material"), NE::ValuePtr (new MaterialValue (Modeler::DefaultMaterial)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("transformation"), NE::String (L"Transformation"), NE::ValuePtr (new TransformationValue (glm::dmat4 (1.0))), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("radius"), NE::String (L"Radius"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("segmentation"), NE::String (L"Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
 }
 
@@ -477,16 +527,37 @@ NE::ValueConstPtr SphereNode::Calculate (NE::EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	Modeler::TessellationTolerance tolerance = GetTessellationTolerance (env);
 	NE::ListValuePtr result (new NE::ListValue ());
 	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {material, transformation, radiusValue, segmentationValue}, [&] (const NE::ValueCombination& combination) {
+		double radius = NE::NumberValue::ToDouble (combination.GetValue (2));
 		int segmentation = NE::NumberValue::ToInteger (combination.GetValue (3));
-		Modeler::ShapePtr shape (new Modeler::SphereShape (
-			MaterialValue::Get (combination.GetValue (0)),
-			TransformationValue::Get (combination.GetValue (1)),
-			NE::NumberValue::ToDouble (combination.GetValue (2)),
-			segmentation,
-			IsSmooth (segmentation)
-		));
+		Modeler::ShapePtr shape;
+		if (type == Modeler::SphereType::Icosphere) {
+			// for icospheres the segmentation is the number of divisions of the icosahedron edges
+			if (IsAutomaticSegmentation (segmentation)) {
+				segmentation = Modeler::CalculateIcosphereFrequency (GetTransformedRadius (radius, combination.GetValue (1)), tolerance);
+			}
+			shape.reset (new Modeler::IcosphereShape (
+				MaterialValue::Get (combination.GetValue (0)),
+				TransformationValue::Get (combination.GetValue (1)),
+				radius,
+				segmentation,
+				true
+			));
+		} else {
+			bool isSmooth = IsSmooth (segmentation);
+			if (IsAutomaticSegmentation (segmentation)) {
+				segmentation = Modeler::CalculateSphereSegmentation (GetTransformedRadius (radius, combination.GetValue (1)), tolerance);
+			}
+			shape.reset (new Modeler::SphereShape (
+				MaterialValue::Get (combination.GetValue (0)),
+				TransformationValue::Get (combination.GetValue (1)),
+				radius,
+				segmentation,
+				isSmooth
+			));
+		}
 		if (!shape->Check ()) {
 			return false;
 		}
@@ -500,17 +571,85 @@ NE::ValueConstPtr SphereNode::Calculate (NE::EvaluationEnv& env) const
 	return result;
 }
 
+void SphereNode::RegisterCommands (NUIE::NodeCommandRegistrator& commandRegistrator) const
+{
+	class SetTypeCommand : public NUIE::NodeCommand
+	{
+	public:
+		SetTypeCommand (const std::wstring& name, bool isChecked, Modeler::SphereType type) :
+			NUIE::NodeCommand (name, isChecked),
+			type (type)
+		{
+
+		}
+
+		virtual bool IsApplicableTo (const NUIE::UINodeConstPtr& uiNode) override
+		{
+			return NE::Node::IsTypeConst<SphereNode> (uiNode);
+		}
+
+		virtual void Do (NUIE::UINodeInvalidator& invalidator, NUIE::NodeUIEnvironment&, NUIE::UINodePtr& uiNode) override
+		{
+			std::shared_ptr<SphereNode> sphereNode = std::dynamic_pointer_cast<SphereNode> (uiNode);
+			SetSphereNodeType (type, invalidator, sphereNode);
+		}
+
+	private:
+		Modeler::SphereType type;
+	};
+
+	ShapeNode::RegisterCommands (commandRegistrator);
+	NUIE::NodeGroupCommandPtr setShapeTypeGroup (new NUIE::NodeGroupCommand<NUIE::NodeCommandPtr> (L"Set Type"));
+	setShapeTypeGroup->AddChildCommand (NUIE::NodeCommandPtr (new SetTypeCommand (L"UV Sphere", type == Modeler::SphereType::UVSphere, Modeler::SphereType::UVSphere)));
+	setShapeTypeGroup->AddChildCommand (NUIE::NodeCommandPtr (new SetTypeCommand (L"Icosphere", type == Modeler::SphereType::Icosphere, Modeler::SphereType::Icosphere)));
+	commandRegistrator.RegisterNodeGroupCommand (setShapeTypeGroup);
+}
+
 void SphereNode::RegisterParameters (NUIE::NodeParameterList& parameterList) const
 {
+	class ShapeTypeParameter : public NUIE::EnumerationNodeParameter<SphereNode>
+	{
+	public:
+		ShapeTypeParameter () :
+			NUIE::EnumerationNodeParameter<SphereNode> (L"Type", { L"UV Sphere", L"Icosphere" })
+		{
+
+		}
+
+		virtual NE::ValueConstPtr GetValueInternal (const NUIE::UINodeConstPtr& uiNode) const override
+		{
+			std::shared_ptr<const SphereNode> sphereNode = std::dynamic_pointer_cast<const SphereNode> (uiNode);
+			int typeInt = (int) sphereNode->GetType ();
+			return NE::ValuePtr (new NE::IntValue (typeInt));
+		}
+
+		virtual bool SetValueInternal (NUIE::UINodeInvalidator& invalidator, NE::EvaluationEnv&, NUIE::UINodePtr& uiNode, const NE::ValueConstPtr& value) override
+		{
+			std::shared_ptr<SphereNode> sphereNode = std::dynamic_pointer_cast<SphereNode> (uiNode);
+			int typeInt = NE::IntValue::Get (value);
+			Modeler::SphereType type = (Modeler::SphereType) typeInt;
+			SetSphereNodeType (type, invalidator, sphereNode);
+			return true;
+		}
+	};
+
 	ShapeNode::RegisterParameters (parameterList);
 	NUIE::RegisterSlotDefaultValueNodeParameter<SphereNode, NE::FloatValue> (parameterList, NE::SlotId ("radius"), L"Radius", NUIE::ParameterType::Float);
 	NUIE::RegisterSlotDefaultValueNodeParameter<SphereNode, NE::IntValue> (parameterList, NE::SlotId ("segmentation"), L"Segmentation", NUIE::ParameterType::Integer);
+	parameterList.AddParameter (NUIE::NodeParameterPtr (new ShapeTypeParameter ()));
 }
 
 NE::Stream::Status SphereNode::Read (NE::InputStream& inputStream)
 {
 	NE::ObjectHeader header (inputStream);
 	ShapeNode::Read (inputStream);
+	if (header.GetVersion () == NE::ObjectVersion (1)) {
+		type = Modeler::SphereType::UVSphere;
+	} else {
+		int typeInt = 0;
+		inputStream.Read (typeInt);
+		type = (Modeler::SphereType) typeInt;
+	}
 	return inputStream.GetStatus ();
 }
 
@@ -518,9 +657,20 @@ NE::Stream::Status SphereNode::Write (NE::OutputStream& outputStream) const
 {
 	NE::ObjectHeader header (outputStream, serializationInfo);
 	ShapeNode::Write (outputStream);
+	outputStream.Write ((int) type);
 	return outputStream.GetStatus ();
 }
 
+Modeler::SphereType SphereNode::GetType () const
+{
+	return type;
+}
+
+void SphereNode::SetType (Modeler::SphereType newType)
+{
+	type = newType;
+}
+
 TorusNode::TorusNode () :
 	TorusNode (NE::String (), NUIE::Point ())
 {
@@ -541,8 +691,8 @@ void TorusNode::Initialize ()
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("transformation"), NE::String (L"Transformation"), NE::ValuePtr (new TransformationValue (glm::dmat4 (1.0))), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("outerradius"), NE::String (L"Outer Radius"), NE::ValuePtr (new NE::FloatValue (0.5f)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("innerradius"), NE::String (L"Inner Radius"), NE::ValuePtr (new NE::FloatValue (0.3f)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("outersegmentation"), NE::String (L"Outer Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
-	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("innersegmentation"), NE::String (L"Inner Segmentation"), NE::ValuePtr (new NE::IntValue (25)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("outersegmentation"), NE::String (L"Outer Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
+	RegisterUIInputSlot (NUIE::UIInputSlotPtr (new NUIE::UIInputSlot (NE::SlotId ("innersegmentation"), NE::String (L"Inner Segmentation"), NE::ValuePtr (new NE::IntValue (AutomaticSegmentation)), NE::OutputSlotConnectionMode::Single)));
 	RegisterUIOutputSlot (NUIE::UIOutputSlotPtr (new NUIE::UIOutputSlot (NE::SlotId ("shape"), NE::String (L"Shape"))));
 }
 
@@ -559,18 +709,28 @@ NE::ValueConstPtr TorusNode::Calculate (NE::EvaluationEnv& env) const
 		return nullptr;
 	}
 
+	Modeler::TessellationTolerance tolerance = GetTessellationTolerance (env);
 	NE::ListValuePtr result (new NE::ListValue ());
 	bool isValid = BI::ValueCombinationFeature::CombineValues (this, {material, transformation, outerRadiusValue, innerRadiusValue, outerSegmentationValue, innerSegmentationValue}, [&] (const NE::ValueCombination& combination) {
+		double outerRadius = NE::NumberValue::ToDouble (combination.GetValue (2));
+		double innerRadius = NE::NumberValue::ToDouble (combination.GetValue (3));
 		int outerSegmentation = NE::NumberValue::ToInteger (combination.GetValue (4));
 		int innerSegmentation = NE::NumberValue::ToInteger (combination.GetValue (5));
+		bool isSmooth = IsSmooth (outerSegmentation) && IsSmooth (innerSegmentation);
+		if (IsAutomaticSegmentation (outerSegmentation)) {
+			outerSegmentation = Modeler::CalculateCircleSegmentation (GetTransformedRadius (outerRadius + innerRadius, combination.GetValue (1)), tolerance);
+		}
+		if (IsAutomaticSegmentation (innerSegmentation)) {
+			innerSegmentation = Modeler::CalculateCircleSegmentation (GetTransformedRadius (innerRadius, combination.GetValue (1)), tolerance);
+		}
 		Modeler::ShapePtr shape (new Modeler::TorusShape (
 			MaterialValue::Get (combination.GetValue (0)),
 			TransformationValue::Get (combination.GetValue (1)),
-			NE::NumberValue::ToDouble (combination.GetValue (2)),
-			NE::NumberValue::ToDouble (combination.GetValue (3)),
+			outerRadius,
+			innerRadius,
 			outerSegmentation,
 			innerSegmentation,
-			IsSmooth (outerSegmentation) && IsSmooth (innerSegmentation)
+			isSmooth
 		));
 		if (!shape->Check ()) {
 			return false;
@@ -96,10 +96,17 @@ public:
 
 	virtual void				Initialize () override;
 	virtual NE::ValueConstPtr	Calculate (NE::EvaluationEnv& env) const override;
+	virtual void				RegisterCommands (NUIE::NodeCommandRegistrator& commandRegistrator) const;
 	virtual void				RegisterParameters (NUIE::NodeParameterList& parameterList) const;
 
 	virtual NE::Stream::Status	Read (NE::InputStream& inputStream) override;
 	virtual NE::Stream::Status	Write (NE::OutputStream& outputStream) const override;
+
+	Modeler::SphereType			GetType () const;
+	void						SetType (Modeler::SphereType newType);
+
+private:
+	Modeler::SphereType			type;
 };
 
 class TorusNode : public ShapeNode
@@ -2,4 +2,4 @@
 #include "VersionInfo.hpp"
 
 const NUIE::Version AppVersion (VSCAD_VERSION_1, VSCAD_VERSION_2, VSCAD_VERSION_3);
-const int FileVersion = 4;
+const int FileVersion = 5;